@@ -44,11 +44,15 @@ LOCAL_SRC_FILES := \
 	gme/Ay_Apu.cpp \
 	gme/Ay_Cpu.cpp \
 	gme/Ay_Emu.cpp \
+	gme/Batch_Renderer.cpp \
+	gme/blargg_common.cpp \
+	gme/blargg_simd.cpp \
 	gme/Blip_Buffer.cpp \
 	gme/Classic_Emu.cpp \
 	gme/Data_Reader.cpp \
 	gme/Dual_Resampler.cpp \
 	gme/Effects_Buffer.cpp \
+	gme/Emu_State.cpp \
 	gme/Fir_Resampler.cpp \
 	gme/Gb_Apu.cpp \
 	gme/Gb_Cpu.cpp \
@@ -0,0 +1,219 @@
+/* Checks entry points that the demos don't exercise, for ctest. Usage:
+
+	api_check state|state_other|borrowed|float file
+
+state:       saving state, playing on, then loading it replays identical samples
+state_other: state is rejected by another emulator and after reloading the file
+borrowed:    gme_open_data_borrowed() and gme_load_data_borrowed() play the same
+             as gme_open_data()
+float:       gme_play_float() matches gme_play() to within rounding, for files
+             that gme_play() doesn't clip
+
+Prints the reason and exits with failure if a check fails. */
+
+#include "gme/gme.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+enum { sample_rate = 44100 };
+enum { play_size = sample_rate * 2 * 3 }; /* 3 seconds of stereo samples */
+
+static short out1 [play_size];
+static short out2 [play_size];
+
+static void handle_error( const char* str )
+{
+	if ( str )
+	{
+		fprintf( stderr, "Error: %s\n", str );
+		exit( EXIT_FAILURE );
+	}
+}
+
+static void fail( const char* check, const char* path, const char* why )
+{
+	fprintf( stderr, "%s %s: %s\n", check, path, why );
+	exit( EXIT_FAILURE );
+}
+
+static void* read_file( const char* path, long* size )
+{
+	void* data;
+	FILE* in = fopen( path, "rb" );
+	if ( !in )
+		handle_error( "Couldn't open file" );
+	fseek( in, 0, SEEK_END );
+	*size = ftell( in );
+	fseek( in, 0, SEEK_SET );
+	data = malloc( *size );
+	if ( !data )
+		handle_error( "Out of memory" );
+	if ( fread( data, 1, *size, in ) != (size_t) *size )
+		handle_error( "Couldn't read file" );
+	fclose( in );
+	return data;
+}
+
+static Music_Emu* open_track( const char* path )
+{
+	Music_Emu* emu;
+	handle_error( gme_open_file( path, &emu, sample_rate ) );
+	handle_error( gme_start_track( emu, 0 ) );
+	return emu;
+}
+
+/* Plays in odd-sized blocks, so that state is saved with output still buffered */
+static void play( Music_Emu* emu, short* out, long count )
+{
+	while ( count > 0 )
+	{
+		int n = count < 1234 ? (int) count : 1234;
+		handle_error( gme_play( emu, n, out ) );
+		out += n;
+		count -= n;
+	}
+}
+
+static void check_state( const char* path )
+{
+	Music_Emu* emu = open_track( path );
+	int size;
+	void* state;
+
+	play( emu, out1, sample_rate ); /* half a second */
+	size = gme_state_size( emu );
+	state = malloc( size );
+	if ( !state )
+		handle_error( "Out of memory" );
+	handle_error( gme_save_state( emu, state, size ) );
+
+	play( emu, out1, play_size );
+	handle_error( gme_load_state( emu, state, size ) );
+	play( emu, out2, play_size );
+	if ( memcmp( out1, out2, sizeof out1 ) )
+		fail( "state", path, "output after loading state differs" );
+
+	/* state stays valid after starting a track, and loading it restarts its
+	track if another is playing */
+	handle_error( gme_start_track( emu, gme_track_count( emu ) > 1 ) );
+	handle_error( gme_load_state( emu, state, size ) );
+	play( emu, out2, play_size );
+	if ( memcmp( out1, out2, sizeof out1 ) )
+		fail( "state", path, "output after loading state from started track differs" );
+
+	free( state );
+	gme_delete( emu );
+}
+
+static void check_state_other( const char* path )
+{
+	Music_Emu* emu   = open_track( path );
+	Music_Emu* other = open_track( path );
+	int size;
+	void* state;
+
+	play( emu, out1, sample_rate );
+	size = gme_state_size( emu );
+	state = malloc( size );
+	if ( !state )
+		handle_error( "Out of memory" );
+	handle_error( gme_save_state( emu, state, size ) );
+
+	if ( !gme_load_state( other, state, size ) )
+		fail( "state_other", path, "other emulator accepted state" );
+
+	if ( !gme_load_state( emu, state, size - 1 ) )
+		fail( "state_other", path, "truncated state accepted" );
+
+	handle_error( gme_load_file( emu, path ) );
+	handle_error( gme_start_track( emu, 0 ) );
+	if ( !gme_load_state( emu, state, size ) )
+		fail( "state_other", path, "state accepted after reloading file" );
+
+	free( state );
+	gme_delete( other );
+	gme_delete( emu );
+}
+
+static void check_borrowed( const char* path )
+{
+	long size;
+	void* data = read_file( path, &size );
+	Music_Emu* copied;
+	Music_Emu* borrowed;
+	Music_Emu* loaded;
+
+	handle_error( gme_open_data( data, size, &copied, sample_rate ) );
+	handle_error( gme_start_track( copied, 0 ) );
+	play( copied, out1, play_size );
+	gme_delete( copied );
+
+	handle_error( gme_open_data_borrowed( data, size, &borrowed, sample_rate ) );
+	handle_error( gme_start_track( borrowed, 0 ) );
+	play( borrowed, out2, play_size );
+	if ( memcmp( out1, out2, sizeof out1 ) )
+		fail( "borrowed", path, "gme_open_data_borrowed() output differs" );
+	gme_delete( borrowed );
+
+	loaded = gme_new_emu( gme_identify_extension( gme_identify_header( data ) ), sample_rate );
+	if ( !loaded )
+		handle_error( "Out of memory" );
+	handle_error( gme_load_data_borrowed( loaded, data, size ) );
+	handle_error( gme_start_track( loaded, 0 ) );
+	play( loaded, out2, play_size );
+	if ( memcmp( out1, out2, sizeof out1 ) )
+		fail( "borrowed", path, "gme_load_data_borrowed() output differs" );
+	gme_delete( loaded );
+
+	free( data );
+}
+
+static void check_float( const char* path )
+{
+	static float out_float [play_size];
+	Music_Emu* emu = open_track( path );
+	Music_Emu* emu_float = open_track( path );
+	long i;
+
+	play( emu, out1, play_size );
+	handle_error( gme_play_float( emu_float, play_size, out_float ) );
+	for ( i = 0; i < play_size; i++ )
+	{
+		double s = out_float [i] * 32768.0;
+		if ( s >  32767 ) s =  32767;
+		if ( s < -32768 ) s = -32768;
+		if ( s - out1 [i] > 1.0 || out1 [i] - s > 1.0 )
+			fail( "float", path, "output differs from gme_play()" );
+	}
+
+	gme_delete( emu_float );
+	gme_delete( emu );
+}
+
+int main( int argc, char* argv [] )
+{
+	const char* check;
+	const char* path;
+	if ( argc != 3 )
+	{
+		fprintf( stderr, "Usage: api_check state|state_other|borrowed|float file\n" );
+		return EXIT_FAILURE;
+	}
+	check = argv [1];
+	path  = argv [2];
+
+	if ( !strcmp( check, "state" ) )
+		check_state( path );
+	else if ( !strcmp( check, "state_other" ) )
+		check_state_other( path );
+	else if ( !strcmp( check, "borrowed" ) )
+		check_borrowed( path );
+	else if ( !strcmp( check, "float" ) )
+		check_float( path );
+	else
+		handle_error( "Unknown check" );
+
+	return 0;
+}
@@ -0,0 +1,627 @@
+/* Measures emulation speed of each music type. Renders test.nsf, test.vgz and a
+small generated file for each type in gme_type_list(), then reports output
+samples per second, realtime factor and nanoseconds per output sample for each.
+Samples are stereo pairs. Usage:
+
+	gme_bench [-j] [-s seconds] [-r sample_rate] [file ...]
+
+-j writes results as JSON. Files given on the command line are rendered instead
+of the built-in corpus. The YM2612 emulator is selected when the library is
+built (GME_YM2612_EMU), so compare builds to compare YM2612 emulators. */
+
+#include "gme/gme.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef GME_BENCH_YM2612
+	#define GME_BENCH_YM2612 "unknown"
+#endif
+
+/* Growable byte buffer for building synthetic files */
+
+typedef struct buf_t
+{
+	unsigned char* data;
+	long size;
+	long capacity;
+} buf_t;
+
+static void handle_error( const char* str )
+{
+	if ( str )
+	{
+		fprintf( stderr, "Error: %s\n", str );
+		exit( EXIT_FAILURE );
+	}
+}
+
+static void reserve( buf_t* b, long size )
+{
+	if ( size > b->capacity )
+	{
+		b->capacity = size * 2;
+		b->data = (unsigned char*) realloc( b->data, b->capacity );
+		if ( !b->data )
+			handle_error( "Out of memory" );
+	}
+}
+
+static void put( buf_t* b, int n )
+{
+	reserve( b, b->size + 1 );
+	b->data [b->size++] = (unsigned char) n;
+}
+
+static void put_bytes( buf_t* b, void const* in, long n )
+{
+	reserve( b, b->size + n );
+	memcpy( b->data + b->size, in, n );
+	b->size += n;
+}
+
+static void put_zeros( buf_t* b, long n )
+{
+	reserve( b, b->size + n );
+	memset( b->data + b->size, 0, n );
+	b->size += n;
+}
+
+static void put_le16( buf_t* b, unsigned n ) { put( b, n ); put( b, n >> 8 ); }
+static void put_le32( buf_t* b, unsigned long n ) { put_le16( b, n & 0xFFFF ); put_le16( b, n >> 16 ); }
+
+static void set_le32( buf_t* b, long pos, unsigned long n )
+{
+	int i;
+	for ( i = 0; i < 4; i++ )
+		b->data [pos + i] = (unsigned char) (n >> (i * 8));
+}
+
+/* Synthetic files. Each plays a short looping pattern on the main sound chip so
+that the emulator does representative work. */
+
+static void make_ay( buf_t* b )
+{
+	static unsigned char const code [0x50] = {
+		/* init: tone A on, volume 15, coarse period 1 */
+		0x01,0xFD,0xFF, 0x3E,0x07, 0xED,0x79, 0x06,0xBF, 0x3E,0x3E, 0xED,0x79,
+		0x06,0xFF, 0x3E,0x08, 0xED,0x79, 0x06,0xBF, 0x3E,0x0F, 0xED,0x79,
+		0x06,0xFF, 0x3E,0x01, 0xED,0x79, 0x06,0xBF, 0x3E,0x01, 0xED,0x79,
+		0xC9, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+		/* play: increment fine period of tone A */
+		0x21,0x00,0xC0, 0x34, 0x01,0xFD,0xFF, 0xAF, 0xED,0x79, 0x06,0xBF,
+		0x7E, 0xED,0x79, 0xC9
+	};
+
+	/* pointers are relative to their own position */
+	static unsigned char const header [0x40] = {
+		'Z','X','A','Y','E','M','U','L', 0, 0, 0, 0,
+		0x00,0x28,      /* author  -> 0x34 */
+		0x00,0x26,      /* comment -> 0x34 */
+		0, 0,           /* max track, first track */
+		0x00,0x02,      /* tracks -> 0x14 */
+		0x00,0x20,      /* 0x14: name -> 0x34 */
+		0x00,0x02,      /* data -> 0x18 */
+		0,1,2,3, 0x0B,0xB8, 0,0, 0,0, /* 0x18: channels, 60 s length, regs */
+		0x00,0x04,      /* more data -> 0x26 */
+		0x00,0x08,      /* blocks -> 0x2C */
+		0xF0,0x00, 0x80,0x00, 0x80,0x40, /* 0x26: sp, init, play */
+		0x80,0x00, 0x00,0x50, 0x00,0x10, /* 0x2C: addr, size, data -> 0x40 */
+		0x00,0x00,      /* end of blocks */
+		'g','m','e',0
+	};
+	put_bytes( b, header, sizeof header );
+	put_bytes( b, code, sizeof code );
+}
+
+static void make_gbs( buf_t* b )
+{
+	static unsigned char const code [0x30] = {
+		/* init: enable sound, square 1 at full volume */
+		0x3E,0x80, 0xE0,0x26, 0x3E,0x77, 0xE0,0x24, 0x3E,0xFF, 0xE0,0x25,
+		0x3E,0x80, 0xE0,0x11, 0x3E,0xF0, 0xE0,0x12, 0x3E,0x00, 0xE0,0x13,
+		0x3E,0x87, 0xE0,0x14, 0xC9, 0,0,0,
+		/* play: sweep frequency */
+		0xF0,0x80, 0x3C, 0xE0,0x80, 0xE0,0x13, 0xE6,0x07, 0xF6,0x80, 0xE0,0x14,
+		0xC9, 0,0
+	};
+	put_bytes( b, "GBS\1", 4 );
+	put( b, 2 ); put( b, 1 );               /* track count, first track */
+	put_le16( b, 0x0400 );                  /* load */
+	put_le16( b, 0x0400 );                  /* init */
+	put_le16( b, 0x0420 );                  /* play */
+	put_le16( b, 0xFFFE );                  /* stack */
+	put_zeros( b, 0x70 - b->size );
+	put_bytes( b, code, sizeof code );
+}
+
+/* Genesis music shared by GYM and VGM: four FM channels, DAC and square wave */
+
+enum { frame_count = 600 }; /* 10 seconds */
+
+static void fm_write( buf_t* b, int vgm, int port, int addr, int data )
+{
+	put( b, vgm ? 0x52 + port : 1 + port );
+	put( b, addr );
+	put( b, data );
+}
+
+static void psg_write( buf_t* b, int vgm, int data )
+{
+	put( b, vgm ? 0x50 : 3 );
+	put( b, data );
+}
+
+static void make_genesis( buf_t* b, int vgm )
+{
+	static int const fnums [8] = { 644, 723, 811, 859, 965, 1083, 1215, 1288 };
+	int port, c, op, f, i;
+
+	fm_write( b, vgm, 0, 0x22, 0x00 );
+	fm_write( b, vgm, 0, 0x27, 0x00 );
+	fm_write( b, vgm, 0, 0x2B, 0x80 ); /* DAC replaces channel 6 */
+	for ( port = 0; port < 2; port++ )
+	{
+		for ( c = 0; c < 2; c++ )
+		{
+			for ( op = 0; op < 4; op++ )
+			{
+				int slot = op * 4 + c;
+				fm_write( b, vgm, port, 0x30 + slot, 0x01 + op );
+				fm_write( b, vgm, port, 0x40 + slot, (op & 1) ? 0x10 : 0x20 );
+				fm_write( b, vgm, port, 0x50 + slot, 0x1F );
+				fm_write( b, vgm, port, 0x60 + slot, 0x08 );
+				fm_write( b, vgm, port, 0x70 + slot, 0x04 );
+				fm_write( b, vgm, port, 0x80 + slot, 0x2F );
+				fm_write( b, vgm, port, 0x90 + slot, 0x00 );
+			}
+			fm_write( b, vgm, port, 0xB0 + c, 0x1C ); /* feedback 3, algorithm 4 */
+			fm_write( b, vgm, port, 0xB4 + c, 0xC0 );
+		}
+	}
+	psg_write( b, vgm, 0x94 ); /* square 1 volume */
+	psg_write( b, vgm, 0xE4 ); /* white noise */
+	psg_write( b, vgm, 0xFA );
+
+	for ( f = 0; f < frame_count; f++ )
+	{
+		int period = 0x100 + (f * 7) % 0x200;
+
+		if ( f % 8 == 0 )
+		{
+			int n = f / 8;
+			int ch = n % 4;
+			int key = (ch & 2) * 2 + (ch & 1);
+			int fnum = fnums [(n * 3) % 8];
+			port = ch >> 1;
+			c = ch & 1;
+			fm_write( b, vgm, 0, 0x28, key );
+			fm_write( b, vgm, port, 0xA4 + c, (4 << 3) | (fnum >> 8) );
+			fm_write( b, vgm, port, 0xA0 + c, fnum & 0xFF );
+			fm_write( b, vgm, 0, 0x28, 0xF0 | key );
+		}
+
+		psg_write( b, vgm, 0x80 | (period & 0x0F) );
+		psg_write( b, vgm, (period >> 4) & 0x3F );
+
+		/* GYM plays DAC writes spread over the frame; VGM needs explicit waits */
+		for ( i = 0; i < 8; i++ )
+		{
+			fm_write( b, vgm, 0, 0x2A, ((f * 8 + i) * 16) & 0xFF );
+			if ( vgm )
+			{
+				put( b, 0x61 );
+				put_le16( b, i < 7 ? 92 : 91 ); /* 735 samples per frame */
+			}
+		}
+		if ( !vgm )
+			put( b, 0 );
+	}
+}
+
+static void make_gym( buf_t* b )
+{
+	put_bytes( b, "GYMX", 4 );
+	put_zeros( b, 32 * 5 + 256 );
+	put_le32( b, 1 ); /* loop from beginning */
+	put_le32( b, 0 ); /* not packed */
+	make_genesis( b, 0 );
+}
+
+static void make_vgm( buf_t* b )
+{
+	put_bytes( b, "Vgm ", 4 );
+	put_le32( b, 0 );                       /* size, set below */
+	put_le32( b, 0x150 );                   /* version */
+	put_le32( b, 3579545 );                 /* PSG clock */
+	put_le32( b, 0 );                       /* YM2413 clock */
+	put_le32( b, 0 );                       /* GD3 offset */
+	put_le32( b, frame_count * 735L );      /* total samples */
+	put_le32( b, 0x40 - 0x1C );             /* loop offset */
+	put_le32( b, frame_count * 735L );      /* loop samples */
+	put_le32( b, 60 );                      /* frame rate */
+	put_le16( b, 9 ); put( b, 16 ); put( b, 0 ); /* noise feedback, width */
+	put_le32( b, 7670453 );                 /* YM2612 clock */
+	put_le32( b, 0 );                       /* YM2151 clock */
+	put_le32( b, 0x40 - 0x34 );             /* data offset */
+	put_zeros( b, 8 );
+	make_genesis( b, 1 );
+	put( b, 0x66 );
+	set_le32( b, 4, b->size - 4 );
+}
+
+static void make_hes( buf_t* b )
+{
+	static unsigned char const code [] = {
+		/* init: channel 0 at full volume with sawtooth wave */
+		0xA9,0x00, 0x8D,0x00,0x08, 0xA9,0xFF, 0x8D,0x01,0x08,
+		0xA9,0x00, 0x8D,0x04,0x08, 0xA2,0x20,
+		0x8A, 0x8D,0x06,0x08, 0xCA, 0xD0,0xF9,
+		0xA9,0x9F, 0x8D,0x04,0x08, 0xA9,0xFF, 0x8D,0x05,0x08,
+		0xA9,0x01, 0x8D,0x03,0x08,
+		/* $4027: sweep period, then delay */
+		0xEE,0x00,0x20, 0xAD,0x00,0x20, 0x09,0x80, 0x8D,0x02,0x08,
+		0xA0,0x10, 0xA2,0x00, 0xCA, 0xD0,0xFD, 0x88, 0xD0,0xF8,
+		0x4C,0x27,0x40
+	};
+	static unsigned char const banks [8] = { 0xFF, 0xF8, 0, 0, 0, 0, 0, 0 };
+	put_bytes( b, "HESM", 4 );
+	put( b, 0 ); put( b, 0 );               /* version, first track */
+	put_le16( b, 0x4000 );                  /* init */
+	put_bytes( b, banks, sizeof banks );
+	put_bytes( b, "DATA", 4 );
+	put_le32( b, sizeof code );
+	put_le32( b, 0 );                       /* address */
+	put_le32( b, 0 );
+	put_bytes( b, code, sizeof code );
+}
+
+static void make_kss( buf_t* b )
+{
+	static unsigned char const init [] = {
+		/* AY tone A on at full volume, SCC channel 1 on */
+		0x3E,0x07, 0xD3,0xA0, 0x3E,0x3E, 0xD3,0xA1, 0x3E,0x08, 0xD3,0xA0,
+		0x3E,0x0F, 0xD3,0xA1, 0x3E,0x3F, 0x32,0x00,0x90, 0x3E,0x70, 0x32,0x00,0x98,
+		0x3E,0x90, 0x32,0x10,0x98, 0x3E,0x0F, 0x32,0x8A,0x98, 0x3E,0x01, 0x32,0x8F,0x98,
+		0xC9
+	};
+	static unsigned char const play [] = {
+		/* sweep AY and SCC periods */
+		0x3A,0x00,0xC0, 0x3C, 0x32,0x00,0xC0, 0xF5, 0xAF, 0xD3,0xA0, 0xF1, 0xD3,0xA1,
+		0x32,0x80,0x98, 0xC9
+	};
+	put_bytes( b, "KSCC", 4 );
+	put_le16( b, 0x1000 );                  /* load */
+	put_le16( b, 0x0100 );                  /* size */
+	put_le16( b, 0x1000 );                  /* init */
+	put_le16( b, 0x1080 );                  /* play */
+	put_zeros( b, 4 );
+	put_bytes( b, init, sizeof init );
+	put_zeros( b, 0x90 - b->size );
+	put_bytes( b, play, sizeof play );
+	put_zeros( b, 0x110 - b->size );
+}
+
+static unsigned char const nsf_code [0x80] = {
+	/* init: enable square 1, triangle and noise */
+	0xA9,0x0F, 0x8D,0x15,0x40, 0xA9,0xBF, 0x8D,0x00,0x40, 0xA9,0x08, 0x8D,0x01,0x40,
+	0xA9,0xFF, 0x8D,0x02,0x40, 0xA9,0x00, 0x8D,0x03,0x40, 0xA9,0x7F, 0x8D,0x04,0x40,
+	0xA9,0x08, 0x8D,0x05,0x40, 0xA9,0x80, 0x8D,0x06,0x40, 0xA9,0x01, 0x8D,0x07,0x40,
+	0xA9,0xFF, 0x8D,0x08,0x40, 0xA9,0x80, 0x8D,0x0A,0x40, 0xA9,0x00, 0x8D,0x0B,0x40,
+	0xA9,0x3C, 0x8D,0x0C,0x40, 0xA9,0x04, 0x8D,0x0E,0x40, 0xA9,0x00, 0x8D,0x0F,0x40,
+	0x60, 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
+	/* $8060 play: sweep periods */
+	0xE6,0x00, 0xA5,0x00, 0x8D,0x02,0x40, 0x4A, 0x8D,0x06,0x40, 0x0A, 0x0A,
+	0x8D,0x0A,0x40, 0xA5,0x00, 0x29,0x0F, 0x8D,0x0E,0x40, 0x60
+};
+
+static void make_nsf( buf_t* b )
+{
+	put_bytes( b, "NESM\x1A\1", 6 );
+	put( b, 1 ); put( b, 1 );               /* track count, first track */
+	put_le16( b, 0x8000 );                  /* load */
+	put_le16( b, 0x8000 );                  /* init */
+	put_le16( b, 0x8060 );                  /* play */
+	put_zeros( b, 32 * 3 );
+	put_le16( b, 0x411A );                  /* NTSC rate */
+	put_zeros( b, 8 );
+	put_le16( b, 0x4E20 );                  /* PAL rate */
+	put_zeros( b, 6 );
+	put_bytes( b, nsf_code, sizeof nsf_code );
+}
+
+static void make_nsfe( buf_t* b )
+{
+	put_bytes( b, "NSFE", 4 );
+	put_le32( b, 10 );
+	put_bytes( b, "INFO", 4 );
+	put_le16( b, 0x8000 );                  /* load */
+	put_le16( b, 0x8000 );                  /* init */
+	put_le16( b, 0x8060 );                  /* play */
+	put( b, 0 ); put( b, 0 );               /* speed, chip flags */
+	put( b, 1 ); put( b, 0 );               /* track count, first track */
+	put_le32( b, sizeof nsf_code );
+	put_bytes( b, "DATA", 4 );
+	put_bytes( b, nsf_code, sizeof nsf_code );
+	put_le32( b, 0 );
+	put_bytes( b, "NEND", 4 );
+}
+
+static void make_sap( buf_t* b )
+{
+	static unsigned char const code [] = {
+		/* init: channel 1 pure tone at volume 15 */
+		0xA9,0xAF, 0x8D,0x01,0xD2, 0xA9,0x40, 0x8D,0x00,0xD2, 0x60, 0,0,0,0,0,
+		/* $2010 play: sweep period of channels 1 and 2 */
+		0xE6,0x80, 0xA5,0x80, 0x8D,0x00,0xD2, 0x8D,0x02,0xD2, 0x60, 0,0,0,0,0
+	};
+	char const text [] = "SAP\r\nTYPE B\r\nINIT 2000\r\nPLAYER 2010\r\n";
+	put_bytes( b, text, sizeof text - 1 );
+	put( b, 0xFF ); put( b, 0xFF );
+	put_le16( b, 0x2000 );                  /* first address */
+	put_le16( b, 0x2000 + sizeof code - 1 ); /* last address */
+	put_bytes( b, code, sizeof code );
+}
+
+static void spc_voice( unsigned char* r, int n, int vl, int vr, int pitch, int src,
+		int adsr1, int adsr2, int gain )
+{
+	r += n * 0x10;
+	r [0] = vl;
+	r [1] = vr;
+	r [2] = pitch & 0xFF;
+	r [3] = pitch >> 8;
+	r [4] = src;
+	r [5] = adsr1;
+	r [6] = adsr2;
+	r [7] = gain;
+}
+
+static void make_spc( buf_t* b )
+{
+	static unsigned char const code [] = {
+		/* key on voices 0-3 with echo enabled, then sweep voice 2's pitch */
+		0x8F,0x4C,0xF2, 0x8F,0x0F,0xF3, 0x8F,0x02,0xF2, 0xAB,0xF3, 0xCD,0x00, 0x1D,
+		0xD0,0xFD, 0x8F,0x22,0xF2, 0x8B,0xF3, 0x2F,0xEF
+	};
+	static unsigned char const dir [8] = { 0x00,0x03, 0x09,0x03, 0x40,0x03, 0x40,0x03 };
+	static unsigned char const sample0 [] = { /* BRR */
+		0xA0,0x12,0x34,0x56,0x77,0x77,0x65,0x43,0x21,
+		0xB4,0xF0,0xE1,0xD2,0xC3,0x3C,0x2D,0x1E,0x0F,
+		0x9B,0x77,0x77,0x99,0x99,0x77,0x88,0x99,0x11
+	};
+	static unsigned char const sample1 [] = {
+		0xC8,0x70,0x00,0x90,0x00,0x70,0x00,0x90,0x00,
+		0xCF,0x12,0x21,0x12,0x21,0xEF,0xFE,0xEF,0xFE
+	};
+	static unsigned char const fir [8] = { 0x40, 0x20, 0x10, 0x08, 0, 0, 0xF8, 0x04 };
+	static char const sig [] = "SNES-SPC700 Sound File Data v0.30\x1A\x1A";
+	unsigned char* f;
+	unsigned char* ram;
+	unsigned char* dsp;
+	int i;
+
+	put_zeros( b, 0x10200 );
+	f = b->data;
+	memcpy( f, sig, sizeof sig - 1 );
+	f [0x23] = 0x1A;
+	f [0x24] = 30;
+	f [0x25] = 0x00;                        /* PC */
+	f [0x26] = 0x04;
+	f [0x2B] = 0xEF;                        /* SP */
+	memcpy( f + 0x2E, "Synthetic", 9 );
+	memcpy( f + 0x4E, "gme test", 8 );
+	memcpy( f + 0xA9, "60", 2 );
+	memcpy( f + 0xAC, "2000", 4 );
+
+	ram = f + 0x100;
+	memcpy( ram + 0x400, code, sizeof code );
+	memcpy( ram + 0x200, dir, sizeof dir );
+	memcpy( ram + 0x300, sample0, sizeof sample0 );
+	memcpy( ram + 0x340, sample1, sizeof sample1 );
+
+	dsp = f + 0x10100;
+	spc_voice( dsp, 0, 0x40, 0x30, 0x1000, 0, 0x8F, 0xE0, 0x00 );
+	spc_voice( dsp, 1, 0x20, 0x50, 0x0800, 1, 0xFA, 0x6A, 0x00 );
+	spc_voice( dsp, 2, 0x30, 0xD0, 0x2345, 0, 0x00, 0x00, 0x7F );
+	spc_voice( dsp, 3, 0x10, 0x10, 0x1000, 0, 0x8F, 0xE0, 0x00 );
+	dsp [0x0C] = 0x7F; dsp [0x1C] = 0x7F;   /* main volume */
+	dsp [0x2C] = 0x30; dsp [0x3C] = 0xD0;   /* echo volume */
+	dsp [0x6C] = 0x10;                      /* flags */
+	dsp [0x0D] = 0x50;                      /* echo feedback */
+	dsp [0x2D] = 0x04;                      /* pitch modulation */
+	dsp [0x3D] = 0x08;                      /* noise */
+	dsp [0x4D] = 0x03;                      /* echo on */
+	dsp [0x5D] = 0x02;                      /* sample directory */
+	dsp [0x6D] = 0x80;                      /* echo buffer */
+	dsp [0x7D] = 0x03;                      /* echo delay */
+	for ( i = 0; i < 8; i++ )
+		dsp [i * 0x10 + 0x0F] = fir [i];
+}
+
+/* Benchmark */
+
+typedef struct generator_t
+{
+	const char* extension;
+	void (*make)( buf_t* );
+} generator_t;
+
+static generator_t const generators [] = {
+	{ "AY",   make_ay   },
+	{ "GBS",  make_gbs  },
+	{ "GYM",  make_gym  },
+	{ "HES",  make_hes  },
+	{ "KSS",  make_kss  },
+	{ "NSF",  make_nsf  },
+	{ "NSFE", make_nsfe },
+	{ "SAP",  make_sap  },
+	{ "SPC",  make_spc  },
+	{ "VGM",  make_vgm  },
+	{ "VGZ",  make_vgm  }, /* Vgm_Emu also accepts uncompressed data */
+	{ 0, 0 }
+};
+
+typedef struct result_t
+{
+	long samples;   /* stereo pairs */
+	double seconds; /* CPU time */
+} result_t;
+
+static result_t bench( gme_type_t type, void const* data, long size, int sample_rate,
+		int seconds )
+{
+	#define buf_size 4096
+	static short buf [buf_size];
+	result_t r;
+	long remain = (long) seconds * sample_rate * 2;
+	clock_t start;
+
+	Music_Emu* emu = gme_new_emu( type, sample_rate );
+	if ( !emu )
+		handle_error( "Out of memory" );
+	handle_error( gme_load_data( emu, data, size ) );
+	gme_ignore_silence( emu, 1 );
+	gme_set_autoload_playback_limit( emu, 0 );
+	handle_error( gme_start_track( emu, 0 ) );
+
+	r.samples = remain / 2;
+	start = clock();
+	while ( remain > 0 )
+	{
+		int n = (remain < buf_size ? (int) remain : buf_size);
+		handle_error( gme_play( emu, n, buf ) );
+		remain -= n;
+		if ( gme_track_ended( emu ) )
+			handle_error( gme_start_track( emu, 0 ) );
+	}
+	r.seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+	gme_delete( emu );
+	return r;
+}
+
+static void report( int json, int* count, const char* name, gme_type_t type, result_t r,
+		int sample_rate )
+{
+	double secs = (r.seconds > 0 ? r.seconds : 1e-9);
+	double rate = r.samples / secs;
+	double realtime = rate / sample_rate;
+	double ns = secs * 1e9 / r.samples;
+	const char* system = gme_type_system( type );
+
+	if ( json )
+		printf( "%s\n    {\"file\": \"%s\", \"system\": \"%s\", \"samples\": %ld, "
+				"\"cpu_seconds\": %.4f, \"samples_per_second\": %.0f, "
+				"\"realtime_factor\": %.2f, \"ns_per_sample\": %.1f}",
+				(*count ? "," : ""), name, system, r.samples, r.seconds, rate, realtime, ns );
+	else
+		printf( "%-16s %-16s %12.0f %10.2fx %10.1f\n", name, system, rate, realtime, ns );
+	++*count;
+}
+
+static void bench_data( int json, int* count, const char* name, gme_type_t type,
+		void const* data, long size, int sample_rate, int seconds )
+{
+	result_t r = bench( type, data, size, sample_rate, seconds );
+	report( json, count, name, type, r, sample_rate );
+	fflush( stdout );
+}
+
+static void bench_file( int json, int* count, const char* path, int sample_rate, int seconds )
+{
+	buf_t b = { 0, 0, 0 };
+	gme_type_t type;
+	FILE* in = fopen( path, "rb" );
+	if ( !in )
+	{
+		fprintf( stderr, "Couldn't open %s\n", path );
+		exit( EXIT_FAILURE );
+	}
+	while ( !feof( in ) )
+	{
+		reserve( &b, b.size + 0x10000 );
+		b.size += (long) fread( b.data + b.size, 1, 0x10000, in );
+		if ( ferror( in ) )
+			handle_error( "Couldn't read file" );
+	}
+	fclose( in );
+
+	handle_error( gme_identify_file( path, &type ) );
+	if ( !type )
+		handle_error( gme_wrong_file_type );
+	bench_data( json, count, path, type, b.data, b.size, sample_rate, seconds );
+	free( b.data );
+}
+
+int main( int argc, char* argv [] )
+{
+	int json = 0;
+	int seconds = 30;   /* of output for each file */
+	int sample_rate = 44100;
+	int files = 0;
+	int count = 0;
+	int i;
+
+	for ( i = 1; i < argc; i++ )
+	{
+		if ( !strcmp( argv [i], "-j" ) )
+			json = 1;
+		else if ( !strcmp( argv [i], "-s" ) && i + 1 < argc )
+			seconds = atoi( argv [++i] );
+		else if ( !strcmp( argv [i], "-r" ) && i + 1 < argc )
+			sample_rate = atoi( argv [++i] );
+		else if ( argv [i] [0] == '-' )
+		{
+			fprintf( stderr, "Usage: %s [-j] [-s seconds] [-r sample_rate] [file ...]\n", argv [0] );
+			return EXIT_FAILURE;
+		}
+		else
+			argv [++files] = argv [i];
+	}
+	if ( seconds < 1 || sample_rate < 8000 )
+		handle_error( "Invalid option value" );
+
+	if ( json )
+		printf( "{\n  \"ym2612\": \"%s\",\n  \"sample_rate\": %d,\n  \"seconds\": %d,\n"
+				"  \"results\": [", GME_BENCH_YM2612, sample_rate, seconds );
+	else
+		printf( "YM2612: %s, %d Hz, %d s per file\n%-16s %-16s %12s %11s %10s\n",
+				GME_BENCH_YM2612, sample_rate, seconds,
+				"file", "system", "samples/s", "realtime", "ns/sample" );
+
+	if ( files )
+	{
+		for ( i = 1; i <= files; i++ )
+			bench_file( json, &count, argv [i], sample_rate, seconds );
+	}
+	else
+	{
+		gme_type_t const* types;
+		bench_file( json, &count, "test.nsf", sample_rate, seconds );
+		bench_file( json, &count, "test.vgz", sample_rate, seconds );
+
+		for ( types = gme_type_list(); *types; types++ )
+		{
+			char name [32];
+			generator_t const* g = generators;
+			buf_t b = { 0, 0, 0 };
+			while ( g->extension && strcmp( g->extension, gme_type_extension( *types ) ) )
+				g++;
+			if ( !g->extension )
+				continue; /* no generator for type */
+
+			g->make( &b );
+			sprintf( name, "synthetic.%s", g->extension );
+			bench_data( json, &count, name, *types, b.data, b.size, sample_rate, seconds );
+			free( b.data );
+		}
+	}
+
+	if ( json )
+		printf( "\n  ]\n}\n" );
+
+	return 0;
+}
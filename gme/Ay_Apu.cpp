@@ -2,6 +2,8 @@
 
 #include "Ay_Apu.h"
 
+#include "Emu_State.h"
+
 /* Copyright (C) 2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -94,6 +96,24 @@ Ay_Apu::Ay_Apu()
 	reset();
 }
 
+void Ay_Apu::copy_state( Emu_State& s )
+{
+	for ( int i = 0; i < osc_count; i++ )
+	{
+		osc_t& osc = oscs [i];
+		s( osc.period );
+		s( osc.delay );
+		s( osc.last_amp );
+		s( osc.phase );
+	}
+	s( last_time );
+	s( regs );
+	s( noise );
+	s( env.delay );
+	s( env.wave ); // points into env.modes, which doesn't change
+	s( env.pos );
+}
+
 void Ay_Apu::reset()
 {
 	last_time   = 0;
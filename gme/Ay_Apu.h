@@ -37,6 +37,9 @@ public:
 	// Set treble equalization (see documentation)
 	void treble_eq( blip_eq_t const& );
 
+	// Save/load emulation state in native format, without affecting settings
+	void copy_state( Emu_State& );
+
 public:
 	Ay_Apu();
 	typedef unsigned char byte;
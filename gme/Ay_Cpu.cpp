@@ -8,6 +8,7 @@ Last validated with zexall 2006.11.21 5:26 PM
 
 #include "Ay_Cpu.h"
 
+#include "Emu_State.h"
 #include "blargg_endian.h"
 #include <string.h>
 
@@ -61,6 +62,7 @@ enum {
 Ay_Cpu::Ay_Cpu()
 {
 	state = &state_;
+	instr_count_ = 0;
 	for ( int i = 0x100; --i >= 0; )
 	{
 		int even = 1;
@@ -87,6 +89,14 @@ void Ay_Cpu::reset( void* m )
 	memset( &r, 0, sizeof r );
 }
 
+void Ay_Cpu::copy_state( Emu_State& s )
+{
+	assert( state == &state_ );
+	s( r );
+	s( state_ );
+	s( end_time_ );
+}
+
 #define TIME                        (s_time + s.base)
 #define READ_PROG( addr )           (mem [addr])
 #define INSTR( offset )             READ_PROG( pc + (offset) )
@@ -170,6 +180,7 @@ call_not_taken:
 jp_not_taken:
 	pc += 2;
 loop:
+	GME_STAT( instr_count_++ );
 
 	check( (unsigned long) pc < 0x10000 );
 	check( (unsigned long) sp < 0x10000 );
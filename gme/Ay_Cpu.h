@@ -6,6 +6,8 @@
 
 #include "blargg_endian.h"
 
+class Emu_State;
+
 typedef int32_t cpu_time_t;
 
 // must be defined by caller
@@ -62,6 +64,12 @@ public:
 	// can read this far past end of memory
 	enum { cpu_padding = 0x100 };
 
+	// Number of instructions executed. Only counted if GME_STATS is defined.
+	uint64_t instr_count() const        { return instr_count_; }
+
+	// Save/load registers and timing. Memory isn't included. Can't be called during run().
+	void copy_state( Emu_State& );
+
 public:
 	Ay_Cpu();
 private:
@@ -74,6 +82,7 @@ private:
 	};
 	state_t* state; // points to state_ or a local copy within run()
 	state_t state_;
+	uint64_t instr_count_;
 	void set_end_time( cpu_time_t t );
 public:
 	registers_t r;
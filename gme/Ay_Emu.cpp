@@ -292,6 +292,7 @@ void Ay_Emu::cpu_out_misc( cpu_time_t time, unsigned addr, int data )
 
 		case 0xBEFD:
 			spectrum_mode = true;
+			GME_STAT( stats.apu_writes++ );
 			apu.write( time, apu_addr, data );
 			return;
 		}
@@ -309,6 +310,7 @@ void Ay_Emu::cpu_out_misc( cpu_time_t time, unsigned addr, int data )
 				goto enable_cpc;
 
 			case 0x80:
+				GME_STAT( stats.apu_writes++ );
 				apu.write( time, apu_addr, cpc_latch );
 				goto enable_cpc;
 			}
@@ -345,6 +347,7 @@ void ay_cpu_out( Ay_Cpu* cpu, cpu_time_t time, unsigned addr, int data )
 			emu.last_beeper = data;
 			emu.beeper_delta = -delta;
 			emu.spectrum_mode = true;
+			GME_STAT( emu.stats.apu_writes++ );
 			if ( emu.beeper_output )
 				emu.apu.synth_.offset( time, delta, emu.beeper_output );
 		}
@@ -365,6 +368,35 @@ int ay_cpu_in( Ay_Cpu*, unsigned addr )
 	return 0xFF;
 }
 
+void Ay_Emu::copy_state_( Emu_State& s )
+{
+	Classic_Emu::copy_state_( s );
+	Ay_Cpu::copy_state( s );
+	s( mem.ram );
+	s( next_play );
+	s( beeper_delta );
+	s( last_beeper );
+	s( apu_addr );
+	s( cpc_latch );
+	s( spectrum_mode );
+
+	bool was_cpc = cpc_mode;
+	s( cpc_mode );
+	if ( cpc_mode != was_cpc )
+	{
+		change_clock_rate( cpc_mode ? cpc_clock : spectrum_clock );
+		set_tempo( tempo() );
+	}
+
+	apu.copy_state( s );
+}
+
+void Ay_Emu::get_stats_( stats_t* out ) const
+{
+	Classic_Emu::get_stats_( out );
+	out->cpu_instructions += cpu::instr_count();
+}
+
 blargg_err_t Ay_Emu::run_clocks( blip_time_t& duration, int )
 {
 	set_time( 0 );
@@ -43,6 +43,8 @@ protected:
 	void set_tempo_( double );
 	void set_voice( int, Blip_Buffer*, Blip_Buffer*, Blip_Buffer* );
 	void update_eq( blip_eq_t const& );
+	void copy_state_( Emu_State& );
+	void get_stats_( stats_t* ) const;
 private:
 	file_t file;
 
@@ -0,0 +1,381 @@
+// Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
+
+#include "Batch_Renderer.h"
+
+#include "Music_Emu.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// std::thread can't report failure without exceptions, so threads are created
+// with the system's own functions
+#if defined (_WIN32)
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <pthread.h>
+#endif
+
+/* This module is free software; you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 2.1 of the License, or (at your
+option) any later version. This module is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General
+Public License for more details. You should have received a copy of the GNU
+Lesser General Public License along with this module; if not, write to the Free
+Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+02110-1301 USA */
+
+#include "blargg_source.h"
+
+struct Batch_Renderer::worker_t
+{
+	enum { max_types = 16 };
+	enum { buf_size = 4096 };
+
+	std::mutex mutex; // guards next and end, which other workers steal from
+	int next;         // jobs next to end-1 haven't been taken yet
+	int end;
+	int emu_count;
+	gme_type_t types [max_types];
+	Music_Emu* emus [max_types];
+	Music_Emu::sample_t buf [buf_size]; // for jobs without an out buffer
+
+	Batch_Renderer* owner;
+	bool has_thread;
+	unsigned batch_seen; // last batch thread started, to wait for the next one
+#if defined (_WIN32)
+	HANDLE thread;
+	static DWORD WINAPI entry( void* p )
+#else
+	pthread_t thread;
+	static void* entry( void* p )
+#endif
+	{
+		worker_t* w = static_cast<worker_t*>( p );
+		w->owner->thread_main( *w );
+		return 0;
+	}
+
+	worker_t() : next( 0 ), end( 0 ), emu_count( 0 ), owner( 0 ), has_thread( false ) { }
+	~worker_t()
+	{
+		while ( emu_count )
+			delete emus [--emu_count];
+	}
+};
+
+struct Batch_Renderer::pool_t
+{
+	std::mutex mutex;              // guards the rest
+	std::condition_variable start; // batch started or threads are stopping
+	std::condition_variable done;  // a thread finished its part of batch
+	unsigned batch;                // incremented when each batch starts
+	int active;                    // workers taking part in current batch
+	int running;                   // threads still working on current batch
+	bool stopping;
+
+	pool_t() : batch( 0 ), active( 0 ), running( 0 ), stopping( false ) { }
+};
+
+Batch_Renderer::Batch_Renderer()
+{
+	workers      = 0;
+	worker_count = 0;
+	thread_count_ = 0;
+	sample_rate_ = 0;
+	jobs         = 0;
+	pool         = 0;
+}
+
+Batch_Renderer::~Batch_Renderer()
+{
+	clear();
+	delete pool;
+}
+
+void Batch_Renderer::clear()
+{
+	stop_threads();
+	delete [] workers;
+	workers = 0;
+	worker_count = 0;
+}
+
+void Batch_Renderer::set_sample_rate( long rate )
+{
+	require( rate > 0 );
+	if ( sample_rate_ != rate )
+		clear();
+	sample_rate_ = rate;
+}
+
+blargg_err_t Batch_Renderer::alloc_workers( int n )
+{
+	if ( n <= worker_count )
+		return 0;
+
+	worker_t* new_workers = BLARGG_NEW worker_t [n];
+	CHECK_ALLOC( new_workers );
+
+	// threads refer to their worker, so start them again on the new ones
+	stop_threads();
+
+	// keep emulators of existing workers
+	for ( int i = 0; i < worker_count; i++ )
+	{
+		worker_t& w = workers [i];
+		new_workers [i].emu_count = w.emu_count;
+		for ( int j = 0; j < w.emu_count; j++ )
+		{
+			new_workers [i].types [j] = w.types [j];
+			new_workers [i].emus  [j] = w.emus  [j];
+		}
+		w.emu_count = 0;
+	}
+
+	delete [] workers;
+	workers = new_workers;
+	worker_count = n;
+	return 0;
+}
+
+blargg_err_t Batch_Renderer::start_threads( int n )
+{
+	if ( !pool )
+	{
+		pool = BLARGG_NEW pool_t;
+		CHECK_ALLOC( pool );
+	}
+
+	for ( int i = 1; i < n; i++ )
+	{
+		worker_t& w = workers [i];
+		if ( w.has_thread )
+			continue;
+
+		// no batch is running, so batch can't change before thread sees it
+		w.owner      = this;
+		w.batch_seen = pool->batch;
+	#if defined (_WIN32)
+		w.thread = CreateThread( 0, 0, &worker_t::entry, &w, 0, 0 );
+		if ( !w.thread )
+			return "Couldn't create thread";
+	#else
+		if ( pthread_create( &w.thread, 0, &worker_t::entry, &w ) )
+			return "Couldn't create thread";
+	#endif
+		w.has_thread = true;
+	}
+	return 0;
+}
+
+void Batch_Renderer::stop_threads()
+{
+	if ( !pool )
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock( pool->mutex );
+		pool->stopping = true;
+	}
+	pool->start.notify_all();
+
+	for ( int i = 0; i < worker_count; i++ )
+	{
+		worker_t& w = workers [i];
+		if ( !w.has_thread )
+			continue;
+	#if defined (_WIN32)
+		WaitForSingleObject( w.thread, INFINITE );
+		CloseHandle( w.thread );
+	#else
+		pthread_join( w.thread, 0 );
+	#endif
+		w.has_thread = false;
+	}
+
+	pool->stopping = false;
+}
+
+void Batch_Renderer::thread_main( worker_t& w )
+{
+	int const index = &w - workers;
+	std::unique_lock<std::mutex> lock( pool->mutex );
+	for ( ;; )
+	{
+		while ( !pool->stopping && pool->batch == w.batch_seen )
+			pool->start.wait( lock );
+		if ( pool->stopping )
+			return;
+		w.batch_seen = pool->batch;
+
+		if ( index < pool->active )
+		{
+			lock.unlock();
+			run( w );
+			lock.lock();
+			if ( !--pool->running )
+				pool->done.notify_one();
+		}
+	}
+}
+
+bool Batch_Renderer::next_job( worker_t& w, int* out )
+{
+	{
+		std::lock_guard<std::mutex> lock( w.mutex );
+		if ( w.next < w.end )
+		{
+			*out = w.next++;
+			return true;
+		}
+	}
+
+	// Steal second half of another worker's remaining jobs. Only the owner adds
+	// jobs to its own range, so it can be refilled after releasing victim's lock.
+	int self = &w - workers;
+	for ( int i = 1; i < worker_count; i++ )
+	{
+		worker_t& victim = workers [(self + i) % worker_count];
+		int begin, end;
+		{
+			std::lock_guard<std::mutex> lock( victim.mutex );
+			int remain = victim.end - victim.next;
+			if ( remain <= 0 )
+				continue;
+			end = victim.end;
+			begin = end - (remain + 1) / 2;
+			victim.end = begin;
+		}
+
+		std::lock_guard<std::mutex> lock( w.mutex );
+		*out = begin;
+		w.next = begin + 1;
+		w.end = end;
+		return true;
+	}
+
+	return false;
+}
+
+blargg_err_t Batch_Renderer::render_job( worker_t& w, job_t& job )
+{
+	gme_type_t type = 0;
+	if ( job.size >= 4 )
+		type = gme_identify_extension( gme_identify_header( job.data ) );
+	if ( !type )
+		return gme_wrong_file_type;
+
+	Music_Emu* emu = 0;
+	for ( int i = 0; i < w.emu_count; i++ )
+		if ( w.types [i] == type )
+			emu = w.emus [i];
+
+	// shared tables that emulators fill when created or loaded are guarded where
+	// they're filled, so workers don't need to take turns here
+	if ( !emu )
+	{
+		require( w.emu_count < worker_t::max_types );
+		emu = gme_new_emu( type, sample_rate_ );
+		CHECK_ALLOC( emu );
+		w.types [w.emu_count] = type;
+		w.emus  [w.emu_count] = emu;
+		w.emu_count++;
+	}
+	RETURN_ERR( gme_load_data( emu, job.data, job.size ) );
+	RETURN_ERR( emu->start_track( job.track ) ); // reloads file for some types
+
+	long length = job.length_msec;
+	if ( length <= 0 )
+	{
+		gme_info_t* info;
+		RETURN_ERR( gme_track_info( emu, &info, job.track ) );
+		length = info->play_length;
+		gme_free_info( info );
+	}
+	emu->set_fade( length, job.fade_msec );
+
+	// stop exactly at end of fade rather than at end of the block it ends in
+	long remain = (long) ((length + job.fade_msec) * (sample_rate_ / 1000.0) + 0.5) * 2;
+	if ( job.out && remain > job.out_size )
+		remain = job.out_size & ~1;
+
+	while ( remain > 0 && !emu->track_ended() )
+	{
+		// play in blocks so that output stops soon after track ends
+		long n = remain;
+		if ( n > worker_t::buf_size )
+			n = worker_t::buf_size;
+		Music_Emu::sample_t* out = (job.out ? job.out + job.out_count : w.buf);
+
+		RETURN_ERR( emu->play( n, out ) );
+		if ( job.callback && !job.out )
+			job.callback( job.user_data, out, n );
+		job.out_count += n;
+		remain -= n;
+	}
+
+	return 0;
+}
+
+void Batch_Renderer::run( worker_t& w )
+{
+	int i;
+	while ( next_job( w, &i ) )
+	{
+		job_t& job = jobs [i];
+		job.out_count = 0;
+		job.err = render_job( w, job );
+	}
+}
+
+blargg_err_t Batch_Renderer::render( job_t* jobs_, int count )
+{
+	require( sample_rate_ ); // sample rate must be set first
+	if ( count <= 0 )
+		return 0;
+
+	int n = thread_count_;
+	if ( n <= 0 )
+		n = std::thread::hardware_concurrency();
+	if ( n > count )
+		n = count;
+	if ( n < 1 )
+		n = 1;
+	RETURN_ERR( alloc_workers( n ) );
+	RETURN_ERR( start_threads( n ) );
+
+	// divide jobs evenly to start with; idle workers steal from others later
+	jobs = jobs_;
+	for ( int i = 0; i < worker_count; i++ )
+	{
+		workers [i].next = (i < n ? (long) count * i       / n : 0);
+		workers [i].end  = (i < n ? (long) count * (i + 1) / n : 0);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( pool->mutex );
+		pool->active  = n;
+		pool->running = n - 1;
+		pool->batch++;
+	}
+	pool->start.notify_all();
+
+	// calling thread acts as first worker
+	run( workers [0] );
+
+	{
+		std::unique_lock<std::mutex> lock( pool->mutex );
+		while ( pool->running )
+			pool->done.wait( lock );
+	}
+	jobs = 0;
+	return 0;
+}
@@ -0,0 +1,59 @@
+// Renders many tracks in parallel on a pool of worker threads
+
+// Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
+#ifndef BATCH_RENDERER_H
+#define BATCH_RENDERER_H
+
+#include "blargg_common.h"
+#include "gme.h"
+
+class Batch_Renderer {
+public:
+	// See gme.h for definition of struct gme_batch_job_t
+	typedef gme_batch_job_t job_t;
+
+	// Set output sample rate. Emulators kept from previous batches are discarded if
+	// it changes.
+	void set_sample_rate( long );
+
+	// Set number of threads to render with, where 0 uses one per CPU
+	void set_thread_count( int n )      { thread_count_ = n; }
+
+	// Render jobs and wait for all of them to finish. Each thread keeps an emulator
+	// for each file type it encounters, and these are kept for later batches, as
+	// are the threads, which wait for the next batch. Jobs are divided evenly
+	// between threads at first; a thread that runs out takes half of the remaining
+	// jobs of another. Errors for individual jobs are stored in their err field.
+	// Returns error without rendering anything if a thread couldn't be created.
+	blargg_err_t render( job_t* jobs, int count );
+
+	// Stop threads and delete emulators kept from previous batches
+	void clear();
+
+public:
+	Batch_Renderer();
+	~Batch_Renderer();
+	struct worker_t;
+	struct pool_t;
+private:
+	worker_t* workers; // calling thread runs first worker, and each other has a thread
+	int worker_count;
+	int thread_count_;
+	long sample_rate_;
+	job_t* jobs;
+	pool_t* pool;
+
+	blargg_err_t alloc_workers( int n );
+	blargg_err_t start_threads( int n );
+	void stop_threads();
+	void thread_main( worker_t& );
+	bool next_job( worker_t&, int* out );
+	void run( worker_t& );
+	blargg_err_t render_job( worker_t&, job_t& );
+
+	// noncopyable
+	Batch_Renderer( const Batch_Renderer& );
+	Batch_Renderer& operator = ( const Batch_Renderer& );
+};
+
+#endif
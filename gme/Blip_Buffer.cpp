@@ -2,11 +2,14 @@
 
 #include "Blip_Buffer.h"
 
+#include "Emu_State.h"
+#include "blargg_simd.h"
 #include <assert.h>
 #include <limits.h>
 #include <string.h>
 #include <stdlib.h>
 #include <math.h>
+#include <mutex>
 
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
@@ -33,10 +36,15 @@ Blip_Buffer::Blip_Buffer()
 	buffer_size_  = 0;
 	sample_rate_  = 0;
 	reader_accum_ = 0;
+	reader_float_accum_ = 0;
 	bass_shift_   = 0;
 	clock_rate_   = 0;
 	bass_freq_    = 16;
 	length_       = 0;
+	offset_count_ = 0;
+	read_count_   = 0;
+	synth_quality_ = blip_synth_normal;
+	float_accum_  = false;
 
 	// assumptions code makes about implementation-defined features
 	#ifndef NDEBUG
@@ -53,7 +61,7 @@ Blip_Buffer::Blip_Buffer()
 Blip_Buffer::~Blip_Buffer()
 {
 	if ( buffer_size_ != silent_buf_size )
-		free( buffer_ );
+		blargg_free( buffer_ );
 }
 
 Silent_Blip_Buffer::Silent_Blip_Buffer()
@@ -68,6 +76,7 @@ void Blip_Buffer::clear( int entire_buffer )
 {
 	offset_      = 0;
 	reader_accum_ = 0;
+	reader_float_accum_ = 0;
 	modified_    = 0;
 	if ( buffer_ )
 	{
@@ -97,7 +106,7 @@ Blip_Buffer::blargg_err_t Blip_Buffer::set_sample_rate( long new_rate, int msec
 
 	if ( buffer_size_ != new_size )
 	{
-		void* p = realloc( buffer_, (new_size + blip_buffer_extra_) * sizeof *buffer_ );
+		void* p = blargg_realloc( buffer_, (new_size + blip_buffer_extra_) * sizeof *buffer_ );
 		if ( !p )
 			return "Out of memory";
 		buffer_ = (buf_t_*) p;
@@ -120,6 +129,41 @@ Blip_Buffer::blargg_err_t Blip_Buffer::set_sample_rate( long new_rate, int msec
 	return 0; // success
 }
 
+// Converts floating-point buffer value back to fixed-point, clamping it to the range
+// of blip_long
+static blip_long to_fixed( float f )
+{
+	double d = floor( f * (1.0 / blip_float_unit) + 0.5 );
+	if ( d > INT_MAX )
+		d = INT_MAX;
+	if ( d < INT_MIN )
+		d = INT_MIN;
+	return (blip_long) d;
+}
+
+void Blip_Buffer::set_float_accum( bool b )
+{
+	if ( float_accum_ == b )
+		return;
+	float_accum_ = b;
+
+	// everything past unread samples and impulse tails is zero either way
+	long const count = (buffer_ ? samples_avail() + blip_buffer_extra_ : 0);
+	float* const f = float_buffer_();
+	if ( b )
+	{
+		for ( long i = 0; i < count; i++ )
+			f [i] = buffer_ [i] * blip_float_unit;
+		reader_float_accum_ = reader_accum_ * blip_float_unit;
+	}
+	else
+	{
+		for ( long i = 0; i < count; i++ )
+			buffer_ [i] = to_fixed( f [i] );
+		reader_accum_ = to_fixed( reader_float_accum_ );
+	}
+}
+
 blip_resampled_time_t Blip_Buffer::clock_rate_factor( uint32_t rate ) const
 {
 	double ratio = (double) sample_rate_ / rate;
@@ -177,6 +221,9 @@ void Blip_Buffer::remove_samples( long count )
 {
 	if ( count )
 	{
+		#if GME_STATS
+			read_count_ += count;
+		#endif
 		remove_silence( count );
 
 		// copy remaining samples to beginning and clear old samples
@@ -186,6 +233,32 @@ void Blip_Buffer::remove_samples( long count )
 	}
 }
 
+void Blip_Buffer::copy_state( Emu_State& s )
+{
+	// everything past unread samples and impulse tails is zero
+	long old_count = samples_avail() + blip_buffer_extra_;
+
+	// loaded samples are converted if they were saved with the other accumulation
+	bool const float_accum = float_accum_;
+	s( float_accum_ );
+
+	s( offset_ );
+	s( reader_accum_ );
+	s( reader_float_accum_ );
+	s( modified_ );
+	if ( (offset_ >> BLIP_BUFFER_ACCURACY) > (blip_resampled_time_t) buffer_size_ )
+	{
+		s.set_corrupt();
+		offset_ = 0;
+	}
+
+	long count = samples_avail() + blip_buffer_extra_;
+	s.copy( buffer_, count * sizeof *buffer_ );
+	if ( s.loading() && old_count > count )
+		memset( buffer_ + count, 0, (old_count - count) * sizeof *buffer_ );
+	set_float_accum( float_accum );
+}
+
 // Blip_Synth_
 
 Blip_Synth_Fast_::Blip_Synth_Fast_()
@@ -193,26 +266,17 @@ Blip_Synth_Fast_::Blip_Synth_Fast_()
 	buf = 0;
 	last_amp = 0;
 	delta_factor = 0;
+	float_factor = 0;
 }
 
 void Blip_Synth_Fast_::volume_unit( double new_unit )
 {
 	delta_factor = int (new_unit * (1L << blip_sample_bits) + 0.5);
+	float_factor = delta_factor * blip_float_unit;
 }
 
 #if !BLIP_BUFFER_FAST
 
-Blip_Synth_::Blip_Synth_( short* p, int w ) :
-	impulses( p ),
-	width( w )
-{
-	volume_unit_ = 0.0;
-	kernel_unit = 0;
-	buf = 0;
-	last_amp = 0;
-	delta_factor = 0;
-}
-
 #undef PI
 #define PI 3.1415926535897932384626433832795029
 
@@ -279,10 +343,38 @@ void blip_eq_t::generate( float* out, int count ) const
 		out [i] *= 0.54f - 0.46f * (float) cos( i * to_fraction );
 }
 
-void Blip_Synth_::adjust_impulse()
+// Impulse kernels
+
+// Kernels never change once made, so any number of synths can share one. They
+// are kept in a list for as long as any synth uses them.
+struct blip_kernel_t
+{
+	blip_kernel_t* next;
+	long refs;
+	blip_eq_t eq;
+	int width;
+	int shift; // amount kernel_unit is reduced by, for low volumes
+	blip_long kernel_unit;
+	short* impulses;
+	short* taps;
+};
+
+static std::mutex kernels_mutex;
+static blip_kernel_t* kernels; // guarded by kernels_mutex
+
+//long const blip_base_unit = 44800 - 128 * 18; // allows treble up to +0 dB
+//long const blip_base_unit = 37888; // allows treble to +5 dB
+long const blip_base_unit = 32768; // necessary for blip_unscaled to work
+
+// used until a synth has a kernel, so its output is silent
+static short const silent_impulses [blip_res * blip_widest_impulse_] = { 0 };
+
+static int impulses_size( int width ) { return blip_res / 2 * width + 1; }
+
+static void adjust_impulse( short* impulses, int width, blip_long kernel_unit )
 {
 	// sum pairs for each phase and add error correction to end of first half
-	int const size = impulses_size();
+	int const size = impulses_size( width );
 	for ( int p = blip_res; p-- >= blip_res / 2; )
 	{
 		int p2 = blip_res - 2 - p;
@@ -303,8 +395,46 @@ void Blip_Synth_::adjust_impulse()
 	//      printf( "%5ld,", impulses [j * blip_res + i + 1] );
 }
 
-void Blip_Synth_::treble_eq( blip_eq_t const& eq )
+static void make_taps( short* taps, short const* impulses, int width )
+{
+	// first half comes from forward impulse for phase, second half from reversed
+	// impulse for its mirror, just as offset_resampled() reads them
+	int const half = width / 2;
+	for ( int p = 0; p < blip_res; p++ )
+	{
+		short* out = taps + p * width;
+		for ( int i = 0; i < half; i++ )
+		{
+			out [i]             = impulses [blip_res - p + blip_res * i];
+			out [width - 1 - i] = impulses [p + blip_res * i];
+		}
+	}
+}
+
+blip_kernel_t* Blip_Synth_::make_kernel( blip_eq_t const& eq, int width, int shift )
 {
+	size_t const header_size = (sizeof (blip_kernel_t) + 15) & ~15;
+	size_t const taps_size = blip_res * width * sizeof (short);
+
+	// kernels outlive the emulator that made them, so they mustn't be in its arena
+	blip_kernel_t* k;
+	{
+		blargg_arena_scope no_arena( 0 );
+		k = (blip_kernel_t*) blargg_realloc( 0, header_size + taps_size +
+				impulses_size( width ) * sizeof (short) );
+	}
+	if ( !k )
+		return 0;
+
+	k->next     = 0;
+	k->refs     = 0;
+	k->eq       = eq;
+	k->width    = width;
+	k->shift    = shift;
+	k->taps     = (short*) ((char*) k + header_size);
+	k->impulses = (short*) ((char*) k + header_size + taps_size);
+	short* const impulses = k->impulses;
+
 	float fimpulse [blip_res / 2 * (blip_widest_impulse_ - 1) + blip_res * 2];
 
 	int const half_size = blip_res / 2 * (width - 1);
@@ -325,77 +455,457 @@ void Blip_Synth_::treble_eq( blip_eq_t const& eq )
 	for ( i = 0; i < half_size; i++ )
 		total += fimpulse [blip_res + i];
 
-	//double const base_unit = 44800.0 - 128 * 18; // allows treble up to +0 dB
-	//double const base_unit = 37888.0; // allows treble to +5 dB
-	double const base_unit = 32768.0; // necessary for blip_unscaled to work
-	double rescale = base_unit / 2 / total;
-	kernel_unit = (long) base_unit;
+	double rescale = blip_base_unit / 2 / total;
+	k->kernel_unit = blip_base_unit;
 
 	// integrate, first difference, rescale, convert to int
 	double sum = 0.0;
 	double next = 0.0;
-	int const impulses_size = this->impulses_size();
-	for ( i = 0; i < impulses_size; i++ )
+	int const size = impulses_size( width );
+	for ( i = 0; i < size; i++ )
 	{
 		impulses [i] = (short) floor( (next - sum) * rescale + 0.5 );
 		sum += fimpulse [i];
 		next += fimpulse [i + blip_res];
 	}
-	adjust_impulse();
+	adjust_impulse( impulses, width, k->kernel_unit );
+
+	if ( shift )
+	{
+		k->kernel_unit >>= shift;
+		assert( k->kernel_unit > 0 ); // fails if volume unit is too low
+
+		// keep values positive to avoid round-towards-zero of sign-preserving
+		// right shift for negative values
+		long offset = 0x8000 + (1 << (shift - 1));
+		long offset2 = 0x8000 >> shift;
+		for ( i = size; i--; )
+			impulses [i] = (short) (((impulses [i] + offset) >> shift) - offset2);
+		adjust_impulse( impulses, width, k->kernel_unit );
+	}
+
+	make_taps( k->taps, impulses, width );
+
+	return k;
+}
 
-	// volume might require rescaling
-	double vol = volume_unit_;
-	if ( vol )
+static void release_kernel( blip_kernel_t* k )
+{
+	std::lock_guard<std::mutex> lock( kernels_mutex );
+	if ( !--k->refs )
 	{
-		volume_unit_ = 0.0;
-		volume_unit( vol );
+		blip_kernel_t** p = &kernels;
+		while ( *p != k )
+			p = &(*p)->next;
+		*p = k->next;
+		blargg_free( k );
 	}
 }
 
+void Blip_Synth_::set_kernel( blip_eq_t const& eq, int shift )
+{
+	#define KERNEL_MATCHES( k ) ((k)->width == width && (k)->shift == shift &&\
+			(k)->eq.treble == eq.treble && (k)->eq.rolloff_freq == eq.rolloff_freq &&\
+			(k)->eq.sample_rate == eq.sample_rate && (k)->eq.cutoff_freq == eq.cutoff_freq)
+
+	if ( kernel && KERNEL_MATCHES( kernel ) )
+		return;
+
+	blip_kernel_t* k = 0;
+	{
+		std::lock_guard<std::mutex> lock( kernels_mutex );
+		for ( k = kernels; k && !KERNEL_MATCHES( k ); )
+			k = k->next;
+		if ( k )
+			k->refs++;
+	}
+
+	if ( !k )
+	{
+		// make outside lock so other threads aren't held up, then add unless
+		// another thread added the same kernel meanwhile
+		blip_kernel_t* made = make_kernel( eq, width, shift );
+		if ( !made )
+			return; // keep current kernel, which is silent if there isn't one yet
+
+		std::lock_guard<std::mutex> lock( kernels_mutex );
+		for ( k = kernels; k && !KERNEL_MATCHES( k ); )
+			k = k->next;
+		if ( k )
+		{
+			blargg_free( made );
+		}
+		else
+		{
+			k = made;
+			k->next = kernels;
+			kernels = k;
+		}
+		k->refs++;
+	}
+
+	#undef KERNEL_MATCHES
+
+	if ( kernel )
+		release_kernel( kernel );
+	kernel      = k;
+	impulses    = k->impulses;
+	taps        = k->taps;
+	kernel_unit = k->kernel_unit;
+}
+
+Blip_Synth_::Blip_Synth_( int w ) :
+	width( w )
+{
+	volume_unit_ = 0.0;
+	kernel = 0;
+	impulses = silent_impulses;
+	taps = silent_impulses;
+	kernel_unit = blip_base_unit;
+	buf = 0;
+	last_amp = 0;
+	delta_factor = 0;
+	fast_delta_factor = 0;
+	float_factor = 0;
+	fast_float_factor = 0;
+}
+
+Blip_Synth_::~Blip_Synth_()
+{
+	if ( kernel )
+		release_kernel( kernel );
+}
+
+// Amount kernel needs to be attenuated by so that delta_factor is at least 2
+static int kernel_shift( double unit )
+{
+	int shift = 0;
+	double factor = unit * (1L << blip_sample_bits) / blip_base_unit;
+	if ( factor > 0.0 )
+	{
+		while ( factor < 2.0 )
+		{
+			shift++;
+			factor *= 2.0;
+		}
+	}
+	return shift;
+}
+
+void Blip_Synth_::treble_eq( blip_eq_t const& eq )
+{
+	set_kernel( eq, kernel_shift( volume_unit_ ) );
+	delta_factor = (int) floor( volume_unit_ * (1L << blip_sample_bits) / kernel_unit + 0.5 );
+	float_factor = delta_factor * blip_float_unit;
+}
+
 void Blip_Synth_::volume_unit( double new_unit )
 {
 	if ( new_unit != volume_unit_ )
 	{
+		volume_unit_ = new_unit;
+		fast_delta_factor = int (new_unit * (1L << blip_sample_bits) + 0.5);
+		fast_float_factor = fast_delta_factor * blip_float_unit;
+
 		// use default eq if it hasn't been set yet
-		if ( !kernel_unit )
-			treble_eq( -8.0 );
+		treble_eq( kernel ? kernel->eq : blip_eq_t( -8.0 ) );
+		//printf( "delta_factor: %d, kernel_unit: %d\n", delta_factor, kernel_unit );
+	}
+}
+#endif
 
-		volume_unit_ = new_unit;
-		double factor = new_unit * (1L << blip_sample_bits) / kernel_unit;
+// Reading and mixing
+
+// The integrator in read_samples() is serial, so SIMD versions run it in scalar
+// registers four samples at a time and use vectors to clamp, convert and store
+// the results. All give exactly the same output as the portable code.
+
+typedef Blip_Buffer::buf_t_ buf_t_;
+
+#if BLARGG_SIMD_SSE2 || BLARGG_SIMD_NEON
+
+// Reads remaining samples that don't fill a vector and returns new accumulator
+static blip_long read_tail( buf_t_ const* in, blip_long accum, int bass,
+		blip_sample_t* out, long count, int step )
+{
+	for ( long i = 0; i < count; i++ )
+	{
+		blip_long s = accum >> (blip_sample_bits - 16);
+		if ( (blip_sample_t) s != s )
+			s = 0x7FFF - (s >> 24);
+		out [i * step] = (blip_sample_t) s;
+		accum += in [i] - (accum >> bass);
+	}
+	return accum;
+}
+
+static blip_long read_tail( buf_t_ const* in, blip_long accum, int bass,
+		float* out, long count, int step )
+{
+	for ( long i = 0; i < count; i++ )
+	{
+		out [i * step] = (float) accum * blip_float_unit;
+		accum += in [i] - (accum >> bass);
+	}
+	return accum;
+}
+
+#endif
+
+#if BLARGG_SIMD_SSE2
+
+// Runs integrator over four samples and returns its value before each step
+static inline __m128i integrate4( buf_t_ const* in, blip_long& accum, int bass )
+{
+	blip_long a0 = accum; accum += in [0] - (accum >> bass);
+	blip_long a1 = accum; accum += in [1] - (accum >> bass);
+	blip_long a2 = accum; accum += in [2] - (accum >> bass);
+	blip_long a3 = accum; accum += in [3] - (accum >> bass);
+	return _mm_set_epi32( a3, a2, a1, a0 );
+}
+
+static blip_long read_samples_sse2( buf_t_ const* in, blip_long accum, int bass,
+		blip_sample_t* out, long count, int stereo )
+{
+	long const n = count & ~3;
+	for ( long i = 0; i < n; i += 4 )
+	{
+		__m128i s = _mm_srai_epi32( integrate4( in + i, accum, bass ), blip_sample_bits - 16 );
+		s = _mm_packs_epi32( s, s );
+		if ( !stereo )
+		{
+			_mm_storel_epi64( (__m128i*) (out + i), s );
+		}
+		else
+		{
+			// keep other channel's samples
+			__m128i* p = (__m128i*) (out + i * 2);
+			__m128i other = _mm_andnot_si128( _mm_set1_epi32( 0xFFFF ), _mm_loadu_si128( p ) );
+			s = _mm_unpacklo_epi16( s, _mm_setzero_si128() );
+			_mm_storeu_si128( p, _mm_or_si128( s, other ) );
+		}
+	}
+	int const step = stereo ? 2 : 1;
+	return read_tail( in + n, accum, bass, out + n * step, count - n, step );
+}
 
-		if ( factor > 0.0 )
+static blip_long read_samples_sse2( buf_t_ const* in, blip_long accum, int bass,
+		float* out, long count, int stereo )
+{
+	__m128 const unit = _mm_set1_ps( blip_float_unit );
+	long const n = count & ~3;
+	for ( long i = 0; i < n; i += 4 )
+	{
+		__m128 s = _mm_mul_ps( _mm_cvtepi32_ps( integrate4( in + i, accum, bass ) ), unit );
+		if ( !stereo )
 		{
-			int shift = 0;
+			_mm_storeu_ps( out + i, s );
+		}
+		else
+		{
+			// keep other channel's samples
+			float* p = out + i * 2;
+			__m128 other = _mm_shuffle_ps( _mm_loadu_ps( p ), _mm_loadu_ps( p + 4 ),
+					_MM_SHUFFLE( 3, 1, 3, 1 ) );
+			_mm_storeu_ps( p,     _mm_unpacklo_ps( s, other ) );
+			_mm_storeu_ps( p + 4, _mm_unpackhi_ps( s, other ) );
+		}
+	}
+	int const step = stereo ? 2 : 1;
+	return read_tail( in + n, accum, bass, out + n * step, count - n, step );
+}
 
-			// if unit is really small, might need to attenuate kernel
-			while ( factor < 2.0 )
-			{
-				shift++;
-				factor *= 2.0;
-			}
+// Mixes as many samples as fill whole vectors and returns number mixed. Previous
+// sample is read from in [-1].
+static long mix_samples_sse2( buf_t_* out, blip_sample_t const* in, long count )
+{
+	int const sample_shift = blip_sample_bits - 16;
+	long const n = count & ~3;
+	for ( long i = 0; i < n; i += 4 )
+	{
+		__m128i s = _mm_loadl_epi64( (__m128i const*) (in + i) );
+		__m128i p = _mm_loadl_epi64( (__m128i const*) (in + i - 1) );
+		s = _mm_srai_epi32( _mm_unpacklo_epi16( s, s ), 16 );
+		p = _mm_srai_epi32( _mm_unpacklo_epi16( p, p ), 16 );
+		__m128i delta = _mm_slli_epi32( _mm_sub_epi32( s, p ), sample_shift );
+		__m128i* o = (__m128i*) (out + i);
+		_mm_storeu_si128( o, _mm_add_epi32( _mm_loadu_si128( o ), delta ) );
+	}
+	return n;
+}
 
-			if ( shift )
-			{
-				kernel_unit >>= shift;
-				assert( kernel_unit > 0 ); // fails if volume unit is too low
-
-				// keep values positive to avoid round-towards-zero of sign-preserving
-				// right shift for negative values
-				long offset = 0x8000 + (1 << (shift - 1));
-				long offset2 = 0x8000 >> shift;
-				for ( int i = impulses_size(); i--; )
-					impulses [i] = (short) (((impulses [i] + offset) >> shift) - offset2);
-				adjust_impulse();
-			}
+#endif
+
+#if BLARGG_SIMD_AVX2
+
+BLARGG_TARGET_AVX2
+static long mix_samples_avx2( buf_t_* out, blip_sample_t const* in, long count )
+{
+	int const sample_shift = blip_sample_bits - 16;
+	long const n = count & ~7;
+	for ( long i = 0; i < n; i += 8 )
+	{
+		__m256i s = _mm256_cvtepi16_epi32( _mm_loadu_si128( (__m128i const*) (in + i) ) );
+		__m256i p = _mm256_cvtepi16_epi32( _mm_loadu_si128( (__m128i const*) (in + i - 1) ) );
+		__m256i delta = _mm256_slli_epi32( _mm256_sub_epi32( s, p ), sample_shift );
+		__m256i* o = (__m256i*) (out + i);
+		_mm256_storeu_si256( o, _mm256_add_epi32( _mm256_loadu_si256( o ), delta ) );
+	}
+	return n;
+}
+
+#endif
+
+#if BLARGG_SIMD_NEON
+
+// Runs integrator over four samples and returns its value before each step
+static inline int32x4_t integrate4( buf_t_ const* in, blip_long& accum, int bass )
+{
+	int32x4_t v = vdupq_n_s32( accum ); accum += in [0] - (accum >> bass);
+	v = vsetq_lane_s32( accum, v, 1 );  accum += in [1] - (accum >> bass);
+	v = vsetq_lane_s32( accum, v, 2 );  accum += in [2] - (accum >> bass);
+	v = vsetq_lane_s32( accum, v, 3 );  accum += in [3] - (accum >> bass);
+	return v;
+}
+
+static blip_long read_samples_neon( buf_t_ const* in, blip_long accum, int bass,
+		blip_sample_t* out, long count, int stereo )
+{
+	long const n = count & ~3;
+	for ( long i = 0; i < n; i += 4 )
+	{
+		int16x4_t s = vqmovn_s32( vshrq_n_s32( integrate4( in + i, accum, bass ), blip_sample_bits - 16 ) );
+		if ( !stereo )
+		{
+			vst1_s16( out + i, s );
 		}
-		delta_factor = (int) floor( factor + 0.5 );
-		//printf( "delta_factor: %d, kernel_unit: %d\n", delta_factor, kernel_unit );
+		else
+		{
+			// keep other channel's samples
+			int16x4x2_t pair = vld2_s16( out + i * 2 );
+			pair.val [0] = s;
+			vst2_s16( out + i * 2, pair );
+		}
+	}
+	int const step = stereo ? 2 : 1;
+	return read_tail( in + n, accum, bass, out + n * step, count - n, step );
+}
+
+static blip_long read_samples_neon( buf_t_ const* in, blip_long accum, int bass,
+		float* out, long count, int stereo )
+{
+	long const n = count & ~3;
+	for ( long i = 0; i < n; i += 4 )
+	{
+		float32x4_t s = vmulq_n_f32( vcvtq_f32_s32( integrate4( in + i, accum, bass ) ), blip_float_unit );
+		if ( !stereo )
+		{
+			vst1q_f32( out + i, s );
+		}
+		else
+		{
+			// keep other channel's samples
+			float32x4x2_t pair = vld2q_f32( out + i * 2 );
+			pair.val [0] = s;
+			vst2q_f32( out + i * 2, pair );
+		}
+	}
+	int const step = stereo ? 2 : 1;
+	return read_tail( in + n, accum, bass, out + n * step, count - n, step );
+}
+
+// Mixes as many samples as fill whole vectors and returns number mixed. Previous
+// sample is read from in [-1].
+static long mix_samples_neon( buf_t_* out, blip_sample_t const* in, long count )
+{
+	int const sample_shift = blip_sample_bits - 16;
+	long const n = count & ~3;
+	for ( long i = 0; i < n; i += 4 )
+	{
+		int32x4_t delta = vsubl_s16( vld1_s16( in + i ), vld1_s16( in + i - 1 ) );
+		delta = vshlq_n_s32( delta, sample_shift );
+		vst1q_s32( out + i, vaddq_s32( vld1q_s32( out + i ), delta ) );
 	}
+	return n;
 }
+
 #endif
 
+// Reads samples using SIMD if available and returns true, otherwise returns false
+template<class T>
+static bool read_samples_simd( buf_t_ const* in, blip_long& accum, int bass,
+		T* out, long count, int stereo )
+{
+	#if BLARGG_SIMD_SSE2
+		if ( blargg_cpu_features() & blargg_cpu_sse2 )
+		{
+			accum = read_samples_sse2( in, accum, bass, out, count, stereo );
+			return true;
+		}
+	#elif BLARGG_SIMD_NEON
+		if ( blargg_cpu_features() & blargg_cpu_neon )
+		{
+			accum = read_samples_neon( in, accum, bass, out, count, stereo );
+			return true;
+		}
+	#endif
+	(void) in; (void) accum; (void) bass; (void) out; (void) count; (void) stereo;
+	return false;
+}
+
+static long mix_samples_simd( buf_t_* out, blip_sample_t const* in, long count )
+{
+	int const features = blargg_cpu_features();
+	(void) features;
+	#if BLARGG_SIMD_AVX2
+		if ( features & blargg_cpu_avx2 )
+			return mix_samples_avx2( out, in, count );
+	#endif
+	#if BLARGG_SIMD_SSE2
+		if ( features & blargg_cpu_sse2 )
+			return mix_samples_sse2( out, in, count );
+	#elif BLARGG_SIMD_NEON
+		if ( features & blargg_cpu_neon )
+			return mix_samples_neon( out, in, count );
+	#endif
+	(void) out; (void) in; (void) count;
+	return 0;
+}
+
+static inline void store_float( blip_sample_t* out, float s ) { *out = blip_float_to_sample( s ); }
+static inline void store_float( float* out, float s ) { *out = s; }
+
+template<class T>
+long Blip_Buffer::read_float_samples( T* BLIP_RESTRICT out, long max_samples, int stereo )
+{
+	long count = samples_avail();
+	if ( count > max_samples )
+		count = max_samples;
+
+	if ( count )
+	{
+		float const bass = BLIP_FLOAT_READER_BASS( *this );
+		BLIP_FLOAT_READER_BEGIN( reader, *this );
+
+		int const step = stereo ? 2 : 1;
+		for ( blip_long n = count; n; --n )
+		{
+			store_float( out, BLIP_FLOAT_READER_READ( reader ) );
+			out += step;
+			BLIP_FLOAT_READER_NEXT( reader, bass );
+		}
+		BLIP_FLOAT_READER_END( reader, *this );
+
+		remove_samples( count );
+	}
+	return count;
+}
+
 long Blip_Buffer::read_samples( blip_sample_t* BLIP_RESTRICT out, long max_samples, int stereo )
 {
+	if ( float_accum_ )
+		return read_float_samples( out, max_samples, stereo );
+
 	long count = samples_avail();
 	if ( count > max_samples )
 		count = max_samples;
@@ -403,6 +913,12 @@ long Blip_Buffer::read_samples( blip_sample_t* BLIP_RESTRICT out, long max_sampl
 	if ( count )
 	{
 		int const bass = BLIP_READER_BASS( *this );
+		if ( read_samples_simd( buffer_, reader_accum_, bass, out, count, stereo ) )
+		{
+			remove_samples( count );
+			return count;
+		}
+
 		BLIP_READER_BEGIN( reader, *this );
 
 		if ( !stereo )
@@ -435,6 +951,40 @@ long Blip_Buffer::read_samples( blip_sample_t* BLIP_RESTRICT out, long max_sampl
 	return count;
 }
 
+long Blip_Buffer::read_samples( float* BLIP_RESTRICT out, long max_samples, int stereo )
+{
+	if ( float_accum_ )
+		return read_float_samples( out, max_samples, stereo );
+
+	long count = samples_avail();
+	if ( count > max_samples )
+		count = max_samples;
+
+	if ( count )
+	{
+		int const bass = BLIP_READER_BASS( *this );
+		if ( read_samples_simd( buffer_, reader_accum_, bass, out, count, stereo ) )
+		{
+			remove_samples( count );
+			return count;
+		}
+
+		BLIP_READER_BEGIN( reader, *this );
+
+		int const step = stereo ? 2 : 1;
+		for ( blip_long n = count; n; --n )
+		{
+			*out = BLIP_READER_READ_FLOAT( reader );
+			out += step;
+			BLIP_READER_NEXT( reader, bass );
+		}
+		BLIP_READER_END( reader, *this );
+
+		remove_samples( count );
+	}
+	return count;
+}
+
 void Blip_Buffer::mix_samples( blip_sample_t const* in, long count )
 {
 	if ( buffer_size_ == silent_buf_size )
@@ -443,10 +993,40 @@ void Blip_Buffer::mix_samples( blip_sample_t const* in, long count )
 		return;
 	}
 
-	buf_t_* out = buffer_ + (offset_ >> BLIP_BUFFER_ACCURACY) + blip_widest_impulse_ / 2;
+	long const pos = (long) (offset_ >> BLIP_BUFFER_ACCURACY) + blip_widest_impulse_ / 2;
+
+	if ( float_accum_ )
+	{
+		float* out = float_buffer_() + pos;
+		float prev = 0;
+		while ( count-- )
+		{
+			float s = *in++ * (1.0f / 0x8000);
+			*out += s - prev;
+			prev = s;
+			++out;
+		}
+		*out -= prev;
+		return;
+	}
+
+	buf_t_* out = buffer_ + pos;
 
 	int const sample_shift = blip_sample_bits - 16;
 	int prev = 0;
+	if ( count > 1 )
+	{
+		// SIMD versions read previous sample from input, so start after first one
+		long n = mix_samples_simd( out + 1, in + 1, count - 1 );
+		if ( n )
+		{
+			*out += (blip_long) *in << sample_shift;
+			prev = (blip_long) in [n] << sample_shift;
+			out   += n + 1;
+			in    += n + 1;
+			count -= n + 1;
+		}
+	}
 	while ( count-- )
 	{
 		blip_long s = (blip_long) *in++ << sample_shift;
@@ -22,6 +22,8 @@ typedef blip_long blip_time_t;
 typedef short blip_sample_t;
 enum { blip_sample_max = 32767 };
 
+class Emu_State;
+
 class Blip_Buffer {
 public:
 	typedef const char* blargg_err_t;
@@ -45,6 +47,10 @@ public:
 	// easy interleving of two channels into a stereo output buffer.
 	long read_samples( blip_sample_t* dest, long max_samples, int stereo = 0 );
 
+	// Same as above, but writes floating-point samples without clamping, where 1.0
+	// corresponds to a full-scale 16-bit sample
+	long read_samples( float* dest, long max_samples, int stereo = 0 );
+
 // Additional optional features
 
 	// Current output sample rate
@@ -62,6 +68,18 @@ public:
 	// Number of samples delay from synthesis to samples read out
 	int output_latency() const;
 
+	// Set quality that Blip_Synth uses when adding to this buffer, regardless of the
+	// quality it was declared with: blip_synth_fast (linear interpolation),
+	// blip_synth_normal (default), or blip_synth_high (blip_high_quality)
+	void set_synth_quality( int q )             { synth_quality_ = q; }
+	int synth_quality() const                   { return synth_quality_; }
+
+	// Accumulate samples in floating-point rather than fixed-point, so that loud
+	// sums of many voices can't overflow, and floating-point output needs no
+	// conversion. Samples waiting to be read are converted.
+	void set_float_accum( bool );
+	bool float_accum() const                    { return float_accum_; }
+
 	// Remove all available samples and clear buffer to silence. If 'entire_buffer' is
 	// false, just clears out any samples waiting rather than the entire buffer.
 	void clear( int entire_buffer = 1 );
@@ -85,6 +103,9 @@ public:
 	// Mix 'count' samples from 'buf' into buffer.
 	void mix_samples( blip_sample_t const* buf, long count );
 
+	// Save/load samples waiting to be read. Sample rate and clock rate aren't saved.
+	void copy_state( Emu_State& );
+
 	// not documented yet
 	void set_modified() { modified_ = 1; }
 	int clear_modified() { int b = modified_; modified_ = 0; return b; }
@@ -112,17 +133,25 @@ public:
 	buf_t_* buffer_;
 	blip_long buffer_size_;
 	blip_long reader_accum_;
+	float reader_float_accum_; // used instead of reader_accum_ if float_accum()
 	int bass_shift_;
+	uint64_t offset_count_; // counted only if GME_STATS is defined
+	uint64_t read_count_;
+	float* float_buffer_() const { return (float*) buffer_; } // if float_accum()
 private:
 	long sample_rate_;
 	uint32_t clock_rate_;
 	int bass_freq_;
 	int length_;
 	int modified_;
+	int synth_quality_;
+	bool float_accum_;
+	template<class T> long read_float_samples( T*, long, int );
 	friend class Blip_Reader;
 };
 
 #include "blargg_config.h"
+#include "blargg_simd.h"
 
 // Number of bits in resample ratio fraction. Higher values give a more accurate ratio
 // but reduce maximum buffer size.
@@ -132,7 +161,7 @@ private:
 
 // Number bits in phase offset. Fewer than 6 bits (64 phase offsets) results in
 // noticeable broadband noise when synthesizing high frequency square waves.
-// Affects size of Blip_Synth objects since they store the waveform directly.
+// Affects size of the impulse kernels that Blip_Synth objects share.
 #ifndef BLIP_PHASE_BITS
 	#if BLIP_BUFFER_FAST
 		#define BLIP_PHASE_BITS 8
@@ -142,10 +171,14 @@ private:
 #endif
 
 	// Internal
+	#if (BLARGG_SIMD_SSE2 || BLARGG_SIMD_NEON) && !BLIP_BUFFER_FAST
+		#define BLIP_SYNTH_SIMD 1
+	#endif
 	typedef blip_ulong blip_resampled_time_t;
 	int const blip_widest_impulse_ = 16;
 	int const blip_buffer_extra_ = blip_widest_impulse_ + 2;
 	int const blip_res = 1 << BLIP_PHASE_BITS;
+	int const blip_step_offset_ = blip_widest_impulse_ / 2 - 1; // aligns blip_synth_fast steps with impulses
 	class blip_eq_t;
 
 	class Blip_Synth_Fast_ {
@@ -153,28 +186,45 @@ private:
 		Blip_Buffer* buf;
 		int last_amp;
 		int delta_factor;
+		float float_factor; // delta_factor for float_accum() buffers
 
 		void volume_unit( double );
 		Blip_Synth_Fast_();
 		void treble_eq( blip_eq_t const& ) { }
 	};
 
+	// Impulse kernel shared by all synths with the same width, equalization and
+	// volume shift
+	struct blip_kernel_t;
+
 	class Blip_Synth_ {
 	public:
 		Blip_Buffer* buf;
 		int last_amp;
 		int delta_factor;
+		int fast_delta_factor; // for blip_synth_fast
+		float float_factor;    // delta_factors for float_accum() buffers
+		float fast_float_factor;
 
 		void volume_unit( double );
-		Blip_Synth_( short* impulses, int width );
+		explicit Blip_Synth_( int width );
+		~Blip_Synth_();
 		void treble_eq( blip_eq_t const& );
+		template<int quality> void add_impulse( blip_long*, int phase, int delta ) const;
+		template<int quality> void add_impulse( float*, int phase, float delta ) const;
 	private:
+		typedef short imp_t;
 		double volume_unit_;
-		short* const impulses;
+		blip_kernel_t* kernel; // NULL until first set, or if kernel couldn't be allocated
+		short const* impulses;
+		short const* taps; // copy of impulses arranged as width taps per phase
 		int const width;
 		blip_long kernel_unit;
-		int impulses_size() const { return blip_res / 2 * width + 1; }
-		void adjust_impulse();
+		void set_kernel( blip_eq_t const&, int shift );
+		static blip_kernel_t* make_kernel( blip_eq_t const&, int width, int shift );
+
+		Blip_Synth_( const Blip_Synth_& ) = delete;
+		Blip_Synth_& operator=( const Blip_Synth_& ) = delete;
 	};
 
 // Quality level. Start with blip_good_quality.
@@ -182,6 +232,9 @@ const int blip_med_quality  = 8;
 const int blip_good_quality = 12;
 const int blip_high_quality = 16;
 
+// Synthesis quality that Blip_Synth uses for a buffer (see Blip_Buffer::set_synth_quality())
+enum { blip_synth_fast, blip_synth_normal, blip_synth_high };
+
 // Range specifies the greatest expected change in amplitude. Calculate it
 // by finding the difference between the maximum and minimum expected
 // amplitudes (max - min).
@@ -189,10 +242,10 @@ template<int quality,int range>
 class Blip_Synth {
 public:
 	// Set overall volume of waveform
-	void volume( double v ) { impl.volume_unit( v * (1.0 / (range < 0 ? -range : range)) ); }
+	void volume( double v );
 
 	// Configure low-pass filter (see blip_buffer.txt)
-	void treble_eq( blip_eq_t const& eq )       { impl.treble_eq( eq ); }
+	void treble_eq( blip_eq_t const& eq );
 
 	// Get/set Blip_Buffer used for output
 	Blip_Buffer* output() const                 { return impl.buf; }
@@ -225,11 +278,11 @@ private:
 #if BLIP_BUFFER_FAST
 	Blip_Synth_Fast_ impl;
 #else
+	// high is used instead of impl for buffers set to blip_synth_high
 	Blip_Synth_ impl;
-	typedef short imp_t;
-	imp_t impulses [blip_res * (quality / 2) + 1];
+	Blip_Synth_ high;
 public:
-	Blip_Synth() : impl( impulses, quality ) { }
+	Blip_Synth() : impl( quality ), high( blip_high_quality ) { }
 #endif
 
 	// disable broken defaulted constructors, Blip_Synth_ isn't safe to move/copy
@@ -259,6 +312,10 @@ private:
 
 int const blip_sample_bits = 30;
 
+// Scales a raw sample (see BLIP_READER_READ_RAW) to floating-point, where 1.0
+// corresponds to a full-scale 16-bit sample
+float const blip_float_unit = 1.0f / (1L << (blip_sample_bits - 1));
+
 // Dummy Blip_Buffer to direct sound output to, for easy muting without
 // having to stop sound code.
 class Silent_Blip_Buffer : public Blip_Buffer {
@@ -299,6 +356,9 @@ int const blip_reader_default_bass = 9;
 // Current raw sample in full internal resolution
 #define BLIP_READER_READ_RAW( name )    (name##_reader_accum)
 
+// Current sample as unclamped float (see blip_float_unit)
+#define BLIP_READER_READ_FLOAT( name )  ((float) name##_reader_accum * blip_float_unit)
+
 // Advance to next sample
 #define BLIP_READER_NEXT( name, bass ) \
 	(void) (name##_reader_accum += *name##_reader_buf++ - (name##_reader_accum >> (bass)))
@@ -308,6 +368,37 @@ int const blip_reader_default_bass = 9;
 #define BLIP_READER_END( name, blip_buffer ) \
 	(void) ((blip_buffer).reader_accum_ = name##_reader_accum)
 
+// Same as the above, for buffers using floating-point accumulation. Samples are
+// floating-point, where 1.0 corresponds to a full-scale 16-bit sample.
+#define BLIP_FLOAT_READER_BEGIN( name, blip_buffer ) \
+	const float* BLIP_RESTRICT name##_reader_buf = (blip_buffer).float_buffer_();\
+	float name##_reader_accum = (blip_buffer).reader_float_accum_
+
+#define BLIP_FLOAT_READER_BASS( blip_buffer ) \
+	(1.0f - 1.0f / (float) (1UL << (blip_buffer).bass_shift_))
+
+#define BLIP_FLOAT_READER_READ( name )   (name##_reader_accum)
+
+#define BLIP_FLOAT_READER_NEXT( name, bass ) \
+	(void) (name##_reader_accum = name##_reader_accum * (bass) + *name##_reader_buf++)
+
+// Flushes inaudible values to zero, since decaying ones would otherwise end up
+// as slow denormals
+#define BLIP_FLOAT_READER_END( name, blip_buffer ) \
+	(void) ((blip_buffer).reader_float_accum_ =\
+		(name##_reader_accum * name##_reader_accum < 1e-20f ? 0.0f : name##_reader_accum))
+
+// Converts floating-point sample to 16-bit, clamping it if necessary
+inline blip_sample_t blip_float_to_sample( float s )
+{
+	s *= 0x8000;
+	if ( s > blip_sample_max )
+		s = blip_sample_max;
+	if ( s < -0x8000 )
+		s = -0x8000;
+	return (blip_sample_t) s;
+}
+
 
 // Compatibility with older version
 const long blip_unscaled = 65535;
@@ -339,18 +430,62 @@ private:
 
 #include <assert.h>
 
-template<int quality,int range>
-inline void Blip_Synth<quality,range>::offset_resampled( blip_resampled_time_t time,
-		int delta, Blip_Buffer* blip_buf ) const
-{
-	// Fails if time is beyond end of Blip_Buffer, due to a bug in caller code or the
-	// need for a longer buffer as set by set_sample_rate().
-	assert( (blip_long) (time >> BLIP_BUFFER_ACCURACY) < blip_buf->buffer_size_ );
-	delta *= impl.delta_factor;
-	blip_long* BLIP_RESTRICT buf = blip_buf->buffer_ + (time >> BLIP_BUFFER_ACCURACY);
-	int phase = (int) (time >> (BLIP_BUFFER_ACCURACY - BLIP_PHASE_BITS) & (blip_res - 1));
+#if BLIP_SYNTH_SIMD
+	// Adds taps [i] * delta to out [i] for 4 or 8 taps, as 32-bit multiplies would
+	#if BLARGG_SIMD_SSE2
+		// SSE2 has no 32-bit multiply, so delta is split into signed 16-bit halves
+		struct blip_delta_t {
+			__m128i lo, hi;
+			blip_delta_t( blip_long delta )
+			{
+				short lo_ = (short) delta;
+				lo = _mm_set1_epi16( lo_ );
+				hi = _mm_set1_epi16( (short) (((blip_ulong) delta - (blip_ulong) (blip_long) lo_) >> 16) );
+			}
+		};
+
+		inline void blip_add_taps( blip_long* out, __m128i t, blip_delta_t const& d, int count )
+		{
+			__m128i const zero = _mm_setzero_si128();
+			__m128i lo = _mm_mullo_epi16( t, d.lo );
+			__m128i hi = _mm_mulhi_epi16( t, d.lo );
+			__m128i hh = _mm_mullo_epi16( t, d.hi );
+			__m128i* p = (__m128i*) out;
+			_mm_storeu_si128( p, _mm_add_epi32( _mm_loadu_si128( p ),
+					_mm_add_epi32( _mm_unpacklo_epi16( lo, hi ), _mm_unpacklo_epi16( zero, hh ) ) ) );
+			if ( count > 4 )
+				_mm_storeu_si128( p + 1, _mm_add_epi32( _mm_loadu_si128( p + 1 ),
+						_mm_add_epi32( _mm_unpackhi_epi16( lo, hi ), _mm_unpackhi_epi16( zero, hh ) ) ) );
+		}
 
-#if BLIP_BUFFER_FAST
+		inline void blip_add_taps8( blip_long* out, short const* taps, blip_delta_t const& d )
+		{
+			blip_add_taps( out, _mm_loadu_si128( (__m128i const*) taps ), d, 8 );
+		}
+
+		inline void blip_add_taps4( blip_long* out, short const* taps, blip_delta_t const& d )
+		{
+			blip_add_taps( out, _mm_loadl_epi64( (__m128i const*) taps ), d, 4 );
+		}
+	#else
+		typedef blip_long blip_delta_t;
+
+		inline void blip_add_taps4( blip_long* out, short const* taps, blip_delta_t d )
+		{
+			vst1q_s32( out, vmlaq_n_s32( vld1q_s32( out ), vmovl_s16( vld1_s16( taps ) ), d ) );
+		}
+
+		inline void blip_add_taps8( blip_long* out, short const* taps, blip_delta_t d )
+		{
+			blip_add_taps4( out,     taps,     d );
+			blip_add_taps4( out + 4, taps + 4, d );
+		}
+	#endif
+#endif
+
+// Adds step of delta at phase, interpolated linearly between two samples
+inline void blip_add_step( blip_long* buf, int phase, blip_long delta )
+{
 	blip_long left = buf [0] + delta;
 
 	// Kind of crappy, but doing shift after multiply results in overflow.
@@ -362,9 +497,38 @@ inline void Blip_Synth<quality,range>::offset_resampled( blip_resampled_time_t t
 
 	buf [0] = left;
 	buf [1] = right;
-#else
+}
+
+inline void blip_add_step( float* buf, int phase, float delta )
+{
+	float right = delta * (phase * (1.0f / blip_res));
+	buf [0] += delta - right;
+	buf [1] += right;
+}
+
+#if !BLIP_BUFFER_FAST
+
+template<int quality>
+inline void Blip_Synth_::add_impulse( blip_long* BLIP_RESTRICT buf, int phase, int delta ) const
+{
+	delta *= delta_factor;
 
 	int const fwd = (blip_widest_impulse_ - quality) / 2;
+
+	#if BLIP_SYNTH_SIMD
+
+	// taps for phase are contiguous, in the order they're added to buf
+	imp_t const* t = taps + phase * quality;
+	blip_long* out = buf + fwd;
+	blip_delta_t const d( delta );
+	blip_add_taps8( out, t, d );
+	if ( quality == 12 )
+		blip_add_taps4( out + 8, t + 8, d );
+	if ( quality == 16 )
+		blip_add_taps8( out + 8, t + 8, d );
+
+	#else
+
 	int const rev = fwd + quality - 2;
 	int const mid = quality / 2 - 1;
 
@@ -443,12 +607,86 @@ inline void Blip_Synth<quality,range>::offset_resampled( blip_resampled_time_t t
 		buf [rev + 1] = t1;
 	#endif
 
+	#endif
+}
+
+template<int quality>
+inline void Blip_Synth_::add_impulse( float* BLIP_RESTRICT buf, int phase, float delta ) const
+{
+	imp_t const* BLIP_RESTRICT t = taps + phase * quality;
+	buf += (blip_widest_impulse_ - quality) / 2;
+	for ( int i = 0; i < quality; i++ )
+		buf [i] += t [i] * delta;
+}
+
+#endif
+
+template<int quality,int range>
+inline void Blip_Synth<quality,range>::offset_resampled( blip_resampled_time_t time,
+		int delta, Blip_Buffer* blip_buf ) const
+{
+	// Fails if time is beyond end of Blip_Buffer, due to a bug in caller code or the
+	// need for a longer buffer as set by set_sample_rate().
+	assert( (blip_long) (time >> BLIP_BUFFER_ACCURACY) < blip_buf->buffer_size_ );
+	#if GME_STATS
+		blip_buf->offset_count_++;
+	#endif
+	long const pos = (long) (time >> BLIP_BUFFER_ACCURACY);
+	int phase = (int) (time >> (BLIP_BUFFER_ACCURACY - BLIP_PHASE_BITS) & (blip_res - 1));
+
+#if BLIP_BUFFER_FAST
+	if ( !blip_buf->float_accum() )
+		blip_add_step( blip_buf->buffer_ + pos, phase, delta * impl.delta_factor );
+	else
+		blip_add_step( blip_buf->float_buffer_() + pos, phase, delta * impl.float_factor );
+#else
+	// each quality has its own instance, so taps are unrolled
+	int const synth_quality = blip_buf->synth_quality();
+	if ( !blip_buf->float_accum() )
+	{
+		blip_long* buf = blip_buf->buffer_ + pos;
+		if ( synth_quality == blip_synth_normal )
+			impl.add_impulse<quality>( buf, phase, delta );
+		else if ( synth_quality == blip_synth_fast )
+			blip_add_step( buf + blip_step_offset_, phase, delta * impl.fast_delta_factor );
+		else
+			high.add_impulse<blip_high_quality>( buf, phase, delta );
+	}
+	else
+	{
+		float* buf = blip_buf->float_buffer_() + pos;
+		if ( synth_quality == blip_synth_normal )
+			impl.add_impulse<quality>( buf, phase, delta * impl.float_factor );
+		else if ( synth_quality == blip_synth_fast )
+			blip_add_step( buf + blip_step_offset_, phase, delta * impl.fast_float_factor );
+		else
+			high.add_impulse<blip_high_quality>( buf, phase, delta * high.float_factor );
+	}
 #endif
 }
 
 #undef BLIP_FWD
 #undef BLIP_REV
 
+template<int quality,int range>
+void Blip_Synth<quality,range>::volume( double v )
+{
+	double unit = v * (1.0 / (range < 0 ? -range : range));
+	impl.volume_unit( unit );
+	#if !BLIP_BUFFER_FAST
+		high.volume_unit( unit );
+	#endif
+}
+
+template<int quality,int range>
+void Blip_Synth<quality,range>::treble_eq( blip_eq_t const& eq )
+{
+	impl.treble_eq( eq );
+	#if !BLIP_BUFFER_FAST
+		high.treble_eq( eq );
+	#endif
+}
+
 template<int quality,int range>
 #if BLIP_BUFFER_FAST
 	inline
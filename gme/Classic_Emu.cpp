@@ -4,6 +4,7 @@
 
 #include "Multi_Buffer.h"
 #include <string.h>
+#include <algorithm>
 
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
@@ -18,6 +19,9 @@ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA */
 
 #include "blargg_source.h"
 
+using std::min;
+using std::max;
+
 Classic_Emu::Classic_Emu()
 {
 	buf           = 0;
@@ -28,6 +32,9 @@ Classic_Emu::Classic_Emu()
 	blaarg_static_assert( (int) wave_type  == (int) Multi_Buffer::wave_type, "wave_type inconsistent across two classes using it" );
 	blaarg_static_assert( (int) noise_type == (int) Multi_Buffer::noise_type, "noise_type inconsistent across two classes using it"  );
 	blaarg_static_assert( (int) mixed_type == (int) Multi_Buffer::mixed_type, "mixed_type inconsistent across two classes using it"  );
+	blaarg_static_assert( (int) gme_quality_fast   == (int) blip_synth_fast,   "quality levels inconsistent between gme.h and Blip_Buffer.h" );
+	blaarg_static_assert( (int) gme_quality_normal == (int) blip_synth_normal, "quality levels inconsistent between gme.h and Blip_Buffer.h" );
+	blaarg_static_assert( (int) gme_quality_high   == (int) blip_synth_high,   "quality levels inconsistent between gme.h and Blip_Buffer.h" );
 }
 
 Classic_Emu::~Classic_Emu()
@@ -79,6 +86,27 @@ void Classic_Emu::mute_voices_( int mask )
 	}
 }
 
+void Classic_Emu::set_quality_( int q )
+{
+	Music_Emu::set_quality_( q );
+	if ( buf )
+		update_quality();
+}
+
+void Classic_Emu::update_quality()
+{
+	for ( int i = voice_count(); i--; )
+	{
+		Multi_Buffer::channel_t ch = buf->channel( i, (voice_types ? voice_types [i] : 0) );
+		if ( ch.center )
+		{
+			ch.center->set_synth_quality( quality() );
+			ch.left  ->set_synth_quality( quality() );
+			ch.right ->set_synth_quality( quality() );
+		}
+	}
+}
+
 void Classic_Emu::change_clock_rate( uint32_t rate )
 {
 	clock_rate_ = rate;
@@ -90,6 +118,7 @@ blargg_err_t Classic_Emu::setup_buffer( uint32_t rate )
 	change_clock_rate( rate );
 	RETURN_ERR( buf->set_channel_count( voice_count() ) );
 	set_equalizer( equalizer() );
+	update_quality();
 	buf_changed_count = buf->channels_changed_count();
 	return 0;
 }
@@ -101,20 +130,65 @@ blargg_err_t Classic_Emu::start_track_( int track )
 	return 0;
 }
 
+void Classic_Emu::copy_state_( Emu_State& s )
+{
+	Music_Emu::copy_state_( s );
+	buf->copy_state( s );
+}
+
+void Classic_Emu::get_stats_( stats_t* out ) const
+{
+	if ( buf )
+		buf->get_stats( out );
+}
+
+static long read_buf( Multi_Buffer* buf, blip_sample_t* out, long count )
+{
+	return buf->read_samples( out, count );
+}
+
+static long read_buf( Multi_Buffer* buf, float* out, long count )
+{
+	return buf->read_samples_float( out, count );
+}
+
 blargg_err_t Classic_Emu::play_( long count, sample_t* out )
+{
+	buf->set_float_accum( false );
+	return play_samples( count, out );
+}
+
+blargg_err_t Classic_Emu::play_float_( long count, float* out )
+{
+	// accumulate in floating-point so that loud output can't overflow before
+	// reaching the caller
+	buf->set_float_accum( true );
+	return play_samples( count, out );
+}
+
+template<class T>
+blargg_err_t Classic_Emu::play_samples( long count, T* out )
 {
 	long remain = count;
 	while ( remain )
 	{
-		remain -= buf->read_samples( &out [count - remain], remain );
+		remain -= read_buf( buf, &out [count - remain], remain );
 		if ( remain )
 		{
 			if ( buf_changed_count != buf->channels_changed_count() )
 			{
 				buf_changed_count = buf->channels_changed_count();
+				update_quality();
 				remute_voices();
 			}
 			int msec = buf->length();
+			if ( low_latency() )
+			{
+				// only run long enough for the samples still needed
+				long frames = remain / out_channels();
+				msec = min( msec, (int) ((frames * 1000 + sample_rate() - 1) / sample_rate()) );
+				msec = max( msec, 1 );
+			}
 			blip_time_t clocks_emulated = (int32_t) msec * clock_rate_ / 1000;
 			RETURN_ERR( run_clocks( clocks_emulated, msec ) );
 			assert( clocks_emulated );
@@ -124,6 +198,41 @@ blargg_err_t Classic_Emu::play_( long count, sample_t* out )
 	return 0;
 }
 
+blargg_err_t Classic_Emu::skip_( long count )
+{
+	// for long skip, run emulator with all voices muted and discard each frame,
+	// rather than mixing and reading it
+	int const units = out_channels() / 2; // samples_avail() counts stereo samples
+	if ( count > skip_threshold && count - buf->samples_avail() * units > skip_threshold / 2 )
+	{
+		mute_voices_( ~0 );
+
+		// drop sound from before skip; clear() would also reset buffer offset
+		// and integrator, so sound after skip wouldn't match normal play
+		count -= buf->samples_avail() * units;
+		buf->remove_samples( buf->samples_avail() );
+
+		while ( !emu_track_ended() )
+		{
+			int msec = buf->length();
+			blip_time_t clocks_emulated = (int32_t) msec * clock_rate_ / 1000;
+			RETURN_ERR( run_clocks( clocks_emulated, msec ) );
+			assert( clocks_emulated );
+			buf->end_frame( clocks_emulated );
+
+			long n = buf->samples_avail() * units;
+			if ( count - n <= skip_threshold / 2 )
+				break; // rest is played normally
+			count -= n;
+			buf->remove_samples( n );
+		}
+
+		remute_voices();
+	}
+
+	return Music_Emu::skip_( count );
+}
+
 // Rom_Data
 
 blargg_err_t Rom_Data_::load_rom_data_( Data_Reader& in,
@@ -134,7 +243,7 @@ blargg_err_t Rom_Data_::load_rom_data_( Data_Reader& in,
 	rom_addr = 0;
 	mask     = 0;
 	size_    = 0;
-	rom.clear();
+	clear_();
 
 	file_size_ = in.remain();
 	if ( file_size_ <= header_size ) // <= because there must be data after header
@@ -153,11 +262,68 @@ blargg_err_t Rom_Data_::load_rom_data_( Data_Reader& in,
 
 	memset( rom.begin()         , fill, pad_size );
 	memset( rom.end() - pad_size, fill, pad_size );
+	rom_size_ = rom.size();
 
 	return 0;
 }
 
-void Rom_Data_::set_addr_( long addr, int unit )
+blargg_err_t Rom_Data_::load_rom_data_( byte const* in, long size,
+		int header_size, void* header_out, int fill, long pad_size )
+{
+	rom_addr = 0;
+	mask     = 0;
+	size_    = 0;
+	clear_();
+
+	if ( size <= header_size ) // <= because there must be data after header
+		return gme_wrong_file_type;
+
+	memcpy( header_out, in, header_size );
+	borrowed   = in + header_size;
+	file_size_ = size - header_size;
+	fill_      = fill;
+	rom_size_  = pad_size + file_size_ + pad_size;
+	blargg_err_t err = copy_borrowed_ends( pad_size );
+	if ( err )
+		clear_();
+	return err;
+}
+
+// Copies pages that extend past either end of borrowed data into rom and tail,
+// with padding filled in, as it would have been laid out in rom.
+blargg_err_t Rom_Data_::copy_borrowed_ends( long pad_size )
+{
+	long const data_end = pad_size + file_size_;
+
+	// rom holds any page beginning before data
+	long head_size = min( rom_size_, pad_size + pad_size );
+	RETURN_ERR( rom.resize( head_size ) );
+	memset( rom.begin(), fill_, head_size );
+	memcpy( rom.begin() + pad_size, borrowed, min( head_size, data_end ) - pad_size );
+
+	// tail holds any page ending after data
+	tail_offset = max( data_end - pad_size, 0L );
+	RETURN_ERR( tail.resize( rom_size_ - tail_offset ) );
+	memset( tail.begin(), fill_, tail.size() );
+	long copy_begin = max( tail_offset, (long) pad_size );
+	memcpy( tail.begin() + (copy_begin - tail_offset), borrowed + (copy_begin - pad_size),
+			data_end - copy_begin );
+
+	return 0;
+}
+
+unsigned char* Rom_Data_::borrowed_at( uint32_t offset, long pad_size )
+{
+	if ( offset < (uint32_t) pad_size )
+		return &rom [offset];
+
+	if ( (long) offset > file_size_ )
+		return &tail [offset - tail_offset];
+
+	return (byte*) borrowed + (offset - pad_size);
+}
+
+blargg_err_t Rom_Data_::set_addr_( long addr, int unit )
 {
 	rom_addr = addr - unit - pad_extra;
 
@@ -178,7 +344,24 @@ void Rom_Data_::set_addr_( long addr, int unit )
 	if ( addr < 0 )
 		addr = 0;
 	size_ = rounded;
-	if ( rom.resize( rounded - rom_addr + pad_extra ) ) { } // OK if shrink fails
+	rom_size_ = rounded - rom_addr + pad_extra;
+	if ( borrowed )
+	{
+		blargg_err_t err = copy_borrowed_ends( unit + pad_extra );
+		if ( err )
+		{
+			// leave nothing mapped, as copying path does when rom is empty
+			clear_();
+			rom_size_  = 0;
+			file_size_ = 0;
+			return err;
+		}
+	}
+	else
+	{
+		if ( rom.resize( rom_size_ ) ) { } // OK if shrink fails
+		rom_size_ = rom.size();
+	}
 
 	if ( 0 )
 	{
@@ -187,4 +370,5 @@ void Rom_Data_::set_addr_( long addr, int unit )
 		debug_printf( "rounded: %ld\n", rounded );
 		debug_printf( "mask: $%X\n", mask );
 	}
+	return 0;
 }
@@ -32,13 +32,20 @@ protected:
 	blargg_err_t set_sample_rate_( long sample_rate ) override;
 	void mute_voices_( int ) override;
 	void set_equalizer_( equalizer_t const& ) override;
+	void set_quality_( int ) override;
 	blargg_err_t play_( long, sample_t* ) override;
+	blargg_err_t play_float_( long, float* ) override;
+	blargg_err_t skip_( long ) override;
+	void copy_state_( Emu_State& ) override;
+	void get_stats_( stats_t* ) const override;
 private:
 	Multi_Buffer* buf;
 	Multi_Buffer* stereo_buffer; // NULL if using custom buffer
 	uint32_t clock_rate_;
 	unsigned buf_changed_count;
 	int const* voice_types;
+	template<class T> blargg_err_t play_samples( long, T* );
+	void update_quality();
 };
 
 inline void Classic_Emu::set_buffer( Multi_Buffer* new_buf )
@@ -50,21 +57,34 @@ inline void Classic_Emu::set_buffer( Multi_Buffer* new_buf )
 // ROM data handler, used by several Classic_Emu derivitives. Loads file data
 // with padding on both sides, allowing direct use in bank mapping. The main purpose
 // is to allow all file data to be loaded with only one read() call (for efficiency).
+// Data already in memory can instead be used in place, where only the pages at
+// each end are copied, with padding.
 
 class Rom_Data_ {
 public:
 	typedef unsigned char byte;
 protected:
 	enum { pad_extra = 8 };
-	blargg_vector<byte> rom;
+	blargg_vector<byte> rom;  // if borrowed, holds only pages before end of first page of data
+	blargg_vector<byte> tail; // if borrowed, pages after beginning of last page of data
+	byte const* borrowed;     // data in caller's memory, or NULL if in rom
 	long file_size_;
+	long rom_size_;           // size of rom if it weren't borrowed
+	long tail_offset;
 	int32_t rom_addr;
 	int32_t mask;
 	int32_t size_; // TODO: eliminate
+	int fill_;
 
+	Rom_Data_() : borrowed( 0 ) { }
 	blargg_err_t load_rom_data_( Data_Reader& in, int header_size, void* header_out,
 			int fill, long pad_size );
-	void set_addr_( long addr, int unit );
+	blargg_err_t load_rom_data_( byte const* in, long size, int header_size,
+			void* header_out, int fill, long pad_size );
+	blargg_err_t set_addr_( long addr, int unit );
+	byte* borrowed_at( uint32_t offset, long pad_size );
+	blargg_err_t copy_borrowed_ends( long pad_size );
+	void clear_() { rom.clear(); tail.clear(); borrowed = 0; }
 };
 
 template<int unit>
@@ -78,17 +98,25 @@ public:
 		return load_rom_data_( in, header_size, header_out, fill, pad_size );
 	}
 
+	// Same as load(), but uses data in place rather than copying it, so it must
+	// remain valid until clear() or another load.
+	blargg_err_t load( void const* in, long size, int header_size, void* header_out, int fill )
+	{
+		return load_rom_data_( (byte const*) in, size, header_size, header_out, fill, pad_size );
+	}
+
 	// Size of file data read in (excluding header)
 	long file_size() const { return file_size_; }
 
-	// Pointer to beginning of file data
-	byte* begin() const { return rom.begin() + pad_size; }
+	// Pointer to beginning of file data. Must not be modified.
+	byte* begin() const { return borrowed ? (byte*) borrowed : rom.begin() + pad_size; }
 
-	// Set address that file data should start at
-	void set_addr( long addr ) { set_addr_( addr, unit ); }
+	// Set address that file data should start at. If data is used in place, fails
+	// if pages extending past its ends can't be allocated, leaving nothing mapped.
+	blargg_err_t set_addr( long addr ) { return set_addr_( addr, unit ); }
 
 	// Free data
-	void clear() { rom.clear(); }
+	void clear() { clear_(); }
 
 	// Size of data + start addr, rounded to a multiple of unit
 	long size() const { return size_; }
@@ -109,8 +137,10 @@ public:
 	byte* at_addr( int32_t addr )
 	{
 		uint32_t offset = mask_addr( addr ) - rom_addr;
-		if ( offset > uint32_t (rom.size() - pad_size) )
+		if ( offset > uint32_t (rom_size_ - pad_size) )
 			offset = 0; // unmapped
+		if ( borrowed )
+			return borrowed_at( offset, pad_size );
 		return &rom [offset];
 	}
 };
@@ -28,6 +28,13 @@ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA */
 static const unsigned char gz_magic[2] = {0x1f, 0x8b}; /* gzip magic header */
 #endif /* HAVE_ZLIB_H */
 
+#if HAVE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using std::min;
 using std::max;
 
@@ -173,7 +180,7 @@ Mem_File_Reader::Mem_File_Reader( const void* p, long s ) :
 Mem_File_Reader::~Mem_File_Reader()
 {
 	if ( m_ownedPtr )
-		free( const_cast<char*>( m_begin ) ); // see gz_compress for the malloc
+		blargg_free( const_cast<char*>( m_begin ) ); // see gz_compress for the allocation
 }
 #endif
 
@@ -214,8 +221,8 @@ bool Mem_File_Reader::gz_decompress()
 	const vec_size full_length = static_cast<vec_size>( m_size );
 	const vec_size half_length = static_cast<vec_size>( m_size / 2 );
 
-	// We use malloc/friends here so we can realloc to grow buffer if needed
-	char *raw_data = reinterpret_cast<char *> ( malloc( full_length ) );
+	// We use blargg_realloc here so we can grow buffer if needed
+	char *raw_data = reinterpret_cast<char *> ( blargg_realloc( NULL, full_length ) );
 	size_t raw_data_size = full_length;
 	if ( !raw_data )
 		return false;
@@ -233,7 +240,7 @@ bool Mem_File_Reader::gz_decompress()
 	// header.
 	if ( inflateInit2(&strm, (16 + MAX_WBITS)) != Z_OK )
 	{
-		free( raw_data );
+		blargg_free( raw_data );
 		return false;
 	}
 
@@ -243,7 +250,7 @@ bool Mem_File_Reader::gz_decompress()
 		if ( strm.total_out >= raw_data_size )
 		{
 			raw_data_size += half_length;
-			raw_data = reinterpret_cast<char *>( realloc( raw_data, raw_data_size ) );
+			raw_data = reinterpret_cast<char *>( blargg_realloc( raw_data, raw_data_size ) );
 			if ( !raw_data ) {
 				return false;
 			}
@@ -262,7 +269,7 @@ bool Mem_File_Reader::gz_decompress()
 
 	if ( inflateEnd(&strm) != Z_OK )
 	{
-		free( raw_data );
+		blargg_free( raw_data );
 		return false;
 	}
 
@@ -455,3 +462,76 @@ void Std_File_Reader::close()
 		file_ = nullptr;
 	}
 }
+
+// Mapped_File_Reader
+
+Mapped_File_Reader::Mapped_File_Reader() :
+	begin_( nullptr ),
+	size_( 0 ),
+	pos_( 0 )
+{ }
+
+Mapped_File_Reader::~Mapped_File_Reader() { close(); }
+
+blargg_err_t Mapped_File_Reader::open( const char* path )
+{
+	close();
+#if HAVE_MMAP
+	int fd = ::open( path, O_RDONLY );
+	if ( fd < 0 )
+		return "Couldn't open file";
+
+	// only regular files have a fixed size; pipes, devices and files such as
+	// those in /proc must be read
+	void* p = MAP_FAILED;
+	struct stat st;
+	if ( !fstat( fd, &st ) && S_ISREG( st.st_mode ) && st.st_size > 0 && st.st_size <= LONG_MAX )
+		p = mmap( nullptr, static_cast<size_t>( st.st_size ), PROT_READ, MAP_SHARED, fd, 0 );
+	::close( fd ); // mapping stays valid
+
+	if ( p == MAP_FAILED )
+		return "Couldn't map file";
+
+	begin_ = p;
+	size_  = static_cast<long>( st.st_size );
+	pos_   = 0;
+	return nullptr;
+#else
+	(void) path;
+	return "Memory-mapped files not supported";
+#endif
+}
+
+void Mapped_File_Reader::close()
+{
+#if HAVE_MMAP
+	if ( begin_ )
+		munmap( begin_, static_cast<size_t>( size_ ) );
+#endif
+	begin_ = nullptr;
+	size_  = 0;
+	pos_   = 0;
+}
+
+long Mapped_File_Reader::size() const { return size_; }
+
+long Mapped_File_Reader::read_avail( void* p, long s )
+{
+	long r = size_ - pos_;
+	if ( s > r || s < 0 )
+		s = r;
+	memcpy( p, static_cast<char const*>( begin_ ) + pos_, static_cast<size_t>(s) );
+	pos_ += s;
+	return s;
+}
+
+long Mapped_File_Reader::tell() const { return pos_; }
+
+blargg_err_t Mapped_File_Reader::seek( long n )
+{
+	RETURN_VALIDITY_CHECK( n >= 0 );
+	if ( n > size_ )
+		return eof_error;
+	pos_ = n;
+	return nullptr;
+}
@@ -10,6 +10,11 @@
 #include <zlib.h>
 #endif
 
+// HAVE_MMAP: define as 0 to disable memory-mapping of files on POSIX systems
+#if !defined (HAVE_MMAP) && (defined (__unix__) || defined (__APPLE__))
+	#define HAVE_MMAP 1
+#endif
+
 // Supports reading and finding out how many bytes are remaining
 class Data_Reader {
 public:
@@ -75,6 +80,32 @@ private:
 #endif /* HAVE_ZLIB_H */
 };
 
+// Disk file reader that maps file into memory rather than reading it, so that its
+// pages are read only when accessed and are shared with other processes. Doesn't
+// decompress files. Truncating the file while it's mapped makes accessing the lost
+// pages raise SIGBUS. open() fails if HAVE_MMAP isn't set or file isn't a regular
+// file, so caller can fall back to Std_File_Reader.
+class Mapped_File_Reader : public File_Reader {
+public:
+	blargg_err_t open( const char* path );
+	void close();
+
+	// Contents of file, valid until close()
+	void const* data() const { return begin_; }
+
+public:
+	Mapped_File_Reader();
+	~Mapped_File_Reader();
+	long size() const;
+	long read_avail( void*, long );
+	long tell() const;
+	blargg_err_t seek( long );
+private:
+	void* begin_;
+	long size_;
+	long pos_;
+};
+
 // Treats range of memory as a file
 class Mem_File_Reader : public File_Reader {
 public:
@@ -2,6 +2,8 @@
 
 #include "Dual_Resampler.h"
 
+#include "Emu_State.h"
+#include "gme.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -22,7 +24,9 @@ Dual_Resampler::Dual_Resampler() :
 	sample_buf_size(0),
 	oversamples_per_frame(-1),
 	buf_pos(-1),
-	resampler_size(0)
+	resampler_size(0),
+	float_frame(false),
+	resampler(12)
 {
 }
 
@@ -32,6 +36,7 @@ blargg_err_t Dual_Resampler::reset( int pairs )
 {
 	// expand allocations a bit
 	RETURN_ERR( sample_buf.resize( (pairs + (pairs >> 2)) * 2 ) );
+	RETURN_ERR( float_buf.resize( sample_buf.size() ) );
 	resize( pairs );
 	resampler_size = oversamples_per_frame + (oversamples_per_frame >> 2);
 	return resampler.buffer_size( resampler_size );
@@ -53,7 +58,14 @@ void Dual_Resampler::resize( int pairs )
 	}
 }
 
-void Dual_Resampler::play_frame_( Blip_Buffer& blip_buf, dsample_t* out )
+void Dual_Resampler::set_resampler_quality( int q )
+{
+	static int const widths [3] = { 8, 12, 24 }; // fast, normal, high
+	resampler.set_width( widths [q] );
+}
+
+template<class T>
+void Dual_Resampler::play_frame_( Blip_Buffer& blip_buf, T* out )
 {
 	long pair_count = sample_buf_size >> 1;
 	blip_time_t blip_time = blip_buf.count_clocks( pair_count );
@@ -68,9 +80,9 @@ void Dual_Resampler::play_frame_( Blip_Buffer& blip_buf, dsample_t* out )
 	resampler.write( new_count );
 
 #ifdef	NDEBUG // Avoid warning when asserts are disabled
-	resampler.read( sample_buf.begin(), sample_buf_size );
+	resampler.read( frame_buf( out ), sample_buf_size );
 #else
-	long count = resampler.read( sample_buf.begin(), sample_buf_size );
+	long count = resampler.read( frame_buf( out ), sample_buf_size );
 	assert( count == (long) sample_buf_size );
 #endif
 
@@ -79,15 +91,48 @@ void Dual_Resampler::play_frame_( Blip_Buffer& blip_buf, dsample_t* out )
 }
 
 void Dual_Resampler::dual_play( long count, dsample_t* out, Blip_Buffer& blip_buf )
+{
+	dual_play_( count, out, blip_buf );
+}
+
+void Dual_Resampler::dual_play( long count, float* out, Blip_Buffer& blip_buf )
+{
+	dual_play_( count, out, blip_buf );
+}
+
+// Converts unread part of last frame to format of other buffer
+void Dual_Resampler::convert_frame()
+{
+	for ( int i = buf_pos; i < sample_buf_size; i++ )
+	{
+		if ( float_frame )
+		{
+			int32_t s = (int32_t) (float_buf [i] * 0x8000);
+			if ( (int16_t) s != s )
+				s = 0x7FFF - (s >> 24);
+			sample_buf [i] = (dsample_t) s;
+		}
+		else
+		{
+			float_buf [i] = sample_buf [i] * (1.0f / 0x8000);
+		}
+	}
+	float_frame = !float_frame;
+}
+
+template<class T>
+void Dual_Resampler::dual_play_( long count, T* out, Blip_Buffer& blip_buf )
 {
 	// empty extra buffer
 	long remain = sample_buf_size - buf_pos;
 	if ( remain )
 	{
+		if ( float_frame != is_float( out ) )
+			convert_frame();
 		if ( remain > count )
 			remain = count;
 		count -= remain;
-		memcpy( out, &sample_buf [buf_pos], remain * sizeof *out );
+		memcpy( out, &frame_buf( out ) [buf_pos], remain * sizeof *out );
 		out += remain;
 		buf_pos += remain;
 	}
@@ -103,13 +148,55 @@ void Dual_Resampler::dual_play( long count, dsample_t* out, Blip_Buffer& blip_bu
 	// extra
 	if ( count )
 	{
-		play_frame_( blip_buf, sample_buf.begin() );
+		T* buf = frame_buf( out );
+		play_frame_( blip_buf, buf );
+		float_frame = is_float( out );
 		buf_pos = count;
-		memcpy( out, sample_buf.begin(), count * sizeof *out );
+		memcpy( out, buf, count * sizeof *out );
 		out += count;
 	}
 }
 
+long Dual_Resampler::skip_frame( Blip_Buffer& blip_buf )
+{
+	long remain = sample_buf_size - buf_pos;
+	if ( remain )
+	{
+		buf_pos = sample_buf_size;
+		return remain;
+	}
+
+	// same timing as play_frame_(), so skipping doesn't shift FM relative to PSG
+	long pair_count = sample_buf_size >> 1;
+	blip_time_t blip_time = blip_buf.count_clocks( pair_count );
+	int sample_count = oversamples_per_frame - resampler.written();
+	resampler.write( play_frame( blip_time, sample_count, resampler.buffer() ) );
+	resampler.skip_output( sample_buf_size );
+	blip_buf.end_frame( blip_time );
+	blip_buf.remove_samples( pair_count );
+	return sample_buf_size;
+}
+
+void Dual_Resampler::copy_state( Emu_State& s )
+{
+	s.copy_count( buf_pos, sample_buf_size );
+	s( float_frame );
+	int remain = sample_buf_size - buf_pos;
+	if ( float_frame )
+		s.copy( &float_buf [buf_pos], remain * sizeof float_buf [0] );
+	else
+		s.copy( &sample_buf [buf_pos], remain * sizeof sample_buf [0] );
+	resampler.copy_state( s );
+}
+
+void Dual_Resampler::get_stats( gme_stats_t* out, Blip_Buffer const& blip_buf ) const
+{
+	out->resampler_in  += resampler.input_count();
+	out->resampler_out += resampler.output_count();
+	out->synth_offsets += blip_buf.offset_count_;
+	out->blip_samples  += blip_buf.read_count_;
+}
+
 void Dual_Resampler::mix_samples( Blip_Buffer& blip_buf, dsample_t* out )
 {
 	Blip_Reader sn;
@@ -137,3 +224,21 @@ void Dual_Resampler::mix_samples( Blip_Buffer& blip_buf, dsample_t* out )
 	sn.end( blip_buf );
 }
 
+void Dual_Resampler::mix_samples( Blip_Buffer& blip_buf, float* out )
+{
+	int const bass = BLIP_READER_BASS( blip_buf );
+	BLIP_READER_BEGIN( sn, blip_buf );
+	const float* in = float_buf.begin();
+
+	for ( int n = sample_buf_size >> 1; n--; )
+	{
+		float s = BLIP_READER_READ_FLOAT( sn );
+		BLIP_READER_NEXT( sn, bass );
+		out [0] = in [0] * 2 + s;
+		out [1] = in [1] * 2 + s;
+		in += 2;
+		out += 2;
+	}
+
+	BLIP_READER_END( sn, blip_buf );
+}
@@ -7,6 +7,8 @@
 #include "Fir_Resampler.h"
 #include "Blip_Buffer.h"
 
+struct gme_stats_t;
+
 class Dual_Resampler {
 public:
 	Dual_Resampler();
@@ -19,21 +21,49 @@ public:
 	void resize( int pairs_per_frame );
 	void clear();
 
+	// Set width of resampling filter for a gme_quality_* level. Clears resampler
+	// input.
+	void set_resampler_quality( int );
+
 	void dual_play( long count, dsample_t* out, Blip_Buffer& );
 
+	// Same as dual_play(), but writes unclamped floating-point samples, where 1.0
+	// corresponds to a full-scale 16-bit sample
+	void dual_play( long count, float* out, Blip_Buffer& );
+
+	// Discards unread part of current frame, or if there is none, runs play_frame()
+	// for a new frame without resampling or mixing. Returns number of samples skipped.
+	long skip_frame( Blip_Buffer& );
+
+	// Save/load unread samples and resampler input, for emulator state
+	void copy_state( Emu_State& );
+
+	// Add counters of resampler and Blip_Buffer to *out, for emulator statistics
+	void get_stats( gme_stats_t* out, Blip_Buffer const& ) const;
+
 protected:
 	virtual int play_frame( blip_time_t, int pcm_count, dsample_t* pcm_out ) = 0;
 private:
 
 	blargg_vector<dsample_t> sample_buf;
+	blargg_vector<float> float_buf;
 	int sample_buf_size;
 	int oversamples_per_frame;
 	int buf_pos;
 	int resampler_size;
+	bool float_frame; // unread part of last frame is in float_buf rather than sample_buf
 
-	Fir_Resampler<12> resampler;
+	Fir_Resampler<24> resampler;
 	void mix_samples( Blip_Buffer&, dsample_t* );
-	void play_frame_( Blip_Buffer&, dsample_t* );
+	void mix_samples( Blip_Buffer&, float* );
+	template<class T> void dual_play_( long count, T* out, Blip_Buffer& );
+	template<class T> void play_frame_( Blip_Buffer&, T* );
+	void convert_frame();
+
+	dsample_t* frame_buf( dsample_t* ) { return sample_buf.begin(); }
+	float*     frame_buf( float* )     { return float_buf.begin(); }
+	static bool is_float( dsample_t* ) { return false; }
+	static bool is_float( float* )     { return true; }
 };
 
 inline double Dual_Resampler::setup( double oversample, double rolloff, double gain )
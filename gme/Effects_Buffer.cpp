@@ -2,6 +2,8 @@
 
 #include "Effects_Buffer.h"
 
+#include "Emu_State.h"
+#include "gme.h"
 #include <string.h>
 #include <algorithm>
 
@@ -147,6 +149,38 @@ void Effects_Buffer::clear()
 		bufs [i].clear();
 }
 
+void Effects_Buffer::copy_state( Emu_State& s )
+{
+	s( stereo_remain );
+	s( effect_remain );
+
+	for ( int i = 0; i < max_voices; i++ )
+	{
+		if ( echo_buf [i].size() )
+			s.copy( &echo_buf [i] [0], echo_size * sizeof echo_buf [i] [0] );
+
+		if ( reverb_buf [i].size() )
+			s.copy( &reverb_buf [i] [0], reverb_size * sizeof reverb_buf [i] [0] );
+
+		s.copy_count( echo_pos [i], echo_size - 1 );
+		s.copy_count( reverb_pos [i], reverb_size - 1 );
+	}
+
+	for ( int i = 0; i < buf_count; i++ )
+		bufs [i].copy_state( s );
+}
+
+void Effects_Buffer::set_float_accum( bool b )
+{
+	for ( int i = 0; i < buf_count; i++ )
+		bufs [i].set_float_accum( b );
+}
+
+void Effects_Buffer::get_stats( gme_stats_t* out ) const
+{
+	add_stats( out, &bufs [0], buf_count );
+}
+
 inline int pin_range( int n, int max, int min = 0 )
 {
 	if ( n < min )
@@ -291,7 +325,81 @@ long Effects_Buffer::samples_avail() const
 	return bufs [0].samples_avail() * 2;
 }
 
+
+// Effects are mixed at 16-bit scale; only the final store depends on output type
+static inline void store_sample( blip_sample_t& out, int s )
+{
+	if ( (int16_t) s != s )
+		s = 0x7FFF - (s >> 24);
+	out = (blip_sample_t) s;
+}
+
+static inline void store_sample( float& out, int s ) { out = s * (1.0f / 0x8000); }
+
+static inline void store_sample( blip_sample_t& out, float s )
+{
+	out = blip_float_to_sample( s * (1.0f / 0x8000) );
+}
+
+static inline void store_sample( float& out, float s ) { out = s * (1.0f / 0x8000); }
+
+static inline int fmul( int x, fixed_t y ) { return FMUL( x, y ); }
+
+static inline float fmul( float x, fixed_t y ) { return x * (float) y * (1.0f / 0x8000); }
+
+// Echo and reverb history is kept at 16 bits for either kind of buffer
+static inline blip_sample_t to_delay_sample( int s ) { return (blip_sample_t) s; }
+
+static inline blip_sample_t to_delay_sample( float s )
+{
+	return blip_float_to_sample( s * (1.0f / 0x8000) );
+}
+
+// Lets the mixers read either kind of Blip_Buffer. Both give samples at 16-bit
+// scale, so the effects are the same for either; float_reader's are unclamped
+// and keep their fractional part.
+struct fixed_reader {
+	typedef int sample_t;
+	typedef int bass_t;
+	static bass_t bass( Blip_Buffer const& b ) { return BLIP_READER_BASS( b ); }
+	explicit fixed_reader( Blip_Buffer const& b ) : buf( b.buffer_ ), accum( b.reader_accum_ ) { }
+	sample_t read() const           { return accum >> (blip_sample_bits - 16); }
+	void next( bass_t bass )        { accum += *buf++ - (accum >> bass); }
+	void end( Blip_Buffer& b ) const { b.reader_accum_ = accum; }
+private:
+	const Blip_Buffer::buf_t_* BLIP_RESTRICT buf;
+	blip_long accum;
+};
+
+struct float_reader {
+	typedef float sample_t;
+	typedef float bass_t;
+	static bass_t bass( Blip_Buffer const& b ) { return BLIP_FLOAT_READER_BASS( b ); }
+	explicit float_reader( Blip_Buffer const& b ) : buf( b.float_buffer_() ), accum( b.reader_float_accum_ ) { }
+	sample_t read() const           { return accum * 0x8000; }
+	void next( bass_t bass )        { accum = accum * bass + *buf++; }
+	void end( Blip_Buffer& b ) const { b.reader_float_accum_ = (accum * accum < 1e-20f ? 0.0f : accum); }
+private:
+	const float* BLIP_RESTRICT buf;
+	float accum;
+};
+
 long Effects_Buffer::read_samples( blip_sample_t* out, long total_samples )
+{
+	if ( bufs [0].float_accum() )
+		return read_samples_<float_reader>( out, total_samples );
+	return read_samples_<fixed_reader>( out, total_samples );
+}
+
+long Effects_Buffer::read_samples_float( float* out, long total_samples )
+{
+	if ( bufs [0].float_accum() )
+		return read_samples_<float_reader>( out, total_samples );
+	return read_samples_<fixed_reader>( out, total_samples );
+}
+
+template<class R, class T>
+long Effects_Buffer::read_samples_( T* out, long total_samples )
 {
 	const int n_channels = max_voices * 2;
 	const int buf_count_per_voice = buf_count/max_voices;
@@ -314,143 +422,170 @@ long Effects_Buffer::read_samples( blip_sample_t* out, long total_samples )
 
 			if ( stereo_remain )
 			{
-				mix_enhanced( out, count );
+				mix_enhanced<R>( out, count );
 			}
 			else
 			{
-				mix_mono_enhanced( out, count );
+				mix_mono_enhanced<R>( out, count );
 				active_bufs = 3;
 			}
 		}
 		else if ( stereo_remain )
 		{
-			mix_stereo( out, count );
+			mix_stereo<R>( out, count );
 			active_bufs = 3;
 		}
 		else
 		{
-			mix_mono( out, count );
+			mix_mono<R>( out, count );
 			active_bufs = 1;
 		}
 
 		out += count * n_channels;
 		remain -= count;
+		remove_( count, active_bufs );
+	}
 
-		stereo_remain -= count;
-		if ( stereo_remain < 0 )
-			stereo_remain = 0;
+	return total_samples * n_channels;
+}
 
-		effect_remain -= count;
-		if ( effect_remain < 0 )
-			effect_remain = 0;
+void Effects_Buffer::remove_samples( long total_samples )
+{
+	const int n_channels = max_voices * 2;
+	require( total_samples % n_channels == 0 );
 
-		// skip the output from any buffers that didn't contribute to the sound output
-		// during this frame (e.g. if we only render mono then only the very first buf
-		// is 'active')
-		for ( int v = 0; v < max_voices; v++ ) // foreach voice
+	// same buffers are used as when reading, but echo and reverb aren't advanced
+	long remain = min( (long) bufs [0].samples_avail(), total_samples/n_channels );
+	while ( remain )
+	{
+		int active_bufs = buf_count/max_voices;
+		long count = remain;
+		if ( effect_remain )
 		{
-			for ( int i = 0; i < buf_count_per_voice; i++) // foreach buffer of that voice
-			{
-				if ( i < active_bufs )
-					bufs [v*buf_count_per_voice + i].remove_samples( count );
-				else // keep time synchronized
-					bufs [v*buf_count_per_voice + i].remove_silence( count );
-			}
+			if ( count > effect_remain )
+				count = effect_remain;
+			if ( !stereo_remain )
+				active_bufs = 3;
 		}
+		else
+		{
+			active_bufs = (stereo_remain ? 3 : 1);
+		}
+		remain -= count;
+		remove_( count, active_bufs );
 	}
+}
 
-	return total_samples * n_channels;
+void Effects_Buffer::remove_( long count, int active_bufs )
+{
+	const int buf_count_per_voice = buf_count/max_voices;
+
+	stereo_remain -= count;
+	if ( stereo_remain < 0 )
+		stereo_remain = 0;
+
+	effect_remain -= count;
+	if ( effect_remain < 0 )
+		effect_remain = 0;
+
+	// skip the output from any buffers that didn't contribute to the sound output
+	// during this frame (e.g. if we only render mono then only the very first buf
+	// is 'active')
+	for ( int v = 0; v < max_voices; v++ ) // foreach voice
+	{
+		for ( int i = 0; i < buf_count_per_voice; i++) // foreach buffer of that voice
+		{
+			if ( i < active_bufs )
+				bufs [v*buf_count_per_voice + i].remove_samples( count );
+			else // keep time synchronized
+				bufs [v*buf_count_per_voice + i].remove_silence( count );
+		}
+	}
 }
 
-void Effects_Buffer::mix_mono( blip_sample_t* out_, int32_t count )
+template<class R, class T>
+void Effects_Buffer::mix_mono( T* out_, int32_t count )
 {
     for(int i=0; i<max_voices; i++)
     {
-	blip_sample_t* BLIP_RESTRICT out = out_;
-	int const bass = BLIP_READER_BASS( bufs [i*max_buf_count+0] );
-	BLIP_READER_BEGIN( c, bufs [i*max_buf_count+0] );
+	T* BLIP_RESTRICT out = out_;
+	typename R::bass_t const bass = R::bass( bufs [i*max_buf_count+0] );
+	R c( bufs [i*max_buf_count+0] );
 
 	// unrolled loop
 	for ( int32_t n = count >> 1; n; --n )
 	{
-		int32_t cs0 = BLIP_READER_READ( c );
-		BLIP_READER_NEXT( c, bass );
+		typename R::sample_t cs0 = c.read();
+		c.next( bass );
 
-		int32_t cs1 = BLIP_READER_READ( c );
-		BLIP_READER_NEXT( c, bass );
+		typename R::sample_t cs1 = c.read();
+		c.next( bass );
 
-		if ( (int16_t) cs0 != cs0 )
-			cs0 = 0x7FFF - (cs0 >> 24);
-		((uint32_t*) out) [i] = ((uint16_t) cs0) | (uint16_t(cs0) << 16);
+		store_sample( out [i*2+0], cs0 );
+		out [i*2+1] = out [i*2+0];
 
-		if ( (int16_t) cs1 != cs1 )
-			cs1 = 0x7FFF - (cs1 >> 24);
-		((uint32_t*) out) [i+max_voices] = ((uint16_t) cs1) | (uint16_t(cs1) << 16);
+		store_sample( out [i*2+max_voices*2+0], cs1 );
+		out [i*2+max_voices*2+1] = out [i*2+max_voices*2+0];
 		out += max_voices*4;
 	}
 
 	if ( count & 1 )
 	{
-		int s = BLIP_READER_READ( c );
-		BLIP_READER_NEXT( c, bass );
-		if ( (int16_t) s != s )
-			s = 0x7FFF - (s >> 24);
-		out [i*2+0] = s;
-		out [i*2+1] = s;
+		typename R::sample_t s = c.read();
+		c.next( bass );
+		store_sample( out [i*2+0], s );
+		out [i*2+1] = out [i*2+0];
 	}
 
-	BLIP_READER_END( c, bufs [i*max_buf_count+0] );
+	c.end( bufs [i*max_buf_count+0] );
     }
 }
 
-void Effects_Buffer::mix_stereo( blip_sample_t* out_, int32_t frames )
+template<class R, class T>
+void Effects_Buffer::mix_stereo( T* out_, int32_t frames )
 {
     for(int i=0; i<max_voices; i++)
     {
-	blip_sample_t* BLIP_RESTRICT out = out_;
-	int const bass = BLIP_READER_BASS( bufs [i*max_buf_count+0] );
-	BLIP_READER_BEGIN( c, bufs [i*max_buf_count+0] );
-	BLIP_READER_BEGIN( l, bufs [i*max_buf_count+1] );
-	BLIP_READER_BEGIN( r, bufs [i*max_buf_count+2] );
+	T* BLIP_RESTRICT out = out_;
+	typename R::bass_t const bass = R::bass( bufs [i*max_buf_count+0] );
+	R c( bufs [i*max_buf_count+0] );
+	R l( bufs [i*max_buf_count+1] );
+	R r( bufs [i*max_buf_count+2] );
 
 	int count = frames;
 	while ( count-- )
 	{
-		int cs = BLIP_READER_READ( c );
-		BLIP_READER_NEXT( c, bass );
-		int left = cs + BLIP_READER_READ( l );
-		int right = cs + BLIP_READER_READ( r );
-		BLIP_READER_NEXT( l, bass );
-		BLIP_READER_NEXT( r, bass );
-
-		if ( (int16_t) left != left )
-			left = 0x7FFF - (left >> 24);
+		typename R::sample_t cs = c.read();
+		c.next( bass );
+		typename R::sample_t left = cs + l.read();
+		typename R::sample_t right = cs + r.read();
+		l.next( bass );
+		r.next( bass );
 
-		if ( (int16_t) right != right )
-			right = 0x7FFF - (right >> 24);
-
-		out [i*2+0] = left;
-		out [i*2+1] = right;
+		store_sample( out [i*2+0], left );
+		store_sample( out [i*2+1], right );
 
 		out += max_voices*2;
 
 	}
 
-	BLIP_READER_END( r, bufs [i*max_buf_count+2] );
-	BLIP_READER_END( l, bufs [i*max_buf_count+1] );
-	BLIP_READER_END( c, bufs [i*max_buf_count+0] );
+	r.end( bufs [i*max_buf_count+2] );
+	l.end( bufs [i*max_buf_count+1] );
+	c.end( bufs [i*max_buf_count+0] );
     }
 }
 
-void Effects_Buffer::mix_mono_enhanced( blip_sample_t* out_, int32_t frames )
+template<class R, class T>
+void Effects_Buffer::mix_mono_enhanced( T* out_, int32_t frames )
 {
 	for(int i=0; i<max_voices; i++)
 	{
-	blip_sample_t* BLIP_RESTRICT out = out_;
-	int const bass = BLIP_READER_BASS( bufs [i*max_buf_count+2] );
-	BLIP_READER_BEGIN( center, bufs [i*max_buf_count+2] );
-	BLIP_READER_BEGIN( sq1, bufs [i*max_buf_count+0] );
-	BLIP_READER_BEGIN( sq2, bufs [i*max_buf_count+1] );
+	typedef typename R::sample_t sample_t;
+	T* BLIP_RESTRICT out = out_;
+	typename R::bass_t const bass = R::bass( bufs [i*max_buf_count+2] );
+	R center( bufs [i*max_buf_count+2] );
+	R sq1( bufs [i*max_buf_count+0] );
+	R sq2( bufs [i*max_buf_count+1] );
 
 	blip_sample_t* const reverb_buf = &this->reverb_buf[i][0];
 	blip_sample_t* const echo_buf = &this->echo_buf[i][0];
@@ -460,68 +595,64 @@ void Effects_Buffer::mix_mono_enhanced( blip_sample_t* out_, int32_t frames )
 	int count = frames;
 	while ( count-- )
 	{
-		int sum1_s = BLIP_READER_READ( sq1 );
-		int sum2_s = BLIP_READER_READ( sq2 );
+		sample_t sum1_s = sq1.read();
+		sample_t sum2_s = sq2.read();
 
-		BLIP_READER_NEXT( sq1, bass );
-		BLIP_READER_NEXT( sq2, bass );
+		sq1.next( bass );
+		sq2.next( bass );
 
-		int new_reverb_l = FMUL( sum1_s, chans.pan_1_levels [0] ) +
-				FMUL( sum2_s, chans.pan_2_levels [0] ) +
+		sample_t new_reverb_l = fmul( sum1_s, chans.pan_1_levels [0] ) +
+				fmul( sum2_s, chans.pan_2_levels [0] ) +
 				reverb_buf [(reverb_pos + chans.reverb_delay_l) & reverb_mask];
 
-		int new_reverb_r = FMUL( sum1_s, chans.pan_1_levels [1] ) +
-				FMUL( sum2_s, chans.pan_2_levels [1] ) +
+		sample_t new_reverb_r = fmul( sum1_s, chans.pan_1_levels [1] ) +
+				fmul( sum2_s, chans.pan_2_levels [1] ) +
 				reverb_buf [(reverb_pos + chans.reverb_delay_r) & reverb_mask];
 
 		fixed_t reverb_level = chans.reverb_level;
-		reverb_buf [reverb_pos] = (blip_sample_t) FMUL( new_reverb_l, reverb_level );
-		reverb_buf [reverb_pos + 1] = (blip_sample_t) FMUL( new_reverb_r, reverb_level );
+		reverb_buf [reverb_pos] = to_delay_sample( fmul( new_reverb_l, reverb_level ) );
+		reverb_buf [reverb_pos + 1] = to_delay_sample( fmul( new_reverb_r, reverb_level ) );
 		reverb_pos = (reverb_pos + 2) & reverb_mask;
 
-		int sum3_s = BLIP_READER_READ( center );
-		BLIP_READER_NEXT( center, bass );
+		sample_t sum3_s = center.read();
+		center.next( bass );
 
-		int left = new_reverb_l + sum3_s + FMUL( chans.echo_level,
-				echo_buf [(echo_pos + chans.echo_delay_l) & echo_mask] );
-		int right = new_reverb_r + sum3_s + FMUL( chans.echo_level,
-				echo_buf [(echo_pos + chans.echo_delay_r) & echo_mask] );
+		sample_t left = new_reverb_l + sum3_s + fmul( sample_t (
+				echo_buf [(echo_pos + chans.echo_delay_l) & echo_mask] ), chans.echo_level );
+		sample_t right = new_reverb_r + sum3_s + fmul( sample_t (
+				echo_buf [(echo_pos + chans.echo_delay_r) & echo_mask] ), chans.echo_level );
 
-		echo_buf [echo_pos] = sum3_s;
+		echo_buf [echo_pos] = to_delay_sample( sum3_s );
 		echo_pos = (echo_pos + 1) & echo_mask;
 
-		if ( (int16_t) left != left )
-			left = 0x7FFF - (left >> 24);
-
-		if ( (int16_t) right != right )
-			right = 0x7FFF - (right >> 24);
-
-		out [i*2+0] = left;
-		out [i*2+1] = right;
+		store_sample( out [i*2+0], left );
+		store_sample( out [i*2+1], right );
 		out += max_voices*2;
 	}
 	this->reverb_pos[i] = reverb_pos;
 	this->echo_pos[i] = echo_pos;
 
-	BLIP_READER_END( sq1, bufs [i*max_buf_count+0] );
-	BLIP_READER_END( sq2, bufs [i*max_buf_count+1] );
-	BLIP_READER_END( center, bufs [i*max_buf_count+2] );
+	sq1.end( bufs [i*max_buf_count+0] );
+	sq2.end( bufs [i*max_buf_count+1] );
+	center.end( bufs [i*max_buf_count+2] );
     }
 }
 
-void Effects_Buffer::mix_enhanced( blip_sample_t* out_, int32_t frames )
+template<class R, class T>
+void Effects_Buffer::mix_enhanced( T* out_, int32_t frames )
 {
     for(int i=0; i<max_voices; i++)
     {
-	blip_sample_t* BLIP_RESTRICT out = out_;
-	int const bass = BLIP_READER_BASS( bufs [i*max_buf_count+2] );
-	BLIP_READER_BEGIN( center, bufs [i*max_buf_count+2] );
-	BLIP_READER_BEGIN( l1, bufs [i*max_buf_count+3] );
-	BLIP_READER_BEGIN( r1, bufs [i*max_buf_count+4] );
-	BLIP_READER_BEGIN( l2, bufs [i*max_buf_count+5] );
-	BLIP_READER_BEGIN( r2, bufs [i*max_buf_count+6] );
-	BLIP_READER_BEGIN( sq1, bufs [i*max_buf_count+0] );
-	BLIP_READER_BEGIN( sq2, bufs [i*max_buf_count+1] );
+	typedef typename R::sample_t sample_t;
+	T* BLIP_RESTRICT out = out_;
+	typename R::bass_t const bass = R::bass( bufs [i*max_buf_count+2] );
+	R center( bufs [i*max_buf_count+2] );
+	R l1( bufs [i*max_buf_count+3] );
+	R r1( bufs [i*max_buf_count+4] );
+	R l2( bufs [i*max_buf_count+5] );
+	R r2( bufs [i*max_buf_count+6] );
+	R sq1( bufs [i*max_buf_count+0] );
+	R sq2( bufs [i*max_buf_count+1] );
 
 	blip_sample_t* const reverb_buf = &this->reverb_buf[i][0];
 	blip_sample_t* const echo_buf = &this->echo_buf[i][0];
@@ -531,63 +662,56 @@ void Effects_Buffer::mix_enhanced( blip_sample_t* out_, int32_t frames )
 	int count = frames;
 	while ( count-- )
 	{
-		int sum1_s = BLIP_READER_READ( sq1 );
-		int sum2_s = BLIP_READER_READ( sq2 );
+		sample_t sum1_s = sq1.read();
+		sample_t sum2_s = sq2.read();
 
-		BLIP_READER_NEXT( sq1, bass );
-		BLIP_READER_NEXT( sq2, bass );
+		sq1.next( bass );
+		sq2.next( bass );
 
-		int new_reverb_l = FMUL( sum1_s, chans.pan_1_levels [0] ) +
-				FMUL( sum2_s, chans.pan_2_levels [0] ) + BLIP_READER_READ( l1 ) +
+		sample_t new_reverb_l = fmul( sum1_s, chans.pan_1_levels [0] ) +
+				fmul( sum2_s, chans.pan_2_levels [0] ) + l1.read() +
 				reverb_buf [(reverb_pos + chans.reverb_delay_l) & reverb_mask];
 
-		int new_reverb_r = FMUL( sum1_s, chans.pan_1_levels [1] ) +
-				FMUL( sum2_s, chans.pan_2_levels [1] ) + BLIP_READER_READ( r1 ) +
+		sample_t new_reverb_r = fmul( sum1_s, chans.pan_1_levels [1] ) +
+				fmul( sum2_s, chans.pan_2_levels [1] ) + r1.read() +
 				reverb_buf [(reverb_pos + chans.reverb_delay_r) & reverb_mask];
 
-		BLIP_READER_NEXT( l1, bass );
-		BLIP_READER_NEXT( r1, bass );
+		l1.next( bass );
+		r1.next( bass );
 
 		fixed_t reverb_level = chans.reverb_level;
-		reverb_buf [reverb_pos] = (blip_sample_t) FMUL( new_reverb_l, reverb_level );
-		reverb_buf [reverb_pos + 1] = (blip_sample_t) FMUL( new_reverb_r, reverb_level );
+		reverb_buf [reverb_pos] = to_delay_sample( fmul( new_reverb_l, reverb_level ) );
+		reverb_buf [reverb_pos + 1] = to_delay_sample( fmul( new_reverb_r, reverb_level ) );
 		reverb_pos = (reverb_pos + 2) & reverb_mask;
 
-		int sum3_s = BLIP_READER_READ( center );
-		BLIP_READER_NEXT( center, bass );
+		sample_t sum3_s = center.read();
+		center.next( bass );
 
-		int left = new_reverb_l + sum3_s + BLIP_READER_READ( l2 ) + FMUL( chans.echo_level,
-				echo_buf [(echo_pos + chans.echo_delay_l) & echo_mask] );
-		int right = new_reverb_r + sum3_s + BLIP_READER_READ( r2 ) + FMUL( chans.echo_level,
-				echo_buf [(echo_pos + chans.echo_delay_r) & echo_mask] );
+		sample_t left = new_reverb_l + sum3_s + l2.read() + fmul( sample_t (
+				echo_buf [(echo_pos + chans.echo_delay_l) & echo_mask] ), chans.echo_level );
+		sample_t right = new_reverb_r + sum3_s + r2.read() + fmul( sample_t (
+				echo_buf [(echo_pos + chans.echo_delay_r) & echo_mask] ), chans.echo_level );
 
-		BLIP_READER_NEXT( l2, bass );
-		BLIP_READER_NEXT( r2, bass );
+		l2.next( bass );
+		r2.next( bass );
 
-		echo_buf [echo_pos] = sum3_s;
+		echo_buf [echo_pos] = to_delay_sample( sum3_s );
 		echo_pos = (echo_pos + 1) & echo_mask;
 
-		if ( (int16_t) left != left )
-			left = 0x7FFF - (left >> 24);
-
-		if ( (int16_t) right != right )
-			right = 0x7FFF - (right >> 24);
-
-		out [i*2+0] = left;
-		out [i*2+1] = right;
+		store_sample( out [i*2+0], left );
+		store_sample( out [i*2+1], right );
 
 		out += max_voices*2;
 	}
 	this->reverb_pos[i] = reverb_pos;
 	this->echo_pos[i] = echo_pos;
 
-	BLIP_READER_END( l1, bufs [i*max_buf_count+3] );
-	BLIP_READER_END( r1, bufs [i*max_buf_count+4] );
-	BLIP_READER_END( l2, bufs [i*max_buf_count+5] );
-	BLIP_READER_END( r2, bufs [i*max_buf_count+6] );
-	BLIP_READER_END( sq1, bufs [i*max_buf_count+0] );
-	BLIP_READER_END( sq2, bufs [i*max_buf_count+1] );
-	BLIP_READER_END( center, bufs [i*max_buf_count+2] );
+	l1.end( bufs [i*max_buf_count+3] );
+	r1.end( bufs [i*max_buf_count+4] );
+	l2.end( bufs [i*max_buf_count+5] );
+	r2.end( bufs [i*max_buf_count+6] );
+	sq1.end( bufs [i*max_buf_count+0] );
+	sq2.end( bufs [i*max_buf_count+1] );
+	center.end( bufs [i*max_buf_count+2] );
     }
 }
-
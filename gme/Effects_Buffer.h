@@ -50,7 +50,12 @@ public:
 	void clear() override;
 	channel_t channel( int, int ) override;
 	void end_frame( blip_time_t ) override;
+	void copy_state( Emu_State& ) override;
+	void set_float_accum( bool ) override;
+	void get_stats( gme_stats_t* ) const override;
 	long read_samples( blip_sample_t*, long ) override;
+	long read_samples_float( float*, long ) override;
+	void remove_samples( long ) override;
 	long samples_avail() const override;
 private:
 	typedef long fixed_t;
@@ -81,10 +86,12 @@ private:
 		fixed_t reverb_level;
 	} chans;
 
-	void mix_mono( blip_sample_t*, int32_t );
-	void mix_stereo( blip_sample_t*, int32_t );
-	void mix_enhanced( blip_sample_t*, int32_t );
-	void mix_mono_enhanced( blip_sample_t*, int32_t );
+	template<class R, class T> long read_samples_( T*, long );
+	void remove_( long count, int active_bufs );
+	template<class R, class T> void mix_mono( T*, int32_t );
+	template<class R, class T> void mix_stereo( T*, int32_t );
+	template<class R, class T> void mix_enhanced( T*, int32_t );
+	template<class R, class T> void mix_mono_enhanced( T*, int32_t );
 };
 
 #endif
@@ -0,0 +1,76 @@
+// Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
+
+#include "Emu_State.h"
+
+#include <string.h>
+
+/* This module is free software; you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 2.1 of the License, or (at your
+option) any later version. This module is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General
+Public License for more details. You should have received a copy of the GNU
+Lesser General Public License along with this module; if not, write to the Free
+Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+02110-1301 USA */
+
+#include "blargg_source.h"
+
+Emu_State::Emu_State()
+{
+	begin_save( 0, 0 );
+}
+
+void Emu_State::begin_save( void* out, long n )
+{
+	data     = (unsigned char*) out;
+	size     = n;
+	pos      = 0;
+	loading_ = false;
+	error_   = 0;
+}
+
+void Emu_State::begin_load( void const* in, long n )
+{
+	begin_save( const_cast<void*> (in), n );
+	loading_ = true;
+}
+
+void Emu_State::set_corrupt()
+{
+	if ( !error_ )
+		error_ = loading_ ? "Corrupt state" : "State buffer too small";
+}
+
+void Emu_State::copy( void* p, long n )
+{
+	if ( error_ )
+		return;
+
+	if ( data && n > size - pos )
+	{
+		set_corrupt();
+		return;
+	}
+
+	if ( data )
+	{
+		if ( loading_ )
+			memcpy( p, data + pos, n );
+		else
+			memcpy( data + pos, p, n );
+	}
+	pos += n;
+}
+
+void Emu_State::copy_count( int& count, int max )
+{
+	assert( loading_ || (unsigned) count <= (unsigned) max );
+	(*this)( count );
+	if ( (unsigned) count > (unsigned) max )
+	{
+		set_corrupt();
+		count = 0;
+	}
+}
@@ -0,0 +1,57 @@
+// Saves and restores emulator state in memory
+
+// Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
+#ifndef EMU_STATE_H
+#define EMU_STATE_H
+
+#include "blargg_common.h"
+
+// Emulator components implement a single copy_state( Emu_State& ) function which
+// passes each of its variables to the state, in the same order every time. When
+// saving, variables are copied into the state; when loading, they are copied back.
+// State data is in native format and holds pointers into the emulator, so it can
+// only be loaded into the same emulator object, with the same file loaded, in the
+// same process.
+class Emu_State {
+public:
+	// Begin saving to out, which can hold at most size bytes. If out is NULL,
+	// only counts number of bytes that would be saved (see used()).
+	void begin_save( void* out, long size );
+
+	// Begin loading from state data previously saved
+	void begin_load( void const* in, long size );
+
+	// True if loading, false if saving
+	bool loading() const { return loading_; }
+
+	// Copy n bytes at p to/from state
+	void copy( void* p, long n );
+
+	// Copy plain variable or array to/from state
+	template<class T>
+	void operator () ( T& t ) { copy( &t, sizeof t ); }
+
+	// Copy count of used elements in a buffer. When loading, fails if count is
+	// greater than max.
+	void copy_count( int& count, int max );
+
+	// Number of bytes copied so far
+	long used() const { return pos; }
+
+	// Reports state as corrupt, causing all further copying to be ignored
+	void set_corrupt();
+
+	// Error that occurred, or NULL if none
+	blargg_err_t error() const { return error_; }
+
+public:
+	Emu_State();
+private:
+	unsigned char* data;
+	long size;
+	long pos;
+	bool loading_;
+	blargg_err_t error_;
+};
+
+#endif
@@ -2,6 +2,8 @@
 
 #include "Fir_Resampler.h"
 
+#include "Emu_State.h"
+#include "blargg_simd.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -52,17 +54,24 @@ static void gen_sinc( double rolloff, int width, double offset, double spacing,
 	}
 }
 
-Fir_Resampler_::Fir_Resampler_( int width, sample_t* impulses_ ) :
+Fir_Resampler_::Fir_Resampler_( int width, int max_width, sample_t* impulses_ ) :
 	width_( width ),
+	max_width_( max_width ),
 	write_offset( width * stereo - stereo ),
 	impulses( impulses_ )
 {
+	assert( width >= 4 && width % 2 == 0 && width <= max_width );
 	write_pos = 0;
 	res       = 1;
 	imp_phase = 0;
 	skip_bits = 0;
 	step      = stereo;
 	ratio_    = 1.0;
+	factor_   = 1.0;
+	rolloff_  = 0.999;
+	gain_     = 1.0;
+	input_count_  = 0;
+	output_count_ = 0;
 }
 
 Fir_Resampler_::~Fir_Resampler_() { }
@@ -77,16 +86,44 @@ void Fir_Resampler_::clear()
 	}
 }
 
+void Fir_Resampler_::copy_state( Emu_State& s )
+{
+	int count = write_pos - buf.begin();
+	s.copy_count( count, buf.size() );
+	if ( count < write_offset )
+	{
+		s.set_corrupt();
+		count = write_offset;
+	}
+	write_pos = buf.begin() + count;
+	s.copy( buf.begin(), count * sizeof buf [0] );
+	s( imp_phase );
+}
+
 blargg_err_t Fir_Resampler_::buffer_size( int new_size )
 {
-	RETURN_ERR( buf.resize( new_size + write_offset ) );
+	// room for widest FIR, so width can be changed without reallocating; max_write()
+	// leaves the extra unused
+	RETURN_ERR( buf.resize( new_size + max_width_ * stereo - stereo ) );
 	clear();
 	return 0;
 }
 
 double Fir_Resampler_::time_ratio( double new_factor, double rolloff, double gain )
 {
-	ratio_ = new_factor;
+	factor_  = new_factor;
+	rolloff_ = rolloff;
+	gain_    = gain;
+	make_impulses();
+	clear();
+	return ratio_;
+}
+
+void Fir_Resampler_::make_impulses()
+{
+	double const rolloff = rolloff_;
+	double const gain    = gain_;
+	ratio_ = factor_;
 
 	double fstep = 0.0;
 	{
@@ -132,10 +169,39 @@ double Fir_Resampler_::time_ratio( double new_factor, double rolloff, double gai
 			input_per_cycle++;
 		}
 	}
+}
 
-	clear();
+void Fir_Resampler_::set_width( int width )
+{
+	require( width >= 4 && width % 2 == 0 && width <= max_width_ );
+	if ( width == width_ )
+		return;
 
-	return ratio_;
+	// Keep buffered input, so output continues without a gap. Shift it so the FIR
+	// stays centered on the same input, padding with silence where a wider FIR
+	// needs more history than is buffered. Buffer has room for max_width_.
+	int const new_offset = width * stereo - stereo;
+	if ( buf.size() )
+	{
+		int count = write_pos - buf.begin();
+		int shift = (width - width_) / 2 * stereo; // negative if narrower
+		if ( count + shift < new_offset )
+			shift = new_offset - count;
+		if ( shift > 0 )
+		{
+			memmove( &buf [shift], &buf [0], count * sizeof buf [0] );
+			memset( &buf [0], 0, shift * sizeof buf [0] );
+		}
+		else if ( shift < 0 )
+		{
+			memmove( &buf [0], &buf [-shift], (count + shift) * sizeof buf [0] );
+		}
+		write_pos = &buf [count + shift];
+	}
+
+	width_       = width;
+	write_offset = new_offset;
+	make_impulses();
 }
 
 int Fir_Resampler_::input_needed( int32_t output_count ) const
@@ -184,6 +250,55 @@ int Fir_Resampler_::avail_( int32_t input_count ) const
 	return output_count;
 }
 
+int Fir_Resampler_::skip_output( int32_t count )
+{
+	// same stepping as read_()
+	sample_t const* in = buf.begin();
+	sample_t const* end_pos = write_pos;
+	uint32_t skip = skip_bits >> imp_phase;
+	int remain = res - imp_phase;
+
+	double const ratio1 = ratio() - 1.0;
+	bool const should_resample = ( ratio1 >= 0 ? ratio1 : -ratio1 ) >= 0.00001;
+
+	int output_count = 0;
+	count >>= 1;
+	if ( end_pos - in >= width_ * stereo )
+	{
+		end_pos -= width_ * stereo;
+		do
+		{
+			count--;
+			if ( count < 0 )
+				break;
+
+			if ( should_resample )
+			{
+				remain--;
+				in += (skip * stereo) & stereo;
+				skip >>= 1;
+				if ( !remain )
+				{
+					skip = skip_bits;
+					remain = res;
+				}
+			}
+
+			in += step;
+			output_count += 2;
+		}
+		while ( in <= end_pos );
+	}
+
+	imp_phase = res - remain;
+
+	int left = write_pos - in;
+	write_pos = &buf [left];
+	memmove( buf.begin(), in, left * sizeof *in );
+
+	return output_count;
+}
+
 int Fir_Resampler_::skip_input( long count )
 {
 	int remain = write_pos - buf.begin();
@@ -199,3 +314,202 @@ int Fir_Resampler_::skip_input( long count )
 
 	return count;
 }
+
+// SIMD resampling
+
+// FIR sums are calculated with 16-bit multiplies added in 32-bit pairs, so they
+// wrap around exactly as the portable code's sums do and output is identical.
+
+struct Fir_Resampler_::simd_pos_t
+{
+	sample_t const* in;
+	sample_t const* imp;
+	sample_t const* impulses;
+	uint32_t skip;
+	uint32_t skip_bits;
+	int remain;
+	int res;
+	int step;
+
+	// Advances to next output, stepping through input and impulses as read_() does
+	void next( int width )
+	{
+		imp += width;
+		in += (skip * stereo) & stereo;
+		skip >>= 1;
+		if ( !--remain )
+		{
+			imp    = impulses;
+			skip   = skip_bits;
+			remain = res;
+		}
+		in += step;
+	}
+
+	template<class T>
+	static void store( T* out, int32_t l, int32_t r )
+	{
+		Fir_Resampler_::store( out [0], l, 15 );
+		Fir_Resampler_::store( out [1], r, 15 );
+	}
+};
+
+typedef Fir_Resampler_::simd_pos_t simd_pos_t;
+
+#if BLARGG_SIMD_SSE2
+
+// Adds FIR sums of four stereo input frames to sum, left in lanes 0 and 2 and
+// right in lanes 1 and 3
+static inline __m128i fir4_sse2( __m128i sum, short const* in, short const* imp )
+{
+	// l0 l1 r0 r1 l2 l3 r2 r3 times c0 c1 c0 c1 c2 c3 c2 c3
+	__m128i i = _mm_loadu_si128( (__m128i const*) in );
+	i = _mm_shufflehi_epi16( _mm_shufflelo_epi16( i, 0xD8 ), 0xD8 );
+	__m128i c = _mm_loadl_epi64( (__m128i const*) imp );
+	return _mm_add_epi32( sum, _mm_madd_epi16( i, _mm_unpacklo_epi32( c, c ) ) );
+}
+
+template<int width, class T>
+static T* read_sse2( simd_pos_t& p, short const* end_pos, T* out, int32_t count )
+{
+	for ( ; count > 0 && p.in <= end_pos; count-- )
+	{
+		__m128i sum = _mm_setzero_si128();
+		for ( int n = 0; n < width; n += 4 )
+			sum = fir4_sse2( sum, p.in + n * 2, p.imp + n );
+		sum = _mm_add_epi32( sum, _mm_srli_si128( sum, 8 ) );
+		p.store( out, _mm_cvtsi128_si32( sum ), _mm_cvtsi128_si32( _mm_srli_si128( sum, 4 ) ) );
+		out += 2;
+		p.next( width );
+	}
+	return out;
+}
+
+#endif
+
+#if BLARGG_SIMD_AVX2
+
+template<int width, class T>
+BLARGG_TARGET_AVX2
+static T* read_avx2( simd_pos_t& p, short const* end_pos, T* out, int32_t count )
+{
+	__m256i const pairs = _mm256_set_epi32( 3, 3, 2, 2, 1, 1, 0, 0 );
+	for ( ; count > 0 && p.in <= end_pos; count-- )
+	{
+		// eight frames at a time, as fir4_sse2() does in each half
+		__m256i sum8 = _mm256_setzero_si256();
+		int n = 0;
+		for ( ; n + 8 <= width; n += 8 )
+		{
+			__m256i i = _mm256_loadu_si256( (__m256i const*) (p.in + n * 2) );
+			i = _mm256_shufflehi_epi16( _mm256_shufflelo_epi16( i, 0xD8 ), 0xD8 );
+			__m256i c = _mm256_castsi128_si256( _mm_loadu_si128( (__m128i const*) (p.imp + n) ) );
+			sum8 = _mm256_add_epi32( sum8, _mm256_madd_epi16( i, _mm256_permutevar8x32_epi32( c, pairs ) ) );
+		}
+		__m128i sum = _mm_add_epi32( _mm256_castsi256_si128( sum8 ), _mm256_extracti128_si256( sum8, 1 ) );
+		if ( n < width )
+			sum = fir4_sse2( sum, p.in + n * 2, p.imp + n );
+		sum = _mm_add_epi32( sum, _mm_srli_si128( sum, 8 ) );
+		p.store( out, _mm_cvtsi128_si32( sum ), _mm_cvtsi128_si32( _mm_srli_si128( sum, 4 ) ) );
+		out += 2;
+		p.next( width );
+	}
+	return out;
+}
+
+#endif
+
+#if BLARGG_SIMD_NEON
+
+template<int width, class T>
+static T* read_neon( simd_pos_t& p, short const* end_pos, T* out, int32_t count )
+{
+	for ( ; count > 0 && p.in <= end_pos; count-- )
+	{
+		int32x4_t l = vdupq_n_s32( 0 );
+		int32x4_t r = l;
+		for ( int n = 0; n < width; n += 4 )
+		{
+			int16x4x2_t i = vld2_s16( p.in + n * 2 ); // separates left and right
+			int16x4_t c = vld1_s16( p.imp + n );
+			l = vmlal_s16( l, i.val [0], c );
+			r = vmlal_s16( r, i.val [1], c );
+		}
+		int32x2_t sum = vpadd_s32( vadd_s32( vget_low_s32( l ), vget_high_s32( l ) ),
+				vadd_s32( vget_low_s32( r ), vget_high_s32( r ) ) );
+		p.store( out, vget_lane_s32( sum, 0 ), vget_lane_s32( sum, 1 ) );
+		out += 2;
+		p.next( width );
+	}
+	return out;
+}
+
+#endif
+
+// Resamples using SIMD if available for width and returns end of output,
+// otherwise returns NULL
+template<int width, class T>
+static T* read_simd_( simd_pos_t& p, short const* end_pos, T* out, int32_t count )
+{
+	int const features = blargg_cpu_features();
+	(void) features;
+	#if BLARGG_SIMD_AVX2
+		if ( features & blargg_cpu_avx2 )
+			return read_avx2<width>( p, end_pos, out, count );
+	#endif
+	#if BLARGG_SIMD_SSE2
+		if ( features & blargg_cpu_sse2 )
+			return read_sse2<width>( p, end_pos, out, count );
+	#elif BLARGG_SIMD_NEON
+		if ( features & blargg_cpu_neon )
+			return read_neon<width>( p, end_pos, out, count );
+	#endif
+	(void) p; (void) end_pos; (void) out; (void) count;
+	return 0;
+}
+
+template<class T>
+int Fir_Resampler_::read_simd( T* out_begin, int32_t count )
+{
+	simd_pos_t p;
+	p.in        = buf.begin();
+	p.imp       = impulses + imp_phase * width_;
+	p.impulses  = impulses;
+	p.skip      = skip_bits >> imp_phase;
+	p.skip_bits = skip_bits;
+	p.remain    = res - imp_phase;
+	p.res       = res;
+	p.step      = step;
+
+	int32_t pairs = count >> 1;
+	sample_t const* end_pos = p.in;
+	if ( write_pos - p.in >= width_ * stereo )
+		end_pos = write_pos - width_ * stereo;
+	else
+		pairs = 0; // not enough input for any output
+
+	T* out;
+	switch ( width_ )
+	{
+		case  8: out = read_simd_< 8>( p, end_pos, out_begin, pairs ); break;
+		case 12: out = read_simd_<12>( p, end_pos, out_begin, pairs ); break;
+		case 16: out = read_simd_<16>( p, end_pos, out_begin, pairs ); break;
+		case 24: out = read_simd_<24>( p, end_pos, out_begin, pairs ); break;
+		case 32: out = read_simd_<32>( p, end_pos, out_begin, pairs ); break;
+		default: out = 0;
+	}
+	if ( !out )
+		return -1;
+
+	imp_phase = res - p.remain;
+
+	int left = write_pos - p.in;
+	write_pos = &buf [left];
+	memmove( buf.begin(), p.in, left * sizeof *p.in );
+
+	GME_STAT( output_count_ += out - out_begin );
+	return out - out_begin;
+}
+
+template int Fir_Resampler_::read_simd( sample_t*, int32_t );
+template int Fir_Resampler_::read_simd( float*, int32_t );
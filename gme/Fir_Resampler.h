@@ -7,10 +7,12 @@
 #include "blargg_common.h"
 #include <string.h>
 
+class Emu_State;
+
 class Fir_Resampler_ {
 public:
 
-	// Use Fir_Resampler<width> (below)
+	// Use Fir_Resampler<max_width> (below)
 
 	// Set input/output resampling ratio and optionally low-pass rolloff and gain.
 	// Returns actual ratio used (rounded to internal precision).
@@ -19,6 +21,14 @@ public:
 	// Current input/output ratio
 	double ratio() const { return ratio_; }
 
+	// Set number of points in FIR, up to the maximum the resampler was declared
+	// with. Must be even and 4 or more. Keeps ratio, rolloff and gain, and buffered
+	// input, so it can be changed during playback. Does nothing if width is unchanged.
+	void set_width( int );
+
+	// Current number of points in FIR
+	int width() const { return width_; }
+
 // Input
 
 	typedef short sample_t;
@@ -31,11 +41,14 @@ public:
 	void clear();
 
 	// Number of input samples that can be written
-	int max_write() const { return buf.end() - write_pos; }
+	int max_write() const { return buf.end() - write_pos - (max_width_ - width_) * stereo; }
 
 	// Pointer to place to write input samples
 	sample_t* buffer() { return write_pos; }
 
+	// Beginning of buffered input, which extends up to buffer()
+	sample_t* input_begin() { return buf.begin(); }
+
 	// Notify resampler that 'count' input samples have been written
 	void write( long count );
 
@@ -45,6 +58,9 @@ public:
 	// Skip 'count' input samples. Returns number of samples actually skipped.
 	int skip_input( long count );
 
+	// Save/load buffered input and current phase, for emulator state
+	void copy_state( Emu_State& );
+
 // Output
 
 	// Number of extra input samples needed until 'count' output samples are available
@@ -53,8 +69,18 @@ public:
 	// Number of output samples available
 	int avail() const { return avail_( write_pos - &buf [width_ * stereo] ); }
 
+	// Removes input as read() would for at most 'count' samples, without calculating
+	// them. Returns number of samples skipped.
+	int skip_output( int32_t count );
+
+	// Number of input samples written and output samples read. Only counted if
+	// GME_STATS is defined.
+	uint64_t input_count() const  { return input_count_; }
+	uint64_t output_count() const { return output_count_; }
+
 public:
 	~Fir_Resampler_();
+	struct simd_pos_t;
 protected:
 	enum { stereo = 2 };
 	enum { max_res = 32 };
@@ -62,30 +88,51 @@ protected:
 	sample_t* write_pos;
 	int res;
 	int imp_phase;
-	int const width_;
-	int const write_offset;
+	int width_;
+	int const max_width_;
+	int write_offset;
 	uint32_t skip_bits;
 	int step;
 	int input_per_cycle;
 	double ratio_;
+	double factor_;   // arguments of last time_ratio(), for set_width()
+	double rolloff_;
+	double gain_;
 	sample_t* impulses;
+	uint64_t input_count_;
+	uint64_t output_count_;
 
-	Fir_Resampler_( int width, sample_t* );
+	Fir_Resampler_( int width, int max_width, sample_t* );
 	int avail_( int32_t input_count ) const;
+	void make_impulses();
+	template<class T> int read_( T* out, int32_t count );
+
+	// Same as read_() when resampling, using SIMD for common widths. Returns -1
+	// without doing anything if SIMD isn't available.
+	template<class T> int read_simd( T* out, int32_t count );
+
+	// Stores input sample or FIR sum scaled by 1 << shift to output
+	static void store( sample_t& out, int32_t s, int shift ) { out = (sample_t) (s >> shift); }
+	static void store( float& out, int32_t s, int shift ) { out = s * (1.0f / 0x8000) / (1L << shift); }
 };
 
-// Width is number of points in FIR. Must be even and 4 or more. More points give
-// better quality and rolloff effectiveness, and take longer to calculate.
-template<int width>
+// Width is number of points in FIR, which can be changed at run time up to
+// max_width. Must be even and 4 or more. More points give better quality and
+// rolloff effectiveness, and take longer to calculate.
+template<int max_width>
 class Fir_Resampler : public Fir_Resampler_ {
-	static_assert( width >= 4 && width % 2 == 0, "FIR width must be even and have 4 or more points" );
-	short impulses [max_res] [width];
+	static_assert( max_width >= 4 && max_width % 2 == 0, "FIR width must be even and have 4 or more points" );
+	short impulse_buf [max_res] [max_width];
 public:
-	Fir_Resampler() : Fir_Resampler_( width, impulses [0] ) { }
+	Fir_Resampler( int width = max_width ) : Fir_Resampler_( width, max_width, impulse_buf [0] ) { }
 
 	// Read at most 'count' samples. Returns number of samples actually read.
 	typedef short sample_t;
-	int read( sample_t* out, int32_t count );
+	int read( sample_t* out, int32_t count ) { return read_( out, count ); }
+
+	// Same as read(), but writes floating-point samples at full FIR precision,
+	// where 1.0 corresponds to a full-scale 16-bit sample
+	int read( float* out, int32_t count ) { return read_( out, count ); }
 };
 
 // End of public interface
@@ -94,27 +141,36 @@ inline void Fir_Resampler_::write( long count )
 {
 	write_pos += count;
 	assert( write_pos <= buf.end() );
+	GME_STAT( input_count_ += count );
 }
 
-template<int width>
-int Fir_Resampler<width>::read( sample_t* out_begin, int32_t count )
+template<class T>
+int Fir_Resampler_::read_( T* out_begin, int32_t count )
 {
-	sample_t* out = out_begin;
+	// Resampling can add noise so don't actually do it if we've matched sample
+	// rate
+	const double ratio1 = ratio() - 1.0;
+	const bool should_resample =
+		( ratio1 >= 0 ? ratio1 : -ratio1 ) >= 0.00001;
+
+	if ( should_resample )
+	{
+		int n = read_simd( out_begin, count );
+		if ( n >= 0 )
+			return n;
+	}
+
+	T* out = out_begin;
 	const sample_t* in = buf.begin();
 	sample_t* end_pos = write_pos;
 	uint32_t skip = skip_bits >> imp_phase;
-	sample_t const* imp = impulses [imp_phase];
+	sample_t const* imp = impulses + imp_phase * width_;
 	int remain = res - imp_phase;
 	int const step = this->step;
+	int const width = width_;
 
 	count >>= 1;
 
-	// Resampling can add noise so don't actually do it if we've matched sample
-	// rate
-	const double ratio1 = ratio() - 1.0;
-	const bool should_resample =
-		( ratio1 >= 0 ? ratio1 : -ratio1 ) >= 0.00001;
-
 	if ( end_pos - in >= width * stereo )
 	{
 		end_pos -= width * stereo;
@@ -126,8 +182,8 @@ int Fir_Resampler<width>::read( sample_t* out_begin, int32_t count )
 
 			if( !should_resample )
 			{
-				out [0] = static_cast<sample_t>( in [0] );
-				out [1] = static_cast<sample_t>( in [1] );
+				store( out [0], in [0], 0 );
+				store( out [1], in [1], 0 );
 			}
 			else
 			{
@@ -151,21 +207,18 @@ int Fir_Resampler<width>::read( sample_t* out_begin, int32_t count )
 
 				remain--;
 
-				l >>= 15;
-				r >>= 15;
-
 				in += (skip * stereo) & stereo;
 				skip >>= 1;
 
 				if ( !remain )
 				{
-					imp = impulses [0];
+					imp = impulses;
 					skip = skip_bits;
 					remain = res;
 				}
 
-				out [0] = (sample_t) l;
-				out [1] = (sample_t) r;
+				store( out [0], l, 15 );
+				store( out [1], r, 15 );
 			}
 
 			in += step;
@@ -180,6 +233,7 @@ int Fir_Resampler<width>::read( sample_t* out_begin, int32_t count )
 	write_pos = &buf [left];
 	memmove( buf.begin(), in, left * sizeof *in );
 
+	GME_STAT( output_count_ += out - out_begin );
 	return out - out_begin;
 }
 
@@ -2,6 +2,7 @@
 
 #include "Gb_Apu.h"
 
+#include "Emu_State.h"
 #include <string.h>
 #include <algorithm>
 
@@ -87,6 +88,51 @@ void Gb_Apu::update_volume()
 	other_synth.volume( vol );
 }
 
+static void copy_osc( Emu_State& s, Gb_Osc& osc )
+{
+	s( osc.output_select );
+	if ( (unsigned) osc.output_select > 3 )
+	{
+		s.set_corrupt();
+		osc.output_select = 0;
+	}
+	osc.output = osc.outputs [osc.output_select];
+	s( osc.delay );
+	s( osc.last_amp );
+	s( osc.volume );
+	s( osc.length );
+	s( osc.enabled );
+}
+
+void Gb_Apu::copy_state( Emu_State& s )
+{
+	for ( int i = 0; i < osc_count; i++ )
+		copy_osc( s, *oscs [i] );
+
+	s( square1.env_delay );
+	s( square1.sweep_delay );
+	s( square1.sweep_freq );
+	s( square1.phase );
+
+	s( square2.env_delay );
+	s( square2.sweep_delay );
+	s( square2.sweep_freq );
+	s( square2.phase );
+
+	s( wave.wave_pos );
+	s( wave.wave );
+
+	s( noise.env_delay );
+	s( noise.bits );
+
+	s( next_frame_time );
+	s( last_time );
+	s( frame_count );
+	s( regs );
+	if ( s.loading() )
+		update_volume();
+}
+
 static unsigned char const powerup_regs [0x20] = {
 	0x80,0x3F,0x00,0xFF,0xBF, // square 1
 	0xFF,0x3F,0x00,0xFF,0xBF, // square 2
@@ -50,6 +50,9 @@ public:
 
 	void set_tempo( double );
 
+	// Save/load emulation state in native format, without affecting settings
+	void copy_state( Emu_State& );
+
 public:
 	Gb_Apu();
 private:
@@ -2,6 +2,7 @@
 
 #include "Gb_Cpu.h"
 
+#include "Emu_State.h"
 #include <string.h>
 
 //#include "gb_cpu_log.h"
@@ -52,6 +53,13 @@ inline void Gb_Cpu::set_code_page( int i, uint8_t* p )
 	state->code_map [i] = p - PAGE_OFFSET( i * (int32_t) page_size );
 }
 
+void Gb_Cpu::copy_state( Emu_State& s )
+{
+	assert( state == &state_ );
+	s( r );
+	s( state_ );
+}
+
 void Gb_Cpu::reset( void* unmapped )
 {
 	check( state == &state_ );
@@ -123,6 +131,7 @@ bool Gb_Cpu::run( int32_t cycle_count )
 	unsigned flags = r.flags;
 
 loop:
+	GME_STAT( instr_count_++ );
 
 	check( (unsigned long) pc < 0x10000 );
 	check( (unsigned long) sp < 0x10000 );
@@ -8,6 +8,8 @@
 #include "blargg_common.h"
 #include "blargg_endian.h"
 
+class Emu_State;
+
 typedef unsigned gb_addr_t; // 16-bit CPU address
 
 class Gb_Cpu {
@@ -60,8 +62,14 @@ public:
 	// Can read this many bytes past end of a page
 	enum { cpu_padding = 8 };
 
+	// Number of instructions executed. Only counted if GME_STATS is defined.
+	uint64_t instr_count() const        { return instr_count_; }
+
+	// Save/load registers, timing and memory map. Can't be called during run().
+	void copy_state( Emu_State& );
+
 public:
-	Gb_Cpu() : rst_base( 0 ) { state = &state_; }
+	Gb_Cpu() : rst_base( 0 ) { state = &state_; instr_count_ = 0; }
 	enum { page_shift = 13 };
 	enum { page_count = 0x10000 >> page_shift };
 private:
@@ -75,6 +83,7 @@ private:
 	};
 	state_t* state; // points to state_ or a local copy within run()
 	state_t state_;
+	uint64_t instr_count_;
 
 	void set_code_page( int, uint8_t* );
 };
@@ -109,7 +109,17 @@ blargg_err_t Gbs_Emu::load_( Data_Reader& in )
 {
 	blaarg_static_assert( offsetof (header_t,copyright [32]) == header_size, "GBS Header layout incorrect!" );
 	RETURN_ERR( rom.load( in, header_size, &header_, 0 ) );
+	return finish_load();
+}
+
+blargg_err_t Gbs_Emu::load_mem_( byte const* in, long size )
+{
+	RETURN_ERR( rom.load( in, size, header_size, &header_, 0 ) );
+	return finish_load();
+}
 
+blargg_err_t Gbs_Emu::finish_load()
+{
 	set_track_count( header_.track_count );
 	RETURN_ERR( check_gbs_header( &header_ ) );
 
@@ -124,6 +134,10 @@ blargg_err_t Gbs_Emu::load_( Data_Reader& in )
 			load_addr < 0x400 )
 		set_warning( "Invalid load/init/play address" );
 
+	// map ROM here rather than in start_track_(), so that saved state's code
+	// pointers into it stay valid until another file is loaded
+	RETURN_ERR( rom.set_addr( load_addr ) );
+
 	set_voice_count( Gb_Apu::osc_count );
 
 	apu.volume( gain() );
@@ -217,7 +231,6 @@ blargg_err_t Gbs_Emu::start_track_( int track )
 		apu.write_register( 0, i + apu.start_addr, sound_data [i] );
 
 	unsigned load_addr = get_le16( header_.load_addr );
-	rom.set_addr( load_addr );
 	cpu::rst_base = load_addr;
 
 	cpu::reset( rom.unmapped() );
@@ -240,6 +253,24 @@ blargg_err_t Gbs_Emu::start_track_( int track )
 	return 0;
 }
 
+void Gbs_Emu::copy_state_( Emu_State& s )
+{
+	Classic_Emu::copy_state_( s );
+	cpu::copy_state( s );
+	s( ram );
+	s( cpu_time );
+	s( next_play );
+	apu.copy_state( s );
+	if ( s.loading() )
+		update_timer();
+}
+
+void Gbs_Emu::get_stats_( stats_t* out ) const
+{
+	Classic_Emu::get_stats_( out );
+	out->cpu_instructions += cpu::instr_count();
+}
+
 blargg_err_t Gbs_Emu::run_clocks( blip_time_t& duration, int )
 {
 	cpu_time = 0;
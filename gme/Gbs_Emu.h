@@ -51,17 +51,21 @@ public:
 protected:
 	blargg_err_t track_info_( track_info_t*, int track ) const;
 	blargg_err_t load_( Data_Reader& );
+	blargg_err_t load_mem_( byte const*, long );
 	blargg_err_t start_track_( int );
 	blargg_err_t run_clocks( blip_time_t&, int );
 	void set_tempo_( double );
 	void set_voice( int, Blip_Buffer*, Blip_Buffer*, Blip_Buffer* );
 	void update_eq( blip_eq_t const& );
 	void unload();
+	void copy_state_( Emu_State& );
+	void get_stats_( stats_t* ) const;
 private:
 	// rom
 	enum { bank_size = 0x4000 };
 	Rom_Data<bank_size> rom;
 	void set_bank( int );
+	blargg_err_t finish_load();
 
 	// timer
 	blip_time_t cpu_time;
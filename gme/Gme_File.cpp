@@ -33,6 +33,9 @@ void Gme_File::unload()
 	track_count_     = 0;
 	raw_track_count_ = 0;
 	file_data.clear();
+	tracks.clear();
+	// mapped_file is closed by the next load_mem(), load_tracks() or load_file*()
+	// instead, since NSFE loads its NSF data from it through a nested load()
 }
 
 Gme_File::Gme_File()
@@ -92,12 +95,14 @@ blargg_err_t Gme_File::post_load( blargg_err_t err )
 blargg_err_t Gme_File::load_mem( void const* in, long size )
 {
 	pre_load();
+	mapped_file.close();
 	return post_load( load_mem_( (byte const*) in, size ) );
 }
 
 blargg_err_t Gme_File::load_tracks( void const* in, long* sizes, int count )
 {
 	pre_load();
+	mapped_file.close();
 	if ( type()->track_count != 1 )
 		return "File type must have a fixed track count of 1";
 	set_track_count( count );
@@ -120,6 +125,33 @@ blargg_err_t Gme_File::load( Data_Reader& in )
 blargg_err_t Gme_File::load_file( const char* path )
 {
 	pre_load();
+	mapped_file.close();
+	GME_FILE_READER in;
+	RETURN_ERR( in.open( path ) );
+	return post_load( load_( in ) );
+}
+
+blargg_err_t Gme_File::load_file_mapped( const char* path )
+{
+	pre_load();
+	mapped_file.close();
+
+	// use uncompressed file in place, rather than reading it into memory, unless
+	// type converts data when loading (flag 0x04), which would only copy it
+	if ( !(type_->flags_ & 0x04) && !mapped_file.open( path ) )
+	{
+		byte const* data = (byte const*) mapped_file.data();
+		long size = mapped_file.size();
+		if ( size < 2 || data [0] != 0x1F || data [1] != 0x8B )
+		{
+			blargg_err_t err = post_load( load_mem_( data, size ) );
+			if ( err )
+				mapped_file.close();
+			return err;
+		}
+		mapped_file.close();
+	}
+
 	GME_FILE_READER in;
 	RETURN_ERR( in.open( path ) );
 	return post_load( load_( in ) );
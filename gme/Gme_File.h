@@ -21,7 +21,8 @@ struct gme_type_t_
 
 	/* internal */
 	const char* extension_;
-	int flags_;
+	int flags_;                 /* 0x01: uses Effects_Buffer, 0x02: m3u tracks are 0-based,
+	                               0x04: data is converted when loaded, never used in place */
 };
 
 struct track_info_t
@@ -69,6 +70,12 @@ public:
 	// Load from file on disk
 	blargg_err_t load_file( const char* path );
 
+	// Same as load_file(), but memory-maps uncompressed files where supported (see
+	// HAVE_MMAP) and uses them in place, so pages are only read when accessed. File
+	// must not be truncated or modified until another file is loaded, or playback
+	// changes or the process crashes (SIGBUS). Reads file if it can't be mapped.
+	blargg_err_t load_file_mapped( const char* path );
+
 	// Load from custom data source (see Data_Reader.h)
 	blargg_err_t load( Data_Reader& );
 
@@ -133,6 +140,7 @@ protected:
 
 	const byte* track_pos( int i ) { return &file_data[tracks[i]]; }
 	long track_size( int i ) { return tracks[i + 1] - tracks[i]; }
+	bool has_track_data() const { return tracks.size() != 0; } // false if loaded with load_mem()
 
 	// Overridable
 	virtual void unload();  // called before loading file and if loading fails
@@ -160,6 +168,7 @@ private:
 	char playlist_warning [64];
 	blargg_vector<byte> file_data; // only if loaded into memory using default load
 	blargg_vector<long> tracks;    // file start indexes of `file_data`
+	Mapped_File_Reader mapped_file; // file loaded by load_file_mapped(), if it could be mapped
 
 	blargg_err_t load_m3u_( blargg_err_t );
 	blargg_err_t post_load( blargg_err_t err );
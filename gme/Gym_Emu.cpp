@@ -200,6 +200,13 @@ void Gym_Emu::set_tempo_( double t )
 	}
 }
 
+void Gym_Emu::set_quality_( int q )
+{
+	Music_Emu::set_quality_( q );
+	blip_buf.set_synth_quality( q );
+	Dual_Resampler::set_resampler_quality( q );
+}
+
 void Gym_Emu::mute_voices_( int mask )
 {
 	Music_Emu::mute_voices_( mask );
@@ -247,6 +254,39 @@ blargg_err_t Gym_Emu::start_track_( int track )
 	return 0;
 }
 
+void Gym_Emu::copy_state_( Emu_State& s )
+{
+	Music_Emu::copy_state_( s );
+
+	long offset = pos - data;
+	s( offset );
+	long loop_offset = loop_begin ? loop_begin - data : -1;
+	s( loop_offset );
+	if ( (unsigned long) offset > (unsigned long) (data_end - data) ||
+			(loop_offset >= 0 && loop_offset > data_end - data) )
+	{
+		s.set_corrupt();
+		offset = data_end - data;
+		loop_offset = -1;
+	}
+	pos        = data + offset;
+	loop_begin = (loop_offset >= 0 ? data + loop_offset : 0);
+
+	s( loop_remain );
+	s( dac_amp );
+	s( prev_dac_count );
+	s( dac_enabled );
+	fm.copy_state( s );
+	apu.copy_state( s );
+	blip_buf.copy_state( s );
+	Dual_Resampler::copy_state( s );
+}
+
+void Gym_Emu::get_stats_( stats_t* out ) const
+{
+	Dual_Resampler::get_stats( out, blip_buf );
+}
+
 void Gym_Emu::run_dac( int dac_count )
 {
 	// Guess beginning and end of sample and adjust rate and buffer position accordingly.
@@ -317,6 +357,7 @@ void Gym_Emu::parse_frame()
 				if ( data == 0x2B )
 					dac_enabled = (data2 & 0x80) != 0;
 
+				GME_STAT( stats.apu_writes++ );
 				fm.write0( data, data2 );
 			}
 			else if ( dac_count < (int) sizeof dac_buf )
@@ -327,10 +368,12 @@ void Gym_Emu::parse_frame()
 		}
 		else if ( cmd == 2 )
 		{
+			GME_STAT( stats.apu_writes++ );
 			fm.write1( data, *pos++ );
 		}
 		else if ( cmd == 3 )
 		{
+			GME_STAT( stats.apu_writes++ );
 			apu.write_data( 0, data );
 		}
 		else
@@ -378,3 +421,22 @@ blargg_err_t Gym_Emu::play_( long count, sample_t* out )
 	Dual_Resampler::dual_play( count, out, blip_buf );
 	return 0;
 }
+
+blargg_err_t Gym_Emu::play_float_( long count, float* out )
+{
+	Dual_Resampler::dual_play( count, out, blip_buf );
+	return 0;
+}
+
+blargg_err_t Gym_Emu::skip_( long count )
+{
+	// for long skip, run FM chip muted without resampling or mixing
+	if ( count > skip_threshold )
+	{
+		mute_voices_( ~0 );
+		while ( count > skip_threshold / 2 && !emu_track_ended() )
+			count -= skip_frame( blip_buf );
+		remute_voices();
+	}
+	return Music_Emu::skip_( count );
+}
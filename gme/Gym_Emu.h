@@ -49,8 +49,13 @@ protected:
 	blargg_err_t set_sample_rate_( long sample_rate );
 	blargg_err_t start_track_( int );
 	blargg_err_t play_( long count, sample_t* );
+	blargg_err_t play_float_( long count, float* );
+	blargg_err_t skip_( long count );
 	void mute_voices_( int );
 	void set_tempo_( double );
+	void set_quality_( int );
+	void copy_state_( Emu_State& );
+	void get_stats_( stats_t* ) const;
 	int play_frame( blip_time_t blip_time, int sample_count, sample_t* buf );
 private:
 	// sequence data begin, loop begin, current position, end
@@ -2,6 +2,7 @@
 
 #include "Hes_Apu.h"
 
+#include "Emu_State.h"
 #include <string.h>
 
 /* Copyright (C) 2006 Shay Green. This module is free software; you
@@ -69,6 +70,29 @@ void Hes_Apu::osc_output( int index, Blip_Buffer* center, Blip_Buffer* left, Bli
 	while ( osc != oscs );
 }
 
+void Hes_Apu::copy_state( Emu_State& s )
+{
+	s( latch );
+	s( balance );
+	for ( int i = 0; i < osc_count; i++ )
+	{
+		Hes_Osc& osc = oscs [i];
+		s( osc.wave );
+		s( osc.last_amp );
+		s( osc.delay );
+		s( osc.period );
+		s( osc.noise );
+		s( osc.phase );
+		s( osc.balance );
+		s( osc.dac );
+		s( osc.last_time );
+		s( osc.noise_lfsr );
+		s( osc.control );
+		if ( s.loading() )
+			balance_changed( osc );
+	}
+}
+
 void Hes_Osc::run_until( synth_t& synth_, blip_time_t end_time )
 {
 	Blip_Buffer* const osc_outputs_0 = outputs [0]; // cache often-used values
@@ -47,6 +47,9 @@ public:
 
 	void end_frame( blip_time_t );
 
+	// Save/load emulation state in native format, without affecting settings
+	void copy_state( Emu_State& );
+
 public:
 	Hes_Apu();
 private:
@@ -2,6 +2,8 @@
 
 #include "Hes_Apu_Adpcm.h"
 
+#include "Emu_State.h"
+
 /* Copyright (C) 2006-2008 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -26,6 +28,14 @@ Hes_Apu_Adpcm::Hes_Apu_Adpcm()
 	reset();
 }
 
+void Hes_Apu_Adpcm::copy_state( Emu_State& s )
+{
+	s( state );
+	s( last_time );
+	s( next_timer );
+	s( last_amp );
+}
+
 void Hes_Apu_Adpcm::reset()
 {
 	last_time = 0;
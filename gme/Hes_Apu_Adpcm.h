@@ -44,6 +44,9 @@ public:
 	enum { io_addr = 0x1800 };
 	enum { io_size = 0x400 };
 	
+	// Save/load emulation state in native format, without affecting settings
+	void copy_state( Emu_State& );
+	
 // Implementation
 public:
 	Hes_Apu_Adpcm();
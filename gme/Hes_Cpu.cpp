@@ -2,6 +2,7 @@
 
 #include "Hes_Cpu.h"
 
+#include "Emu_State.h"
 #include "blargg_endian.h"
 
 //#include "hes_cpu_log.h"
@@ -48,6 +49,17 @@ enum {
     st_c = 0x01
 };
 
+void Hes_Cpu::copy_state( Emu_State& s )
+{
+	assert( state == &state_ );
+	s( ram );
+	s( r );
+	s( mmr );
+	s( state_ );
+	s( irq_time_ );
+	s( end_time_ );
+}
+
 void Hes_Cpu::reset()
 {
 	check( state == &state_ );
@@ -134,6 +146,7 @@ bool Hes_Cpu::run( hes_time_t end_time )
 branch_not_taken:
 	s_time -= 2;
 loop:
+	GME_STAT( instr_count_++ );
 
 	#ifndef NDEBUG
 	{
@@ -6,6 +6,8 @@
 
 #include "blargg_common.h"
 
+class Emu_State;
+
 typedef int32_t hes_time_t; // clock cycle count
 typedef unsigned hes_addr_t; // 16-bit address
 enum { future_hes_time = INT_MAX / 2 + 1 };
@@ -62,8 +64,14 @@ public:
 	// Can read this many bytes past end of a page
 	enum { cpu_padding = 8 };
 
+	// Number of instructions executed. Only counted if GME_STATS is defined.
+	uint64_t instr_count() const        { return instr_count_; }
+
+	// Save/load registers, timing, memory map and RAM. Can't be called during run().
+	void copy_state( Emu_State& );
+
 public:
-	Hes_Cpu() { state = &state_; }
+	Hes_Cpu() { state = &state_; instr_count_ = 0; }
 	enum { irq_inhibit = 0x04 };
 private:
 	// noncopyable
@@ -77,6 +85,7 @@ private:
 	};
 	state_t* state; // points to state_ or a local copy within run()
 	state_t state_;
+	uint64_t instr_count_;
 	hes_time_t irq_time_;
 	hes_time_t end_time_;
 
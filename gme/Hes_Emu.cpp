@@ -146,7 +146,17 @@ blargg_err_t Hes_Emu::load_( Data_Reader& in )
 {
 	blaarg_static_assert( offsetof (header_t,unused [4]) == header_size, "HES header layout is incorrect!" );
 	RETURN_ERR( rom.load( in, header_size, &header_, unmapped ) );
+	return finish_load();
+}
+
+blargg_err_t Hes_Emu::load_mem_( byte const* in, long size )
+{
+	RETURN_ERR( rom.load( in, size, header_size, &header_, unmapped ) );
+	return finish_load();
+}
 
+blargg_err_t Hes_Emu::finish_load()
+{
 	RETURN_ERR( check_hes_header( header_.tag ) );
 
 	if ( header_.vers != 0 )
@@ -183,7 +193,7 @@ blargg_err_t Hes_Emu::load_( Data_Reader& in )
 			set_warning( "Missing file data" );
 	}
 
-	rom.set_addr( addr );
+	RETURN_ERR( rom.set_addr( addr ) );
 
 	set_voice_count( apu.osc_count );
 
@@ -292,6 +302,7 @@ void Hes_Emu::cpu_write_( hes_addr_t addr, int data )
 {
 	if ( unsigned (addr - apu.start_addr) <= apu.end_addr - apu.start_addr )
 	{
+		GME_STAT( stats.apu_writes++ );
 		GME_APU_HOOK( this, addr - apu.start_addr, data );
 		// avoid going way past end when a long block xfer is writing to I/O space
 		hes_time_t t = min( time(), end_time() + 8 );
@@ -301,6 +312,7 @@ void Hes_Emu::cpu_write_( hes_addr_t addr, int data )
 
 	if ( (unsigned) (addr - adpcm.io_addr) < adpcm.io_size )
 	{
+		GME_STAT( stats.apu_writes++ );
 		time_t t = min( time(), end_time() + 6 );
 		adpcm.write_data( t, addr, data );
 		return;
@@ -522,6 +534,28 @@ static void adjust_time( int32_t& time, hes_time_t delta )
 	}
 }
 
+void Hes_Emu::copy_state_( Emu_State& s )
+{
+	Classic_Emu::copy_state_( s );
+	Hes_Cpu::copy_state( s );
+	s( write_pages ); // point into ram and sgx
+	s( last_frame_hook );
+	s( timer );
+	s( vdp );
+	s( irq );
+	s( sgx );
+	apu.copy_state( s );
+	adpcm.copy_state( s );
+	if ( s.loading() )
+		recalc_timer_load();
+}
+
+void Hes_Emu::get_stats_( stats_t* out ) const
+{
+	Classic_Emu::get_stats_( out );
+	out->cpu_instructions += cpu::instr_count();
+}
+
 blargg_err_t Hes_Emu::run_clocks( blip_time_t& duration_, int )
 {
 	blip_time_t const duration = duration_; // cache
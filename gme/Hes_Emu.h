@@ -38,12 +38,15 @@ public:
 protected:
 	blargg_err_t track_info_( track_info_t*, int track ) const;
 	blargg_err_t load_( Data_Reader& );
+	blargg_err_t load_mem_( byte const*, long );
 	blargg_err_t start_track_( int );
 	blargg_err_t run_clocks( blip_time_t&, int );
 	void set_tempo_( double );
 	void set_voice( int, Blip_Buffer*, Blip_Buffer*, Blip_Buffer* );
 	void update_eq( blip_eq_t const& );
 	void unload();
+	void copy_state_( Emu_State& );
+	void get_stats_( stats_t* ) const;
 public: private: friend class Hes_Cpu;
 	byte* write_pages [page_count + 1]; // 0 if unmapped or I/O space
 
@@ -57,6 +60,7 @@ public: private: friend class Hes_Cpu;
 private:
 	Rom_Data<page_size> rom;
 	header_t header_;
+	blargg_err_t finish_load();
 	hes_time_t play_period;
 	hes_time_t last_frame_hook;
 	int timer_base;
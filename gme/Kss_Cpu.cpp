@@ -8,6 +8,7 @@ Last validated with zexall 2006.11.14 2:19 PM
 
 #include "Kss_Cpu.h"
 
+#include "Emu_State.h"
 #include "blargg_endian.h"
 #include <string.h>
 
@@ -64,6 +65,7 @@ enum {
 Kss_Cpu::Kss_Cpu()
 {
 	state = &state_;
+	instr_count_ = 0;
 
 	for ( int i = 0x100; --i >= 0; )
 	{
@@ -113,6 +115,14 @@ void Kss_Cpu::map_mem( unsigned addr, uint32_t size, void* write, void const* re
 	}
 }
 
+void Kss_Cpu::copy_state( Emu_State& s )
+{
+	assert( state == &state_ );
+	s( r );
+	s( state_ );
+	s( end_time_ );
+}
+
 #define TIME                        (s_time + s.base)
 #define RW_MEM( addr, rw )          (s.rw [(addr) >> page_shift] [KSS_CPU_PAGE_OFFSET( addr )])
 #define READ_PROG( addr )           RW_MEM( addr, read )
@@ -195,6 +205,7 @@ call_not_taken:
 jp_not_taken:
 	pc += 2;
 loop:
+	GME_STAT( instr_count_++ );
 
 	check( (unsigned long) pc < 0x10000 );
 	check( (unsigned long) sp < 0x10000 );
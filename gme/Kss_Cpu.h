@@ -6,6 +6,8 @@
 
 #include "blargg_endian.h"
 
+class Emu_State;
+
 typedef int32_t cpu_time_t;
 
 // must be defined by caller
@@ -73,6 +75,13 @@ public:
 	// can read this far past end of a page
 	static const unsigned int cpu_padding = 0x100;
 
+	// Number of instructions executed. Only counted if GME_STATS is defined.
+	uint64_t instr_count() const        { return instr_count_; }
+
+	// Save/load registers, timing and memory map. Memory isn't included. Can't be
+	// called during run().
+	void copy_state( Emu_State& );
+
 public:
 	Kss_Cpu();
 	static const unsigned int page_shift = 13;
@@ -88,6 +97,7 @@ private:
 	};
 	state_t* state; // points to state_ or a local copy within run()
 	state_t state_;
+	uint64_t instr_count_;
 	void set_end_time( cpu_time_t t );
 	void set_page( int i, void* write, void const* read );
 public:
@@ -117,6 +117,7 @@ extern gme_type_t const gme_kss_type = &gme_kss_type_;
 void Kss_Emu::update_gain()
 {
 	double g = gain() * 1.4;
+	scc_gain = scc_accessed;
 	if ( scc_accessed )
 		g *= 1.5;
 	ay.volume( g );
@@ -131,7 +132,18 @@ blargg_err_t Kss_Emu::load_( Data_Reader& in )
 	blaarg_static_assert( offsetof (header_t,device_flags) == header_size - 1, "KSS Header layout incorrect!" );
 	blaarg_static_assert( offsetof (ext_header_t,msx_audio_vol) == ext_header_size - 1, "KSS Extended Header layout incorrect!" );
 	RETURN_ERR( rom.load( in, header_size, STATIC_CAST(header_t*,&header_), 0 ) );
+	return finish_load();
+}
+
+blargg_err_t Kss_Emu::load_mem_( byte const* in, long size )
+{
+	memset( &header_, 0, sizeof header_ );
+	RETURN_ERR( rom.load( in, size, header_size, STATIC_CAST(header_t*,&header_), 0 ) );
+	return finish_load();
+}
 
+blargg_err_t Kss_Emu::finish_load()
+{
 	RETURN_ERR( check_kss_header( header_.tag ) );
 
 	if ( header_.tag [3] == 'C' )
@@ -167,6 +179,15 @@ blargg_err_t Kss_Emu::load_( Data_Reader& in )
 
 	set_voice_count( osc_count );
 
+	// map banks here rather than in start_track_(), so that saved state's
+	// pointers into them stay valid until another file is loaded
+	RETURN_ERR( rom.set_addr( -nonbanked_size() - header_.extra_header ) );
+
+	// calculate treble eq at the volume tracks start with, rather than whatever
+	// volume the previous file left, so that reloading gives identical output
+	scc_accessed = false;
+	update_gain();
+
 	return setup_buffer( ::clock_rate );
 }
 
@@ -191,6 +212,13 @@ void Kss_Emu::set_voice( int i, Blip_Buffer* center, Blip_Buffer* left, Blip_Buf
 
 // Emulation
 
+// Size of data copied into RAM by start_track_(), before the banked data
+long Kss_Emu::nonbanked_size() const
+{
+	long load_size = min( (long) get_le16( header_.load_size ), rom.file_size() );
+	return min( load_size, long (mem_size - get_le16( header_.load_addr )) );
+}
+
 void Kss_Emu::set_tempo_( double t )
 {
 	blip_time_t period =
@@ -219,15 +247,11 @@ blargg_err_t Kss_Emu::start_track_( int track )
 
 	// copy non-banked data into RAM
 	unsigned load_addr = get_le16( header_.load_addr );
-	long orig_load_size = get_le16( header_.load_size );
-	long load_size = min( orig_load_size, rom.file_size() );
-	load_size = min( load_size, long (mem_size - load_addr) );
-	if ( load_size != orig_load_size )
+	long load_size = nonbanked_size();
+	if ( load_size != get_le16( header_.load_size ) )
 		set_warning( "Excessive data size" );
 	memcpy( ram + load_addr, rom.begin() + header_.extra_header, load_size );
 
-	rom.set_addr( -load_size - header_.extra_header );
-
 	// check available bank data
 	int32_t const bank_size = this->bank_size();
 	int max_banks = (rom.file_size() - load_size + bank_size - 1) / bank_size;
@@ -304,6 +328,7 @@ void Kss_Emu::cpu_write( unsigned addr, int data )
 	if ( scc_addr < scc.reg_count )
 	{
 		scc_accessed = true;
+		GME_STAT( stats.apu_writes++ );
 		scc.write( time(), scc_addr, data );
 		return;
 	}
@@ -329,6 +354,7 @@ void kss_cpu_out( Kss_Cpu* cpu, cpu_time_t time, unsigned addr, int data )
 		return;
 
 	case 0xA1:
+		GME_STAT( emu.stats.apu_writes++ );
 		GME_APU_HOOK( &emu, emu.ay_latch, data );
 		emu.ay.write( time, emu.ay_latch, data );
 		return;
@@ -336,6 +362,7 @@ void kss_cpu_out( Kss_Cpu* cpu, cpu_time_t time, unsigned addr, int data )
 	case 0x06:
 		if ( emu.sn && (emu.header_.device_flags & 0x04) )
 		{
+			GME_STAT( emu.stats.apu_writes++ );
 			emu.sn->write_ggstereo( time, data );
 			return;
 		}
@@ -345,6 +372,7 @@ void kss_cpu_out( Kss_Cpu* cpu, cpu_time_t time, unsigned addr, int data )
 	case 0x7F:
 		if ( emu.sn )
 		{
+			GME_STAT( emu.stats.apu_writes++ );
 			GME_APU_HOOK( &emu, 16, data );
 			emu.sn->write_data( time, data );
 			return;
@@ -381,6 +409,39 @@ int kss_cpu_in( Kss_Cpu*, cpu_time_t, unsigned addr )
 
 // Emulation
 
+void Kss_Emu::copy_state_( Emu_State& s )
+{
+	Classic_Emu::copy_state_( s );
+	Kss_Cpu::copy_state( s );
+	s( ram );
+	s( next_play );
+	s( ay_latch );
+	s( gain_updated );
+
+	// restore gain that was in effect
+	bool gain_was_scc = scc_gain;
+	s( scc_gain );
+	s( scc_accessed );
+	if ( scc_gain != gain_was_scc )
+	{
+		bool accessed = scc_accessed;
+		scc_accessed = scc_gain;
+		update_gain();
+		scc_accessed = accessed;
+	}
+
+	ay.copy_state( s );
+	scc.copy_state( s );
+	if ( sn )
+		sn->copy_state( s );
+}
+
+void Kss_Emu::get_stats_( stats_t* out ) const
+{
+	Classic_Emu::get_stats_( out );
+	out->cpu_instructions += cpu::instr_count();
+}
+
 blargg_err_t Kss_Emu::run_clocks( blip_time_t& duration, int )
 {
 	while ( time() < duration )
@@ -53,24 +53,30 @@ public:
 protected:
 	blargg_err_t track_info_( track_info_t*, int track ) const;
 	blargg_err_t load_( Data_Reader& );
+	blargg_err_t load_mem_( byte const*, long );
 	blargg_err_t start_track_( int );
 	blargg_err_t run_clocks( blip_time_t&, int );
 	void set_tempo_( double );
 	void set_voice( int, Blip_Buffer*, Blip_Buffer*, Blip_Buffer* );
 	void update_eq( blip_eq_t const& );
 	void unload();
+	void copy_state_( Emu_State& );
+	void get_stats_( stats_t* ) const;
 private:
 	Rom_Data<page_size> rom;
 	composite_header_t header_;
+	blargg_err_t finish_load();
 
 	bool scc_accessed;
 	bool gain_updated;
+	bool scc_gain;          // gain was last updated with scc_accessed set
 	void update_gain();
 
 	unsigned scc_enabled; // 0 or 0xC000
 	int bank_count;
 	void set_bank( int logical, int physical );
 	int32_t bank_size() const { return (16 * 1024L) >> (header_.bank_mode >> 7 & 1); }
+	long nonbanked_size() const;
 
 	blip_time_t play_period;
 	blip_time_t next_play;
@@ -2,6 +2,8 @@
 
 #include "Kss_Scc_Apu.h"
 
+#include "Emu_State.h"
+
 /* Copyright (C) 2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -21,6 +23,18 @@ static unsigned const inaudible_freq = 16384;
 
 static int const wave_size = 0x20;
 
+void Scc_Apu::copy_state( Emu_State& s )
+{
+	for ( int i = 0; i < osc_count; i++ )
+	{
+		s( oscs [i].delay );
+		s( oscs [i].phase );
+		s( oscs [i].last_amp );
+	}
+	s( last_time );
+	s( regs );
+}
+
 void Scc_Apu::run_until( blip_time_t end_time )
 {
 	for ( int index = 0; index < osc_count; index++ )
@@ -38,6 +38,9 @@ public:
 	// Set treble equalization (see documentation)
 	void treble_eq( blip_eq_t const& );
 
+	// Save/load emulation state in native format, without affecting settings
+	void copy_state( Emu_State& );
+
 public:
 	Scc_Apu();
 private:
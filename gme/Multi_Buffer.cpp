@@ -2,6 +2,11 @@
 
 #include "Multi_Buffer.h"
 
+#include "Emu_State.h"
+#include "blargg_simd.h"
+#include <string.h>
+#include "gme.h"
+
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -28,6 +33,51 @@ Multi_Buffer::Multi_Buffer( int spf ) : samples_per_frame_( spf )
 
 blargg_err_t Multi_Buffer::set_channel_count( int ) { return 0; }
 
+void Multi_Buffer::add_stats( gme_stats_t* out, Blip_Buffer const* bufs, int count )
+{
+	for ( int i = 0; i < count; i++ )
+	{
+		out->synth_offsets += bufs [i].offset_count_;
+		out->blip_samples  += bufs [i].read_count_;
+	}
+}
+
+long Multi_Buffer::read_samples_float( float* out, long count )
+{
+	blip_sample_t temp [512];
+	int const max_chunk = (int) (sizeof temp / sizeof *temp);
+	int const chunk = max_chunk - max_chunk % samples_per_frame();
+
+	long total = 0;
+	while ( count )
+	{
+		long n = read_samples( temp, count < chunk ? count : chunk );
+		for ( long i = 0; i < n; i++ )
+			out [i] = temp [i] * (1.0f / 0x8000);
+		out   += n;
+		total += n;
+		count -= n;
+		if ( n < chunk )
+			break;
+	}
+	return total;
+}
+
+void Multi_Buffer::remove_samples( long count )
+{
+	blip_sample_t temp [512];
+	int const max_chunk = (int) (sizeof temp / sizeof *temp);
+	int const chunk = max_chunk - max_chunk % samples_per_frame();
+
+	while ( count )
+	{
+		long n = read_samples( temp, count < chunk ? count : chunk );
+		count -= n;
+		if ( n < chunk )
+			break;
+	}
+}
+
 // Silent_Buffer
 
 Silent_Buffer::Silent_Buffer() : Multi_Buffer( 1 ) // 0 channels would probably confuse
@@ -93,6 +143,20 @@ void Stereo_Buffer::clear()
 		bufs [i].clear();
 }
 
+void Stereo_Buffer::set_float_accum( bool b )
+{
+	for ( int i = 0; i < buf_count; i++ )
+		bufs [i].set_float_accum( b );
+}
+
+void Stereo_Buffer::copy_state( Emu_State& s )
+{
+	s( stereo_added );
+	s( was_stereo );
+	for ( int i = 0; i < buf_count; i++ )
+		bufs [i].copy_state( s );
+}
+
 void Stereo_Buffer::end_frame( blip_time_t clock_count )
 {
 	stereo_added = 0;
@@ -104,6 +168,56 @@ void Stereo_Buffer::end_frame( blip_time_t clock_count )
 }
 
 long Stereo_Buffer::read_samples( blip_sample_t* out, long count )
+{
+	return read_samples_( out, count );
+}
+
+long Stereo_Buffer::read_samples_float( float* out, long count )
+{
+	return read_samples_( out, count );
+}
+
+void Stereo_Buffer::remove_samples( long count )
+{
+	require( !(count & 1) ); // count must be even
+	count = (unsigned) count / 2;
+
+	long avail = bufs [0].samples_avail();
+	if ( count > avail )
+		count = avail;
+	if ( count )
+	{
+		// same buffers are used as when reading
+		int bufs_used = stereo_added | was_stereo;
+		if ( bufs_used <= 1 )
+		{
+			bufs [0].remove_samples( count );
+			bufs [1].remove_silence( count );
+			bufs [2].remove_silence( count );
+		}
+		else if ( bufs_used & 1 )
+		{
+			bufs [0].remove_samples( count );
+			bufs [1].remove_samples( count );
+			bufs [2].remove_samples( count );
+		}
+		else
+		{
+			bufs [0].remove_silence( count );
+			bufs [1].remove_samples( count );
+			bufs [2].remove_samples( count );
+		}
+
+		if ( !bufs [0].samples_avail() )
+		{
+			was_stereo   = stereo_added;
+			stereo_added = 0;
+		}
+	}
+}
+
+template<class T>
+long Stereo_Buffer::read_samples_( T* out, long count )
 {
 	require( !(count & 1) ); // count must be even
 	count = (unsigned) count / 2;
@@ -148,8 +262,332 @@ long Stereo_Buffer::read_samples( blip_sample_t* out, long count )
 	return count * 2;
 }
 
+// SIMD mixing runs the integrators of the center, left and right buffers in
+// lanes 0-2 of a vector, so that output is exactly the same as the portable code.
+// Unused buffers are treated as silent and their accumulators left unchanged.
+
+enum { mix_center = 1, mix_sides = 2 };
+
+#if BLARGG_SIMD_SSE2
+
+// Loads four samples from each buffer and transposes them into one vector per sample
+template<int mode>
+static inline void load4( Blip_Buffer const* bufs, long i, __m128i in [4] )
+{
+	__m128i const zero = _mm_setzero_si128();
+	__m128i c = zero, l = zero, r = zero;
+	if ( mode & mix_center )
+		c = _mm_loadu_si128( (__m128i const*) (bufs [0].buffer_ + i) );
+	if ( mode & mix_sides )
+	{
+		l = _mm_loadu_si128( (__m128i const*) (bufs [1].buffer_ + i) );
+		r = _mm_loadu_si128( (__m128i const*) (bufs [2].buffer_ + i) );
+	}
+	__m128i cl01 = _mm_unpacklo_epi32( c, l );
+	__m128i cl23 = _mm_unpackhi_epi32( c, l );
+	__m128i r01  = _mm_unpacklo_epi32( r, zero );
+	__m128i r23  = _mm_unpackhi_epi32( r, zero );
+	in [0] = _mm_unpacklo_epi64( cl01, r01 );
+	in [1] = _mm_unpackhi_epi64( cl01, r01 );
+	in [2] = _mm_unpacklo_epi64( cl23, r23 );
+	in [3] = _mm_unpackhi_epi64( cl23, r23 );
+}
+
+template<int mode>
+static inline __m128i load1( Blip_Buffer const* bufs, long i )
+{
+	return _mm_set_epi32( 0,
+			(mode & mix_sides ) ? bufs [2].buffer_ [i] : 0,
+			(mode & mix_sides ) ? bufs [1].buffer_ [i] : 0,
+			(mode & mix_center) ? bufs [0].buffer_ [i] : 0 );
+}
+
+// Returns current values and advances integrators
+static inline __m128i next( __m128i& accum, __m128i in, __m128i bass )
+{
+	__m128i s = accum;
+	accum = _mm_add_epi32( _mm_sub_epi32( accum, _mm_sra_epi32( accum, bass ) ), in );
+	return s;
+}
+
+// Adds center to left and right, giving output pair in lanes 0 and 1
+static inline __m128i add_center( __m128i s )
+{
+	s = _mm_srai_epi32( s, blip_sample_bits - 16 );
+	return _mm_add_epi32( _mm_shuffle_epi32( s, _MM_SHUFFLE( 0, 0, 2, 1 ) ),
+			_mm_shuffle_epi32( s, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+}
+
+static inline __m128 add_center_float( __m128i s )
+{
+	__m128 f = _mm_mul_ps( _mm_cvtepi32_ps( s ), _mm_set1_ps( blip_float_unit ) );
+	return _mm_add_ps( _mm_shuffle_ps( f, f, _MM_SHUFFLE( 0, 0, 2, 1 ) ),
+			_mm_shuffle_ps( f, f, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+}
+
+static inline void store4( blip_sample_t* out, __m128i const s [4] )
+{
+	__m128i p01 = _mm_unpacklo_epi64( add_center( s [0] ), add_center( s [1] ) );
+	__m128i p23 = _mm_unpacklo_epi64( add_center( s [2] ), add_center( s [3] ) );
+	_mm_storeu_si128( (__m128i*) out, _mm_packs_epi32( p01, p23 ) );
+}
+
+static inline void store4( float* out, __m128i const s [4] )
+{
+	_mm_storeu_ps( out,     _mm_movelh_ps( add_center_float( s [0] ), add_center_float( s [1] ) ) );
+	_mm_storeu_ps( out + 4, _mm_movelh_ps( add_center_float( s [2] ), add_center_float( s [3] ) ) );
+}
+
+static inline void store1( blip_sample_t* out, __m128i s )
+{
+	__m128i p = add_center( s );
+	int pair = _mm_cvtsi128_si32( _mm_packs_epi32( p, p ) );
+	memcpy( out, &pair, sizeof pair );
+}
+
+static inline void store1( float* out, __m128i s )
+{
+	_mm_storel_pi( (__m64*) out, add_center_float( s ) );
+}
+
+template<int mode,class T>
+static void mix_sse2( Blip_Buffer* bufs, T* out, long count )
+{
+	__m128i const bass = _mm_cvtsi32_si128( BLIP_READER_BASS( bufs [(mode & mix_sides) ? 1 : 0] ) );
+	__m128i accum = _mm_set_epi32( 0,
+			(mode & mix_sides ) ? bufs [2].reader_accum_ : 0,
+			(mode & mix_sides ) ? bufs [1].reader_accum_ : 0,
+			(mode & mix_center) ? bufs [0].reader_accum_ : 0 );
+
+	long const n = count & ~3;
+	for ( long i = 0; i < n; i += 4 )
+	{
+		__m128i in [4], s [4];
+		load4<mode>( bufs, i, in );
+		s [0] = next( accum, in [0], bass );
+		s [1] = next( accum, in [1], bass );
+		s [2] = next( accum, in [2], bass );
+		s [3] = next( accum, in [3], bass );
+		store4( out + i * 2, s );
+	}
+
+	for ( long i = n; i < count; i++ )
+		store1( out + i * 2, next( accum, load1<mode>( bufs, i ), bass ) );
+
+	if ( mode & mix_center )
+		bufs [0].reader_accum_ = _mm_cvtsi128_si32( accum );
+	if ( mode & mix_sides )
+	{
+		bufs [1].reader_accum_ = _mm_cvtsi128_si32( _mm_shuffle_epi32( accum, 1 ) );
+		bufs [2].reader_accum_ = _mm_cvtsi128_si32( _mm_shuffle_epi32( accum, 2 ) );
+	}
+}
+
+#endif
+
+#if BLARGG_SIMD_NEON
+
+// Loads four samples from each buffer and transposes them into one vector per sample
+template<int mode>
+static inline void load4( Blip_Buffer const* bufs, long i, int32x4_t in [4] )
+{
+	int32x4_t const zero = vdupq_n_s32( 0 );
+	int32x4_t c = zero, l = zero, r = zero;
+	if ( mode & mix_center )
+		c = vld1q_s32( bufs [0].buffer_ + i );
+	if ( mode & mix_sides )
+	{
+		l = vld1q_s32( bufs [1].buffer_ + i );
+		r = vld1q_s32( bufs [2].buffer_ + i );
+	}
+	int32x4x2_t cl = vzipq_s32( c, l );
+	int32x4x2_t r0 = vzipq_s32( r, zero );
+	in [0] = vcombine_s32( vget_low_s32 ( cl.val [0] ), vget_low_s32 ( r0.val [0] ) );
+	in [1] = vcombine_s32( vget_high_s32( cl.val [0] ), vget_high_s32( r0.val [0] ) );
+	in [2] = vcombine_s32( vget_low_s32 ( cl.val [1] ), vget_low_s32 ( r0.val [1] ) );
+	in [3] = vcombine_s32( vget_high_s32( cl.val [1] ), vget_high_s32( r0.val [1] ) );
+}
+
+template<int mode>
+static inline int32x4_t load1( Blip_Buffer const* bufs, long i )
+{
+	int32x4_t v = vdupq_n_s32( 0 );
+	if ( mode & mix_center )
+		v = vsetq_lane_s32( bufs [0].buffer_ [i], v, 0 );
+	if ( mode & mix_sides )
+	{
+		v = vsetq_lane_s32( bufs [1].buffer_ [i], v, 1 );
+		v = vsetq_lane_s32( bufs [2].buffer_ [i], v, 2 );
+	}
+	return v;
+}
+
+// Returns current values and advances integrators. Shifting left by a negative
+// amount is an arithmetic right shift.
+static inline int32x4_t next( int32x4_t& accum, int32x4_t in, int32x4_t neg_bass )
+{
+	int32x4_t s = accum;
+	accum = vaddq_s32( vsubq_s32( accum, vshlq_s32( accum, neg_bass ) ), in );
+	return s;
+}
+
+// Adds center to left and right, giving output pair
+static inline int32x2_t add_center( int32x4_t s )
+{
+	s = vshrq_n_s32( s, blip_sample_bits - 16 );
+	return vadd_s32( vget_low_s32( vextq_s32( s, s, 1 ) ), vdup_lane_s32( vget_low_s32( s ), 0 ) );
+}
+
+static inline float32x2_t add_center_float( int32x4_t s )
+{
+	float32x4_t f = vmulq_n_f32( vcvtq_f32_s32( s ), blip_float_unit );
+	return vadd_f32( vget_low_f32( vextq_f32( f, f, 1 ) ), vdup_lane_f32( vget_low_f32( f ), 0 ) );
+}
+
+static inline void store4( blip_sample_t* out, int32x4_t const s [4] )
+{
+	int16x4_t p01 = vqmovn_s32( vcombine_s32( add_center( s [0] ), add_center( s [1] ) ) );
+	int16x4_t p23 = vqmovn_s32( vcombine_s32( add_center( s [2] ), add_center( s [3] ) ) );
+	vst1q_s16( out, vcombine_s16( p01, p23 ) );
+}
+
+static inline void store4( float* out, int32x4_t const s [4] )
+{
+	vst1q_f32( out,     vcombine_f32( add_center_float( s [0] ), add_center_float( s [1] ) ) );
+	vst1q_f32( out + 4, vcombine_f32( add_center_float( s [2] ), add_center_float( s [3] ) ) );
+}
+
+static inline void store1( blip_sample_t* out, int32x4_t s )
+{
+	int32x2_t p = add_center( s );
+	int16x4_t pair = vqmovn_s32( vcombine_s32( p, p ) );
+	out [0] = vget_lane_s16( pair, 0 );
+	out [1] = vget_lane_s16( pair, 1 );
+}
+
+static inline void store1( float* out, int32x4_t s )
+{
+	vst1_f32( out, add_center_float( s ) );
+}
+
+template<int mode,class T>
+static void mix_neon( Blip_Buffer* bufs, T* out, long count )
+{
+	int32x4_t const neg_bass = vdupq_n_s32( -BLIP_READER_BASS( bufs [(mode & mix_sides) ? 1 : 0] ) );
+	int32x4_t accum = vdupq_n_s32( 0 );
+	if ( mode & mix_center )
+		accum = vsetq_lane_s32( bufs [0].reader_accum_, accum, 0 );
+	if ( mode & mix_sides )
+	{
+		accum = vsetq_lane_s32( bufs [1].reader_accum_, accum, 1 );
+		accum = vsetq_lane_s32( bufs [2].reader_accum_, accum, 2 );
+	}
+
+	long const n = count & ~3;
+	for ( long i = 0; i < n; i += 4 )
+	{
+		int32x4_t in [4], s [4];
+		load4<mode>( bufs, i, in );
+		s [0] = next( accum, in [0], neg_bass );
+		s [1] = next( accum, in [1], neg_bass );
+		s [2] = next( accum, in [2], neg_bass );
+		s [3] = next( accum, in [3], neg_bass );
+		store4( out + i * 2, s );
+	}
+
+	for ( long i = n; i < count; i++ )
+		store1( out + i * 2, next( accum, load1<mode>( bufs, i ), neg_bass ) );
+
+	if ( mode & mix_center )
+		bufs [0].reader_accum_ = vgetq_lane_s32( accum, 0 );
+	if ( mode & mix_sides )
+	{
+		bufs [1].reader_accum_ = vgetq_lane_s32( accum, 1 );
+		bufs [2].reader_accum_ = vgetq_lane_s32( accum, 2 );
+	}
+}
+
+#endif
+
+// Buffers using floating-point accumulation
+
+static inline void store_float( blip_sample_t* out, float s ) { *out = blip_float_to_sample( s ); }
+static inline void store_float( float* out, float s ) { *out = s; }
+
+// Mixes and returns true if buffers use floating-point accumulation, otherwise
+// returns false
+template<int mode,class T>
+static bool mix_float( Blip_Buffer* bufs, T* BLIP_RESTRICT out, long count )
+{
+	if ( !bufs [0].float_accum() )
+		return false;
+
+	float const bass = BLIP_FLOAT_READER_BASS( bufs [(mode & mix_sides) ? 1 : 0] );
+	BLIP_FLOAT_READER_BEGIN( center, bufs [0] );
+	BLIP_FLOAT_READER_BEGIN( left,   bufs [1] );
+	BLIP_FLOAT_READER_BEGIN( right,  bufs [2] );
+
+	for ( ; count; --count )
+	{
+		float c = 0.0f;
+		if ( mode & mix_center )
+		{
+			c = BLIP_FLOAT_READER_READ( center );
+			BLIP_FLOAT_READER_NEXT( center, bass );
+		}
+
+		float l = c;
+		float r = c;
+		if ( mode & mix_sides )
+		{
+			l += BLIP_FLOAT_READER_READ( left );
+			r += BLIP_FLOAT_READER_READ( right );
+			BLIP_FLOAT_READER_NEXT( left, bass );
+			BLIP_FLOAT_READER_NEXT( right, bass );
+		}
+
+		store_float( out,     l );
+		store_float( out + 1, r );
+		out += 2;
+	}
+
+	if ( mode & mix_center )
+		BLIP_FLOAT_READER_END( center, bufs [0] );
+	if ( mode & mix_sides )
+	{
+		BLIP_FLOAT_READER_END( left,  bufs [1] );
+		BLIP_FLOAT_READER_END( right, bufs [2] );
+	}
+	return true;
+}
+
+// Mixes using SIMD if available and returns true, otherwise returns false
+template<int mode,class T>
+static bool mix_simd( Blip_Buffer* bufs, T* out, long count )
+{
+	#if BLARGG_SIMD_SSE2
+		if ( blargg_cpu_features() & blargg_cpu_sse2 )
+		{
+			mix_sse2<mode>( bufs, out, count );
+			return true;
+		}
+	#elif BLARGG_SIMD_NEON
+		if ( blargg_cpu_features() & blargg_cpu_neon )
+		{
+			mix_neon<mode>( bufs, out, count );
+			return true;
+		}
+	#endif
+	(void) bufs; (void) out; (void) count;
+	return false;
+}
+
 void Stereo_Buffer::mix_stereo( blip_sample_t* out_, int32_t count )
 {
+	if ( mix_float<mix_center | mix_sides>( bufs, out_, count ) ||
+			mix_simd<mix_center | mix_sides>( bufs, out_, count ) )
+		return;
+
 	blip_sample_t* BLIP_RESTRICT out = out_;
 	int const bass = BLIP_READER_BASS( bufs [1] );
 	BLIP_READER_BEGIN( left, bufs [1] );
@@ -183,6 +621,10 @@ void Stereo_Buffer::mix_stereo( blip_sample_t* out_, int32_t count )
 
 void Stereo_Buffer::mix_stereo_no_center( blip_sample_t* out_, int32_t count )
 {
+	if ( mix_float<mix_sides>( bufs, out_, count ) ||
+			mix_simd<mix_sides>( bufs, out_, count ) )
+		return;
+
 	blip_sample_t* BLIP_RESTRICT out = out_;
 	int const bass = BLIP_READER_BASS( bufs [1] );
 	BLIP_READER_BEGIN( left, bufs [1] );
@@ -212,6 +654,10 @@ void Stereo_Buffer::mix_stereo_no_center( blip_sample_t* out_, int32_t count )
 
 void Stereo_Buffer::mix_mono( blip_sample_t* out_, int32_t count )
 {
+	if ( mix_float<mix_center>( bufs, out_, count ) ||
+			mix_simd<mix_center>( bufs, out_, count ) )
+		return;
+
 	blip_sample_t* BLIP_RESTRICT out = out_;
 	int const bass = BLIP_READER_BASS( bufs [0] );
 	BLIP_READER_BEGIN( center, bufs [0] );
@@ -230,3 +676,76 @@ void Stereo_Buffer::mix_mono( blip_sample_t* out_, int32_t count )
 
 	BLIP_READER_END( center, bufs [0] );
 }
+
+void Stereo_Buffer::mix_stereo( float* BLIP_RESTRICT out, int32_t count )
+{
+	if ( mix_float<mix_center | mix_sides>( bufs, out, count ) ||
+			mix_simd<mix_center | mix_sides>( bufs, out, count ) )
+		return;
+
+	int const bass = BLIP_READER_BASS( bufs [1] );
+	BLIP_READER_BEGIN( left, bufs [1] );
+	BLIP_READER_BEGIN( right, bufs [2] );
+	BLIP_READER_BEGIN( center, bufs [0] );
+
+	for ( ; count; --count )
+	{
+		float c = BLIP_READER_READ_FLOAT( center );
+		out [0] = c + BLIP_READER_READ_FLOAT( left );
+		out [1] = c + BLIP_READER_READ_FLOAT( right );
+		out += 2;
+
+		BLIP_READER_NEXT( center, bass );
+		BLIP_READER_NEXT( left, bass );
+		BLIP_READER_NEXT( right, bass );
+	}
+
+	BLIP_READER_END( center, bufs [0] );
+	BLIP_READER_END( right, bufs [2] );
+	BLIP_READER_END( left, bufs [1] );
+}
+
+void Stereo_Buffer::mix_stereo_no_center( float* BLIP_RESTRICT out, int32_t count )
+{
+	if ( mix_float<mix_sides>( bufs, out, count ) ||
+			mix_simd<mix_sides>( bufs, out, count ) )
+		return;
+
+	int const bass = BLIP_READER_BASS( bufs [1] );
+	BLIP_READER_BEGIN( left, bufs [1] );
+	BLIP_READER_BEGIN( right, bufs [2] );
+
+	for ( ; count; --count )
+	{
+		out [0] = BLIP_READER_READ_FLOAT( left );
+		out [1] = BLIP_READER_READ_FLOAT( right );
+		out += 2;
+
+		BLIP_READER_NEXT( left, bass );
+		BLIP_READER_NEXT( right, bass );
+	}
+
+	BLIP_READER_END( right, bufs [2] );
+	BLIP_READER_END( left, bufs [1] );
+}
+
+void Stereo_Buffer::mix_mono( float* BLIP_RESTRICT out, int32_t count )
+{
+	if ( mix_float<mix_center>( bufs, out, count ) ||
+			mix_simd<mix_center>( bufs, out, count ) )
+		return;
+
+	int const bass = BLIP_READER_BASS( bufs [0] );
+	BLIP_READER_BEGIN( center, bufs [0] );
+
+	for ( ; count; --count )
+	{
+		float s = BLIP_READER_READ_FLOAT( center );
+		BLIP_READER_NEXT( center, bass );
+		out [0] = s;
+		out [1] = s;
+		out += 2;
+	}
+
+	BLIP_READER_END( center, bufs [0] );
+}
@@ -7,6 +7,8 @@
 #include "blargg_common.h"
 #include "Blip_Buffer.h"
 
+struct gme_stats_t;
+
 // Interface to one or more Blip_Buffers mapped to one or more channels
 // consisting of left, center, and right buffers.
 class Multi_Buffer {
@@ -51,10 +53,30 @@ public:
 	virtual long read_samples( blip_sample_t*, long ) = 0;
 	virtual long samples_avail() const = 0;
 
+	// Same as read_samples(), but writes unclamped floating-point samples, where 1.0
+	// corresponds to a full-scale 16-bit sample. Default implementation converts
+	// the output of read_samples().
+	virtual long read_samples_float( float*, long );
+
+	// Removes count samples as read_samples() would, without mixing them. Default
+	// implementation reads them into a temporary buffer.
+	virtual void remove_samples( long count );
+
+	// Accumulate samples in floating-point (see Blip_Buffer::set_float_accum()).
+	// Default does nothing, leaving buffers fixed-point.
+	virtual void set_float_accum( bool ) { }
+
+	// Save/load samples waiting to be read, for emulator state. Default does nothing.
+	virtual void copy_state( Emu_State& ) { }
+
+	// Add counters of buffers to *out, for emulator statistics. Default does nothing.
+	virtual void get_stats( gme_stats_t* ) const { }
+
 public:
 	BLARGG_DISABLE_NOTHROW
 protected:
 	void channels_changed() { channels_changed_count_++; }
+	static void add_stats( gme_stats_t*, Blip_Buffer const* bufs, int count );
 private:
 	// noncopyable
 	Multi_Buffer( const Multi_Buffer& );
@@ -83,11 +105,19 @@ public:
 	void clear() override { buf.clear(); }
 	long samples_avail() const override { return buf.samples_avail(); }
 	long read_samples( blip_sample_t* p, long s ) override { return buf.read_samples( p, s ); }
+	long read_samples_float( float* p, long s ) override { return buf.read_samples( p, s ); }
+	void remove_samples( long s ) override { buf.remove_samples( s ); }
+	void set_float_accum( bool b ) override { buf.set_float_accum( b ); }
 	channel_t channel( int, int ) override { return chan; }
 	void end_frame( blip_time_t t ) override { buf.end_frame( t ); }
+	void copy_state( Emu_State& s ) override { buf.copy_state( s ); }
+	void get_stats( gme_stats_t* out ) const override { add_stats( out, &buf, 1 ); }
 };
 
-// Uses three buffers (one for center) and outputs stereo sample pairs.
+// Uses three buffers (one for center) and outputs stereo sample pairs. Buffers
+// aren't interleaved, since Blip_Synth adds each impulse to consecutive samples
+// of one buffer. Reading already mixes all three in one pass, and is limited by
+// their integrators rather than by memory bandwidth.
 class Stereo_Buffer : public Multi_Buffer {
 public:
 
@@ -105,9 +135,14 @@ public:
 	void clear() override;
 	channel_t channel( int, int ) override { return chan; }
 	void end_frame( blip_time_t ) override;
+	void copy_state( Emu_State& ) override;
+	void get_stats( gme_stats_t* out ) const override { add_stats( out, bufs, buf_count ); }
 
 	long samples_avail() const override { return bufs [0].samples_avail() * 2; }
 	long read_samples( blip_sample_t*, long ) override;
+	long read_samples_float( float*, long ) override;
+	void remove_samples( long ) override;
+	void set_float_accum( bool ) override;
 
 private:
 	enum { buf_count = 3 };
@@ -116,9 +151,13 @@ private:
 	int stereo_added;
 	int was_stereo;
 
+	template<class T> long read_samples_( T*, long );
 	void mix_stereo_no_center( blip_sample_t*, int32_t );
 	void mix_stereo( blip_sample_t*, int32_t );
 	void mix_mono( blip_sample_t*, int32_t );
+	void mix_stereo_no_center( float*, int32_t );
+	void mix_stereo( float*, int32_t );
+	void mix_mono( float*, int32_t );
 };
 
 // Silent_Buffer generates no samples, useful where no sound is wanted
@@ -134,6 +173,8 @@ public:
 	void end_frame( blip_time_t ) override { }
 	long samples_avail() const override { return 0; }
 	long read_samples( blip_sample_t*, long ) override { return 0; }
+	long read_samples_float( float*, long ) override { return 0; }
+	void remove_samples( long ) override { }
 };
 
 
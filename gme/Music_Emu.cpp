@@ -3,8 +3,11 @@
 #include "Music_Emu.h"
 
 #include "Multi_Buffer.h"
+#include "blargg_simd.h"
 #include <string.h>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
@@ -24,6 +27,28 @@ static int const silence_threshold = 0x10;
 static long const fade_block_size = 512;
 static int const fade_shift = 8; // fade ends with gain at 1.0 / (1 << fade_shift)
 
+// shared by all emulators, so state saved by one (even one since deleted) is never
+// accepted by another
+static std::atomic<unsigned long> last_load_id( 0 );
+
+// Differs between processes (and runs of the same program), since saved state
+// holds pointers that are only valid in the process which saved it
+static unsigned long make_process_nonce()
+{
+	static char const local = 0; // address varies with address space randomization
+	unsigned long n = (unsigned long)
+			std::chrono::high_resolution_clock::now().time_since_epoch().count();
+	n = n * 0x9E3779B1 + (unsigned long) (size_t) &local;
+	n = n * 0x9E3779B1 + (unsigned long) (size_t) &n;
+	return n ^ (n >> 15);
+}
+
+static unsigned long process_nonce()
+{
+	static unsigned long const nonce = make_process_nonce();
+	return nonce;
+}
+
 using std::min;
 using std::max;
 
@@ -43,6 +68,7 @@ void Music_Emu::clear_track_vars()
 	silence_time     = 0;
 	silence_count    = 0;
 	buf_remain       = 0;
+	buf_is_float     = float_output;
 	warning(); // clear warning
 }
 
@@ -61,6 +87,17 @@ Music_Emu::Music_Emu()
 	mute_mask_   = 0;
 	tempo_       = 1.0;
 	gain_        = 1.0;
+	quality_     = gme_quality_normal;
+	low_latency_ = false;
+	float_output = false;
+	load_id      = 0;
+	checkpoint_count    = 0;
+	checkpoint_track    = -1;
+	checkpoint_base     = 0;
+	checkpoint_interval = 0;
+	checkpoint_memory   = 0;
+	checkpoint_size     = 0;
+	memset( &stats, 0, sizeof stats );
 
 	// defaults
 	max_initial_silence = 2;
@@ -79,7 +116,11 @@ Music_Emu::Music_Emu()
 	Music_Emu::unload(); // non-virtual
 }
 
-Music_Emu::~Music_Emu() { delete effects_buffer; }
+Music_Emu::~Music_Emu()
+{
+	free_checkpoints();
+	delete effects_buffer;
+}
 
 blargg_err_t Music_Emu::set_sample_rate( long rate )
 {
@@ -93,6 +134,9 @@ blargg_err_t Music_Emu::set_sample_rate( long rate )
 void Music_Emu::pre_load()
 {
 	require( sample_rate() ); // set_sample_rate() must be called before loading a file
+	load_id = ++last_load_id;
+	clear_checkpoints();
+	checkpoint_track = -1;
 	Gme_File::pre_load();
 }
 
@@ -152,6 +196,7 @@ void Music_Emu::set_tempo( double t )
 	if ( t > max ) t = max;
 	tempo_ = t;
 	set_tempo_( t );
+	clear_checkpoints(); // saved at old tempo, so times no longer match
 }
 
 void Music_Emu::post_load_()
@@ -166,6 +211,11 @@ blargg_err_t Music_Emu::start_track( int track )
 
 	int remapped = track;
 	RETURN_ERR( remap_track_( &remapped ) );
+	if ( remapped != checkpoint_track )
+	{
+		clear_checkpoints();
+		checkpoint_track = remapped;
+	}
 	current_track_ = track;
 	RETURN_ERR( start_track_( remapped ) );
 
@@ -182,6 +232,7 @@ blargg_err_t Music_Emu::start_track( int track )
 				break;
 		}
 
+		GME_STAT( stats.silence_samples += emu_time - buf_remain );
 		emu_time        = buf_remain;
 		out_time        = 0;
 		out_time_scaled = 0;
@@ -236,10 +287,34 @@ long Music_Emu::tell_scaled() const
 	return long(out_time_scaled / (sample_rate() / 1000.0));
 }
 
+// Resumes from latest checkpoint at or before time if that's closer than current
+// position, otherwise restarts track if time is before current position
+blargg_err_t Music_Emu::rewind_to( int32_t time, bool scaled )
+{
+	int32_t const now = scaled ? out_time_scaled : out_time;
+	for ( int i = checkpoint_count; --i >= 0; )
+	{
+		checkpoint_t const& c = checkpoints [i];
+		int32_t const t = scaled ? c.time_scaled : c.time;
+		if ( t <= time )
+		{
+			if ( t > now || time < now )
+			{
+				if ( load_state( c.data, c.size ) )
+					return start_track( current_track_ );
+			}
+			return 0;
+		}
+	}
+
+	if ( time < now )
+		return start_track( current_track_ );
+	return 0;
+}
+
 blargg_err_t Music_Emu::seek_samples( long time )
 {
-	if ( time < out_time )
-		RETURN_ERR( start_track( current_track_ ) );
+	RETURN_ERR( rewind_to( time, false ) );
 	return skip( time - out_time );
 }
 
@@ -252,8 +327,7 @@ blargg_err_t Music_Emu::seek_scaled( long msec )
 {
 	require( tempo_ > 0 );
 	int32_t frames = int32_t((msec / 1000.0) * sample_rate());
-	if ( frames < out_time_scaled )
-		RETURN_ERR( start_track( current_track_ ) );
+	RETURN_ERR( rewind_to( frames, true ) );
 	int samples_to_skip = int((frames - out_time_scaled) * out_channels() / tempo_);
 	samples_to_skip += samples_to_skip % out_channels();
 	return skip( samples_to_skip );
@@ -262,6 +336,28 @@ blargg_err_t Music_Emu::seek_scaled( long msec )
 blargg_err_t Music_Emu::skip( long count )
 {
 	require( current_track() >= 0 ); // start_track() must have been called already
+	while ( count > 0 )
+	{
+		// stop at each checkpoint along the way
+		long n = count;
+		if ( checkpoint_interval )
+		{
+			int32_t last = checkpoint_count ? checkpoints [checkpoint_count - 1].time : 0;
+			long until = last + checkpoint_interval - out_time;
+			until -= until % out_channels();
+			if ( until > 0 && until < n )
+				n = until;
+		}
+		skip_samples( n );
+		count -= n;
+		if ( checkpoint_interval )
+			add_checkpoint();
+	}
+	return 0;
+}
+
+void Music_Emu::skip_samples( long count )
+{
 	out_time += count;
 	out_time_scaled += int32_t(count * tempo_ / out_channels());
 
@@ -270,6 +366,7 @@ blargg_err_t Music_Emu::skip( long count )
 		long n = min( count, silence_count );
 		silence_count -= n;
 		count -= n;
+		GME_STAT( stats.silence_samples += n );
 
 		n = min( count, buf_remain );
 		buf_remain -= n;
@@ -279,25 +376,23 @@ blargg_err_t Music_Emu::skip( long count )
 	if ( count && !emu_track_ended_ )
 	{
 		emu_time += count;
+		GME_STAT( stats.emu_samples += count );
 		end_track_if_error( skip_( count ) );
 	}
 
 	if ( !(silence_count | buf_remain) ) // caught up to emulator, so update track ended
 		track_ended_ |= emu_track_ended_;
-
-	return 0;
 }
 
 blargg_err_t Music_Emu::skip_( long count )
 {
 	// for long skip, mute sound
-	const long threshold = 30000;
-	if ( count > threshold )
+	if ( count > skip_threshold )
 	{
 		int saved_mute = mute_mask_;
 		mute_voices( ~0 );
 
-		while ( count > threshold / 2 && !emu_track_ended_ )
+		while ( count > skip_threshold / 2 && !emu_track_ended_ )
 		{
 			RETURN_ERR( play_( buf_size, buf.begin() ) );
 			count -= buf_size;
@@ -317,6 +412,215 @@ blargg_err_t Music_Emu::skip_( long count )
 	return 0;
 }
 
+// Save/load state
+
+struct music_emu_state_t
+{
+	char tag [4];
+	unsigned long nonce;    // process that saved state
+	Music_Emu const* emu;   // emulator that saved state
+	unsigned long load_id;  // file load that state is for
+	int track;
+};
+
+static char const state_tag [4] = { 'G','M','E','S' };
+
+void Music_Emu::copy_state_( Emu_State& s )
+{
+	s( out_time );
+	s( out_time_scaled );
+	s( emu_time );
+	s( emu_track_ended_ );
+	bool ended = track_ended_;
+	s( ended );
+	track_ended_ = ended;
+	s( silence_time );
+	s( silence_count );
+	s( buf_remain );
+	s( buf_is_float );
+
+	if ( buf_remain && buf_is_float && !float_buf.size() )
+		s.set_corrupt();
+	if ( (unsigned long) buf_remain > buf_size )
+		s.set_corrupt();
+	if ( s.error() )
+		return;
+
+	long pos = buf_size - buf_remain;
+	if ( buf_is_float )
+		s.copy( float_buf.begin() + pos, buf_remain * sizeof (float) );
+	else
+		s.copy( buf.begin() + pos, buf_remain * sizeof (sample_t) );
+}
+
+void Music_Emu::copy_state( Emu_State& s )
+{
+	music_emu_state_t h;
+	memset( &h, 0, sizeof h );
+	memcpy( h.tag, state_tag, sizeof h.tag );
+	h.nonce      = process_nonce();
+	h.emu        = this;
+	h.load_id    = load_id;
+	h.track      = current_track_;
+	s( h );
+	copy_state_( s );
+}
+
+long Music_Emu::state_size()
+{
+	require( current_track() >= 0 ); // start_track() must have been called already
+	Emu_State s;
+	copy_state( s );
+	return s.used();
+}
+
+blargg_err_t Music_Emu::save_state( void* out, long size )
+{
+	require( current_track() >= 0 ); // start_track() must have been called already
+	Emu_State s;
+	s.begin_save( out, size );
+	copy_state( s );
+	return s.error();
+}
+
+blargg_err_t Music_Emu::load_state( void const* in, long size )
+{
+	require( sample_rate() ); // sample rate must be set first
+
+	music_emu_state_t h;
+	if ( size < (long) sizeof h )
+		return "Corrupt state";
+	memcpy( &h, in, sizeof h );
+	if ( memcmp( h.tag, state_tag, sizeof h.tag ) )
+		return "Corrupt state";
+	if ( h.nonce != process_nonce() || h.emu != this || h.load_id != load_id )
+		return "State is from a different emulator or file";
+
+	if ( h.track != current_track_ )
+		RETURN_ERR( start_track( h.track ) );
+
+	Emu_State s;
+	s.begin_load( in, size );
+	copy_state( s );
+	if ( !s.error() && s.used() != size )
+		s.set_corrupt();
+
+	if ( s.error() )
+	{
+		// partially loaded state is unusable
+		emu_track_ended_ = true;
+		track_ended_     = true;
+		silence_count    = 0;
+		buf_remain       = 0;
+	}
+	return s.error();
+}
+
+// Seek checkpoints
+
+void Music_Emu::clear_checkpoints()
+{
+	checkpoint_count    = 0;
+	checkpoint_interval = checkpoint_base;
+	checkpoint_size     = 0;
+}
+
+void Music_Emu::free_checkpoints()
+{
+	for ( size_t i = 0; i < checkpoints.size(); i++ )
+		blargg_free( checkpoints [i].data );
+	checkpoints.clear();
+	clear_checkpoints();
+}
+
+blargg_err_t Music_Emu::set_seek_checkpoints( long interval_msec, int max_count )
+{
+	require( sample_rate() ); // sample rate must be set first
+	free_checkpoints();
+	if ( interval_msec <= 0 || max_count <= 0 )
+	{
+		checkpoint_base = 0;
+		clear_checkpoints();
+		return 0;
+	}
+
+	RETURN_ERR( checkpoints.resize( max_count ) );
+	memset( checkpoints.begin(), 0, checkpoints.size() * sizeof checkpoints [0] );
+	checkpoint_base = msec_to_samples( interval_msec );
+	if ( checkpoint_base <= 0 )
+		checkpoint_base = out_channels();
+	clear_checkpoints();
+	return 0;
+}
+
+void Music_Emu::set_seek_checkpoint_memory( long max_bytes )
+{
+	checkpoint_memory = max( 0L, max_bytes );
+}
+
+// Saves a checkpoint if current position is an interval past the last one
+void Music_Emu::add_checkpoint()
+{
+	int32_t last = checkpoint_count ? checkpoints [checkpoint_count - 1].time : 0;
+	if ( track_ended_ || out_time - last < checkpoint_interval )
+		return;
+
+	// State size only varies by a little buffered sound during a track, so measure
+	// it once rather than walking the whole state every time a checkpoint is due
+	int max_count = (int) checkpoints.size();
+	if ( checkpoint_memory )
+	{
+		if ( !checkpoint_size )
+			checkpoint_size = state_size();
+		if ( checkpoint_memory / checkpoint_size < max_count )
+			max_count = (int) (checkpoint_memory / checkpoint_size);
+	}
+
+	if ( checkpoint_count && checkpoint_count >= max_count )
+	{
+		// full, so keep every other checkpoint and double interval (more than
+		// once if memory limit was lowered)
+		do
+		{
+			int n = 0;
+			for ( int i = 1; i < checkpoint_count; i += 2 )
+			{
+				checkpoint_t temp = checkpoints [n];
+				checkpoints [n++] = checkpoints [i];
+				checkpoints [i] = temp;
+			}
+			checkpoint_count = n;
+			checkpoint_interval *= 2;
+		}
+		while ( checkpoint_count && checkpoint_count >= max_count );
+		add_checkpoint();
+		return;
+	}
+
+	// free slots beyond memory limit
+	for ( int i = max_count; i < (int) checkpoints.size(); i++ )
+	{
+		blargg_free( checkpoints [i].data );
+		checkpoints [i].data = 0;
+	}
+	if ( !max_count )
+		return;
+
+	// failure to save a checkpoint just makes later seeks slower
+	long size = state_size();
+	checkpoint_t& c = checkpoints [checkpoint_count];
+	void* p = blargg_realloc( c.data, size );
+	if ( !p )
+		return;
+	c.data = p;
+	c.size = size;
+	if ( save_state( c.data, c.size ) )
+		return;
+	c.time        = out_time;
+	c.time_scaled = out_time_scaled;
+	checkpoint_count++;
+}
+
 // Fading
 
 void Music_Emu::set_fade( long start_msec, long length_msec )
@@ -333,7 +637,18 @@ static int int_log( int32_t x, int step, int unit )
 	return ((unit - fraction) + (fraction >> 1)) >> shift;
 }
 
-void Music_Emu::handle_fade( long out_count, sample_t* out )
+static inline void fade_sample( Music_Emu::sample_t& io, int gain, int shift )
+{
+	io = Music_Emu::sample_t ((io * gain) >> shift);
+}
+
+static inline void fade_sample( float& io, int gain, int shift )
+{
+	io *= gain * (1.0f / (1 << shift));
+}
+
+template<class T>
+void Music_Emu::handle_fade( long out_count, T* out )
 {
 	for ( int i = 0; i < out_count; i += fade_block_size )
 	{
@@ -344,10 +659,10 @@ void Music_Emu::handle_fade( long out_count, sample_t* out )
 		if ( gain < (unit >> fade_shift) )
 			track_ended_ = emu_track_ended_ = true;
 
-		sample_t* io = &out [i];
+		T* io = &out [i];
 		for ( int count = min( fade_block_size, out_count - i ); count; --count )
 		{
-			*io = sample_t ((*io * gain) >> shift);
+			fade_sample( *io, gain, shift );
 			++io;
 		}
 	}
@@ -355,37 +670,127 @@ void Music_Emu::handle_fade( long out_count, sample_t* out )
 
 // Silence detection
 
-void Music_Emu::emu_play( long count, sample_t* out )
+template<class T>
+void Music_Emu::emu_play( long count, T* out )
 {
 	check( current_track_ >= 0 );
 	emu_time += count;
+	GME_STAT( stats.emu_samples += count );
 	if ( current_track_ >= 0 && !emu_track_ended_ )
-		end_track_if_error( play_( count, out ) );
+		end_track_if_error( render( count, out ) );
 	else
 		memset( out, 0, count * sizeof *out );
 }
 
+static inline bool is_silent( Music_Emu::sample_t s )
+{
+	return (unsigned) (s + silence_threshold / 2) <= (unsigned) silence_threshold;
+}
+
+static inline bool is_silent( float s )
+{
+	s *= 0x8000;
+	return s >= -silence_threshold / 2 && s <= silence_threshold / 2;
+}
+
+// Silence is usually found in long runs, so whole blocks are checked at once
+// where SIMD is available
+int const silence_block = 8;
+
+#if BLARGG_SIMD_SSE2
+static inline bool block_silent( Music_Emu::sample_t const* p )
+{
+	__m128i const max = _mm_set1_epi16( silence_threshold / 2 );
+	__m128i const min = _mm_set1_epi16( -silence_threshold / 2 );
+	__m128i s = _mm_loadu_si128( (__m128i const*) p );
+	return !_mm_movemask_epi8( _mm_or_si128( _mm_cmpgt_epi16( s, max ), _mm_cmplt_epi16( s, min ) ) );
+}
+
+static inline bool block_silent( float const* p )
+{
+	// NaN compares false, so it isn't silent, same as is_silent()
+	__m128 const abs_mask = _mm_castsi128_ps( _mm_set1_epi32( 0x7FFFFFFF ) );
+	__m128 const max = _mm_set1_ps( silence_threshold / 2 * (1.0f / 0x8000) );
+	__m128 a = _mm_cmple_ps( _mm_and_ps( _mm_loadu_ps( p     ), abs_mask ), max );
+	__m128 b = _mm_cmple_ps( _mm_and_ps( _mm_loadu_ps( p + 4 ), abs_mask ), max );
+	return _mm_movemask_ps( _mm_and_ps( a, b ) ) == 0x0F;
+}
+#endif
+
+#if BLARGG_SIMD_NEON
+static inline bool all_set( uint32x4_t m )
+{
+	uint64x2_t m64 = vreinterpretq_u64_u32( m );
+	return (vgetq_lane_u64( m64, 0 ) & vgetq_lane_u64( m64, 1 )) == ~(uint64_t) 0;
+}
+
+static inline bool block_silent( Music_Emu::sample_t const* p )
+{
+	// saturating abs so that -0x8000 isn't silent
+	int16x8_t a = vqabsq_s16( vld1q_s16( p ) );
+	return all_set( vreinterpretq_u32_u16( vcleq_s16( a, vdupq_n_s16( silence_threshold / 2 ) ) ) );
+}
+
+static inline bool block_silent( float const* p )
+{
+	float32x4_t const max = vdupq_n_f32( silence_threshold / 2 * (1.0f / 0x8000) );
+	return all_set( vandq_u32( vcaleq_f32( vld1q_f32( p ), max ), vcaleq_f32( vld1q_f32( p + 4 ), max ) ) );
+}
+#endif
+
+// number of samples at end in whole blocks that are all silent
+template<class T>
+static long silent_blocks( T const* begin, long size )
+{
+	long n = size;
+	#if BLARGG_SIMD_SSE2
+		if ( blargg_cpu_features() & blargg_cpu_sse2 )
+			while ( n >= silence_block && block_silent( begin + n - silence_block ) )
+				n -= silence_block;
+	#elif BLARGG_SIMD_NEON
+		if ( blargg_cpu_features() & blargg_cpu_neon )
+			while ( n >= silence_block && block_silent( begin + n - silence_block ) )
+				n -= silence_block;
+	#endif
+	(void) begin;
+	return size - n;
+}
+
 // number of consecutive silent samples at end
-static long count_silence( Music_Emu::sample_t* begin, long size )
+template<class T>
+static long count_silence( T* begin, long size )
 {
-	Music_Emu::sample_t first = *begin;
+	long end = size - silent_blocks( begin, size );
+	if ( !end )
+		return size;
+	T first = *begin;
 	*begin = silence_threshold; // sentinel
-	Music_Emu::sample_t* p = begin + size;
-	while ( (unsigned) (*--p + silence_threshold / 2) <= (unsigned) silence_threshold ) { }
+	T* p = begin + end;
+	while ( is_silent( *--p ) ) { }
 	*begin = first;
 	return size - (p - begin);
 }
 
 // fill internal buffer and check it for silence
 void Music_Emu::fill_buf()
+{
+	if ( float_output )
+		fill_buf_( float_buf.begin() );
+	else
+		fill_buf_( buf.begin() );
+}
+
+template<class T>
+void Music_Emu::fill_buf_( T* out )
 {
 	assert( !buf_remain );
 	if ( !emu_track_ended_ )
 	{
-		emu_play( buf_size, buf.begin() );
-		long silence = count_silence( buf.begin(), buf_size );
+		emu_play( buf_size, out );
+		long silence = count_silence( out, buf_size );
 		if ( silence < buf_size )
 		{
+			buf_is_float = float_output;
 			silence_time = emu_time - silence;
 			buf_remain   = buf_size;
 			return;
@@ -394,7 +799,69 @@ void Music_Emu::fill_buf()
 	silence_count += buf_size;
 }
 
+// copy next n samples from silence buffer, converting if it was filled by the other
+// of play()/play_float()
+void Music_Emu::copy_buf( sample_t* out, long n )
+{
+	long const pos = buf_size - buf_remain;
+	if ( !buf_is_float )
+	{
+		memcpy( out, buf.begin() + pos, n * sizeof *out );
+		return;
+	}
+	for ( long i = 0; i < n; i++ )
+	{
+		int32_t s = (int32_t) (float_buf [pos + i] * 0x8000);
+		if ( (sample_t) s != s )
+			s = 0x7FFF - (s >> 24);
+		out [i] = (sample_t) s;
+	}
+}
+
+void Music_Emu::copy_buf( float* out, long n )
+{
+	long const pos = buf_size - buf_remain;
+	if ( buf_is_float )
+	{
+		memcpy( out, float_buf.begin() + pos, n * sizeof *out );
+		return;
+	}
+	for ( long i = 0; i < n; i++ )
+		out [i] = buf [pos + i] * (1.0f / 0x8000);
+}
+
 blargg_err_t Music_Emu::play( long out_count, sample_t* out )
+{
+	float_output = false;
+	return play_samples( out_count, out );
+}
+
+blargg_err_t Music_Emu::play_float( long out_count, float* out )
+{
+	if ( !float_buf.size() )
+		RETURN_ERR( float_buf.resize( buf_size ) );
+	float_output = true;
+	return play_samples( out_count, out );
+}
+
+blargg_err_t Music_Emu::play_float_( long count, float* out )
+{
+	// generic version converts output of play_()
+	sample_t temp [1024];
+	while ( count )
+	{
+		long n = min( count, (long) (sizeof temp / sizeof *temp) );
+		RETURN_ERR( play_( n, temp ) );
+		for ( long i = 0; i < n; i++ )
+			out [i] = temp [i] * (1.0f / 0x8000);
+		out   += n;
+		count -= n;
+	}
+	return 0;
+}
+
+template<class T>
+blargg_err_t Music_Emu::play_samples( long out_count, T* out )
 {
 	if ( track_ended_ )
 	{
@@ -415,13 +882,14 @@ blargg_err_t Music_Emu::play( long out_count, sample_t* out )
 		{
 			// during a run of silence, run emulator at >=2x speed so it gets ahead
 			long ahead_time = silence_lookahead * (out_time + out_count - silence_time) + silence_time;
-			while ( emu_time < ahead_time && !(buf_remain | static_cast<long>(emu_track_ended_)) )
+			while ( emu_time < ahead_time && !(buf_remain | static_cast<long>(emu_track_ended_) | low_latency_) )
 				fill_buf();
 
 			// fill with silence
 			pos = min( silence_count, out_count );
 			memset( out, 0, pos * sizeof *out );
 			silence_count -= pos;
+			GME_STAT( stats.silence_samples += pos );
 
 			if ( !ignore_silence_ && emu_time - silence_time > silence_max * out_channels() * sample_rate() )
 			{
@@ -435,7 +903,7 @@ blargg_err_t Music_Emu::play( long out_count, sample_t* out )
 		{
 			// empty silence buf
 			long n = min( buf_remain, out_count - pos );
-			memcpy( &out [pos], buf.begin() + (buf_size - buf_remain), n * sizeof *out );
+			copy_buf( &out [pos], n );
 			buf_remain -= n;
 			pos += n;
 		}
@@ -455,7 +923,18 @@ blargg_err_t Music_Emu::play( long out_count, sample_t* out )
 					silence_time = emu_time - silence;
 
 				if ( emu_time - silence_time >= buf_size )
-					fill_buf(); // cause silence detection on next play()
+				{
+					if ( !low_latency_ )
+					{
+						fill_buf(); // cause silence detection on next play()
+					}
+					else if ( !ignore_silence_ && emu_time - silence_time >
+							silence_max * out_channels() * sample_rate() )
+					{
+						// without looking ahead, track ends once silence has been played
+						track_ended_ = emu_track_ended_ = true;
+					}
+				}
 			}
 		}
 
@@ -464,9 +943,18 @@ blargg_err_t Music_Emu::play( long out_count, sample_t* out )
 	}
 	out_time += out_count;
 	out_time_scaled += int32_t(out_count * tempo_ / out_channels());
+	GME_STAT( stats.out_samples += out_count );
+	if ( checkpoint_interval )
+		add_checkpoint();
 	return 0;
 }
 
+void Music_Emu::get_stats( stats_t* out ) const
+{
+	*out = stats;
+	get_stats_( out );
+}
+
 // Gme_Info_
 
 blargg_err_t Gme_Info_::set_sample_rate_( long )            { return 0; }
@@ -5,6 +5,7 @@
 #define MUSIC_EMU_H
 
 #include "Gme_File.h"
+#include "Emu_State.h"
 class Multi_Buffer;
 
 struct Music_Emu : public Gme_File {
@@ -27,6 +28,11 @@ public:
 	typedef short sample_t;
 	blargg_err_t play( long count, sample_t* buf );
 
+	// Same as play(), but generates floating-point samples without clamping, where
+	// 1.0 corresponds to a full-scale 16-bit sample. Emulators that support it
+	// render directly to floating-point; others have play() output converted.
+	blargg_err_t play_float( long count, float* buf );
+
 // Informational
 
 	// Sample rate sound is generated at
@@ -66,6 +72,18 @@ public:
 	// Skip n samples
 	blargg_err_t skip( long n );
 
+	// Save state every interval_msec while playing or skipping the current track, so
+	// that seeking resumes from the nearest earlier checkpoint instead of restarting
+	// the track. At most max_count checkpoints are kept; when full, every other one is
+	// discarded and the interval doubled, so the whole track stays covered. Changing
+	// tempo discards them. An interval of 0 disables checkpoints (the default). Sample
+	// rate must be set first.
+	blargg_err_t set_seek_checkpoints( long interval_msec, int max_count = 32 );
+
+	// Limit memory used by seek checkpoints to max_bytes, with fewer kept when
+	// each emulator state is large. 0 removes the limit (the default).
+	void set_seek_checkpoint_memory( long max_bytes );
+
 	// True if a track has reached its end
 	bool track_ended() const;
 
@@ -83,10 +101,39 @@ public:
 	// Disable automatic end-of-track detection and skipping of silence at beginning
 	void ignore_silence( bool disable = true );
 
+	// Keep the work done by each play() proportional to the number of samples
+	// requested, for small output buffers where latency matters. Emulators run in
+	// steps of about a millisecond rather than filling their whole buffer, and
+	// silence detection no longer runs the emulator ahead of playback. Best set
+	// before starting a track. Default is off.
+	void set_low_latency( bool enable = true );
+
 	// Info for current track
 	using Gme_File::track_info;
 	blargg_err_t track_info( track_info_t* out ) const;
 
+// Save/load state
+
+	// Number of bytes needed to save state of current track
+	long state_size();
+
+	// Save state of current track into out, which must hold at least state_size() bytes.
+	// State is only valid for this emulator object with the current file loaded, in
+	// the same process, since it holds pointers into the emulator.
+	// Current settings (tempo, muting, fade, equalizer) aren't saved.
+	blargg_err_t save_state( void* out, long size );
+
+	// Restore state previously saved by save_state(), restarting its track if
+	// another is playing
+	blargg_err_t load_state( void const* in, long size );
+
+// Statistics
+
+	// Get counters of work done since emulator was created. See gme.h for definition
+	// of struct gme_stats_t. Counters are only updated if GME_STATS is defined.
+	typedef gme_stats_t stats_t;
+	void get_stats( stats_t* out ) const;
+
 // Sound customization
 
 	// Adjust song tempo, where 1.0 = normal, 0.5 = half speed, 2.0 = double speed.
@@ -115,6 +162,12 @@ public:
 	// equalizer settings.
 	void enable_accuracy( bool enable = true );
 
+	// Set synthesis quality of band-limited sound, trading accuracy for speed:
+	// 0 = fast, 1 = normal (default), 2 = high. Also selects width of resampling
+	// filter for emulators which resample. Invalid values are ignored. Can be
+	// changed at any time.
+	void set_quality( int );
+
 // Sound equalization (treble/bass)
 
 	// Frequency equalizer parameters (see gme.txt)
@@ -147,20 +200,37 @@ protected:
 	void set_voice_count( int n )               { voice_count_ = n; }
 	void set_voice_names( const char* const* names );
 	void set_track_ended()                      { emu_track_ended_ = true; }
+	bool emu_track_ended() const                { return emu_track_ended_; }
 	double gain() const                         { return gain_; }
 	double tempo() const                        { return tempo_; }
+	int quality() const                         { return quality_; }
+	bool low_latency() const                    { return low_latency_; }
 	void remute_voices();
 	blargg_err_t set_multi_channel_( bool is_enabled );
 
+	// returns the number of output channels, i.e. usually 2 for stereo, unlesss multi_channel_ == true
+	int out_channels() const { return this->multi_channel() ? 2*8 : 2; }
+
+	// skip_() of more samples than this runs with voices muted
+	enum { skip_threshold = 30000 };
+
 	virtual blargg_err_t set_sample_rate_( long sample_rate ) = 0;
 	virtual void set_equalizer_( equalizer_t const& ) { }
 	virtual void enable_accuracy_( bool /* enable */ ) { }
+	virtual void set_quality_( int /* quality */ ) { }
+	virtual void set_low_latency_( bool /* enable */ ) { }
 	virtual void mute_voices_( int mask );
 	virtual void disable_echo_( bool /* disable */);
 	virtual void set_tempo_( double );
 	virtual blargg_err_t start_track_( int ); // tempo is set before this
 	virtual blargg_err_t play_( long count, sample_t* out ) = 0;
+	virtual blargg_err_t play_float_( long count, float* out );
 	virtual blargg_err_t skip_( long count );
+	virtual void copy_state_( Emu_State& ); // derived versions must call base first
+	virtual void get_stats_( stats_t* ) const { } // adds counters of CPU, buffers, etc.
+
+	// Counters kept by emulator itself
+	stats_t stats;
 protected:
 	virtual void unload();
 	virtual void pre_load();
@@ -174,11 +244,10 @@ private:
 	int mute_mask_;
 	double tempo_;
 	double gain_;
+	int quality_;
+	bool low_latency_;
 	bool multi_channel_;
 
-	// returns the number of output channels, i.e. usually 2 for stereo, unlesss multi_channel_ == true
-	int out_channels() const { return this->multi_channel() ? 2*8 : 2; }
-
 	long sample_rate_;
 	int32_t msec_to_samples( int32_t msec ) const;
 
@@ -196,7 +265,32 @@ private:
 	// fading
 	int32_t fade_start;
 	int fade_step;
-	void handle_fade( long count, sample_t* out );
+	template<class T> void handle_fade( long count, T* out );
+
+	// state
+	unsigned long load_id; // unique to each file load by any emulator, to detect stale state
+	void copy_state( Emu_State& );
+
+	// seek checkpoints
+	struct checkpoint_t
+	{
+		int32_t time;        // out_time when saved
+		int32_t time_scaled; // out_time_scaled when saved
+		long size;
+		void* data;          // allocation is reused when checkpoints are discarded
+	};
+	blargg_vector<checkpoint_t> checkpoints;
+	int checkpoint_count;
+	int checkpoint_track;          // remapped track that checkpoints are for
+	int32_t checkpoint_base;       // interval set by user, in samples (0 if disabled)
+	int32_t checkpoint_interval;   // current interval, doubled when thinning
+	long checkpoint_memory;        // limit on total size of checkpoints (0 if none)
+	long checkpoint_size;          // state size when first needed, for memory limit (0 if not yet)
+	void clear_checkpoints();
+	void free_checkpoints();
+	void add_checkpoint();
+	blargg_err_t rewind_to( int32_t time, bool scaled );
+	void skip_samples( long count );
 
 	// silence detection
 	int silence_lookahead; // speed to run emulator when looking ahead for silence
@@ -206,8 +300,17 @@ private:
 	long buf_remain;       // number of samples left in silence buffer
 	enum { buf_size = 2048 };
 	blargg_vector<sample_t> buf;
+	blargg_vector<float> float_buf; // silence buffer used while float_output is set
+	bool float_output;     // true if play_float() was used most recently
+	bool buf_is_float;     // true if silence buffer contents are in float_buf
 	void fill_buf();
-	void emu_play( long count, sample_t* out );
+	template<class T> void fill_buf_( T* );
+	template<class T> void emu_play( long count, T* out );
+	template<class T> blargg_err_t play_samples( long count, T* out );
+	void copy_buf( sample_t* out, long n );
+	void copy_buf( float* out, long n );
+	blargg_err_t render( long count, sample_t* out ) { return play_( count, out ); }
+	blargg_err_t render( long count, float* out )    { return play_float_( count, out ); }
 
 	Multi_Buffer* effects_buffer;
 	friend Music_Emu* gme_internal_new_emu_( gme_type_t, int, bool );
@@ -241,12 +344,25 @@ inline bool Music_Emu::track_ended() const          { return track_ended_; }
 inline const Music_Emu::equalizer_t& Music_Emu::equalizer() const { return equalizer_; }
 
 inline void Music_Emu::enable_accuracy( bool b )    { enable_accuracy_( b ); }
+inline void Music_Emu::set_quality( int q )
+{
+	if ( (unsigned) q <= gme_quality_high )
+	{
+		quality_ = q;
+		set_quality_( q );
+	}
+}
 inline void Music_Emu::set_tempo_( double t )       { tempo_ = t; }
 inline void Music_Emu::remute_voices()              { mute_voices( mute_mask_ ); }
 inline void Music_Emu::ignore_silence( bool b )     { ignore_silence_ = b; }
+inline void Music_Emu::set_low_latency( bool b )
+{
+	low_latency_ = b;
+	set_low_latency_( b );
+}
 inline blargg_err_t Music_Emu::start_track_( int track )
 {
-	if ( type()->track_count == 1 )
+	if ( type()->track_count == 1 && has_track_data() )
 		return load_mem_( track_pos( track ), track_size( track ) );
 	return 0;
 }
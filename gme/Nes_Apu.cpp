@@ -2,6 +2,8 @@
 
 #include "Nes_Apu.h"
 
+#include "Emu_State.h"
+
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -115,6 +117,63 @@ void Nes_Apu::reset( bool pal_mode, int initial_dmc_dac )
 		dmc.last_amp = initial_dmc_dac; // prevent output transition
 }
 
+static void copy_osc( Emu_State& s, Nes_Osc& osc )
+{
+	s( osc.regs );
+	s( osc.reg_written );
+	s( osc.length_counter );
+	s( osc.delay );
+	s( osc.last_amp );
+}
+
+static void copy_envelope( Emu_State& s, Nes_Envelope& osc )
+{
+	s( osc.envelope );
+	s( osc.env_delay );
+}
+
+void Nes_Apu::copy_state( Emu_State& s )
+{
+	for ( int i = 0; i < osc_count; i++ )
+		copy_osc( s, *oscs [i] );
+
+	copy_envelope( s, square1 );
+	s( square1.phase );
+	s( square1.sweep_delay );
+
+	copy_envelope( s, square2 );
+	s( square2.phase );
+	s( square2.sweep_delay );
+
+	s( triangle.phase );
+	s( triangle.linear_counter );
+
+	copy_envelope( s, noise );
+	s( noise.noise );
+
+	s( dmc.address );
+	s( dmc.period );
+	s( dmc.buf );
+	s( dmc.bits_remain );
+	s( dmc.bits );
+	s( dmc.buf_full );
+	s( dmc.silence );
+	s( dmc.dac );
+	s( dmc.next_irq );
+	s( dmc.irq_enabled );
+	s( dmc.irq_flag );
+
+	s( last_time );
+	s( last_dmc_time );
+	s( earliest_irq_ );
+	s( next_irq );
+	s( frame_delay );
+	s( frame );
+	s( osc_enables );
+	s( frame_mode );
+	s( irq_flag );
+}
+
 void Nes_Apu::irq_changed()
 {
 	nes_time_t new_irq = dmc.next_irq;
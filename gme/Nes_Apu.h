@@ -57,6 +57,10 @@ public:
 	void save_state( apu_state_t* out ) const;
 	void load_state( apu_state_t const& );
 
+	// Save/load emulation state in native format. Settings such as outputs,
+	// volume and tempo aren't affected.
+	void copy_state( Emu_State& );
+
 	// Set overall volume (default is 1.0)
 	void volume( double );
 
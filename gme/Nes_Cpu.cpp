@@ -2,6 +2,7 @@
 
 #include "Nes_Cpu.h"
 
+#include "Emu_State.h"
 #include "blargg_endian.h"
 #include <limits.h>
 
@@ -88,6 +89,17 @@ void Nes_Cpu::reset( void const* unmapped_page )
 	blargg_verify_byte_order();
 }
 
+void Nes_Cpu::copy_state( Emu_State& s )
+{
+	assert( state == &state_ );
+	s( low_mem );
+	s( r );
+	s( state_ );
+	s( irq_time_ );
+	s( end_time_ );
+	s( error_count_ );
+}
+
 void Nes_Cpu::map_code( nes_addr_t start, unsigned size, void const* data, bool mirror )
 {
 	// address range must begin and end on page boundaries
@@ -161,6 +173,7 @@ bool Nes_Cpu::run( nes_time_t end_time )
 dec_clock_loop:
 	s_time--;
 loop:
+	GME_STAT( instr_count_++ );
 
 	check( (unsigned) GET_SP() < 0x100 );
 	check( (unsigned) pc < 0x10000 );
@@ -6,6 +6,8 @@
 
 #include "blargg_common.h"
 
+class Emu_State;
+
 typedef int32_t nes_time_t; // clock cycle count
 typedef unsigned nes_addr_t; // 16-bit address
 enum { future_nes_time = INT_MAX / 2 + 1 };
@@ -61,8 +63,14 @@ public:
 	// CPU invokes bad opcode handler if it encounters this
 	enum { bad_opcode = 0xF2 };
 
+	// Number of instructions executed. Only counted if GME_STATS is defined.
+	uint64_t instr_count() const        { return instr_count_; }
+
+	// Save/load registers, timing, memory map and RAM. Can't be called during run().
+	void copy_state( Emu_State& );
+
 public:
-	Nes_Cpu() { state = &state_; }
+	Nes_Cpu() { state = &state_; instr_count_ = 0; }
 	enum { page_bits = 11 };
 	enum { page_count = 0x10000 >> page_bits };
 	enum { irq_inhibit = 0x04 };
@@ -74,6 +82,7 @@ private:
 	};
 	state_t* state; // points to state_ or a local copy within run()
 	state_t state_;
+	uint64_t instr_count_;
 	nes_time_t irq_time_;
 	nes_time_t end_time_;
 	unsigned long error_count_;
@@ -2,6 +2,8 @@
 
 #include "Nes_Fds_Apu.h"
 
+#include "Emu_State.h"
+
 /* Copyright (C) 2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -280,3 +282,22 @@ void Nes_Fds_Apu::run_until( blip_time_t final_end_time )
 	}
 	last_time = final_end_time;
 }
+
+void Nes_Fds_Apu::copy_state( Emu_State& s )
+{
+	s( regs_ );
+	s( env_delay );
+	s( env_speed );
+	s( env_gain );
+	s( sweep_delay );
+	s( sweep_speed );
+	s( sweep_gain );
+	s( wave_pos );
+	s( last_amp );
+	s( wave_fract );
+	s( mod_fract );
+	s( mod_pos );
+	s( mod_write_pos );
+	s( mod_wave );
+	s( last_time );
+}
@@ -24,6 +24,9 @@ public:
 	int read( blip_time_t time, unsigned addr );
 	void end_frame( blip_time_t );
 
+	// Save/load emulation state in native format, without affecting settings
+	void copy_state( Emu_State& );
+
 public:
 	Nes_Fds_Apu();
 	void write_( unsigned addr, int data );
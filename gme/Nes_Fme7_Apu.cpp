@@ -2,6 +2,7 @@
 
 #include "Nes_Fme7_Apu.h"
 
+#include "Emu_State.h"
 #include <string.h>
 
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
@@ -119,3 +120,11 @@ void Nes_Fme7_Apu::run_until( blip_time_t end_time )
 	last_time = end_time;
 }
 
+void Nes_Fme7_Apu::copy_state( Emu_State& s )
+{
+	fme7_apu_state_t* state = this;
+	s( *state );
+	for ( int i = 0; i < osc_count; i++ )
+		s( oscs [i].last_amp );
+	s( last_time );
+}
@@ -29,6 +29,9 @@ public:
 	void save_state( fme7_apu_state_t* ) const;
 	void load_state( fme7_apu_state_t const& );
 
+	// Save/load emulation state in native format, without affecting settings
+	void copy_state( Emu_State& );
+
 	// Mask and addresses of registers
 	static const unsigned int addr_mask = 0xE000;
 	static const unsigned int data_addr = 0xE000;
@@ -7,6 +7,7 @@
 
 #include "blargg_common.h"
 #include "Nes_Apu.h"
+#include "Emu_State.h"
 
 class Nes_Mmc5_Apu : public Nes_Apu {
 public:
@@ -19,6 +20,9 @@ public:
 
 	enum { exram_size = 1024 };
 	unsigned char exram [exram_size];
+
+	// Save/load emulation state, including exram
+	void copy_state( Emu_State& s ) { Nes_Apu::copy_state( s ); s( exram ); }
 };
 
 inline void Nes_Mmc5_Apu::osc_output( int i, Blip_Buffer* b )
@@ -2,6 +2,8 @@
 
 #include "Nes_Namco_Apu.h"
 
+#include "Emu_State.h"
+
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -143,3 +145,16 @@ void Nes_Namco_Apu::run_until( blip_time_t nes_end_time )
 	last_time = nes_end_time;
 }
 
+void Nes_Namco_Apu::copy_state( Emu_State& s )
+{
+	for ( int i = 0; i < osc_count; i++ )
+	{
+		Namco_Osc& osc = oscs [i];
+		s( osc.delay );
+		s( osc.last_amp );
+		s( osc.wave_pos );
+	}
+	s( last_time );
+	s( addr_reg );
+	s( reg );
+}
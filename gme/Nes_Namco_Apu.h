@@ -33,6 +33,9 @@ public:
 	void save_state( namco_state_t* out ) const;
 	void load_state( namco_state_t const& );
 
+	// Save/load emulation state in native format, without affecting settings
+	void copy_state( Emu_State& );
+
 public:
 	Nes_Namco_Apu();
 	BLARGG_DISABLE_NOTHROW
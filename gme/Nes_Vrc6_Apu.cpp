@@ -2,6 +2,8 @@
 
 #include "Nes_Vrc6_Apu.h"
 
+#include "Emu_State.h"
+
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -85,6 +87,20 @@ void Nes_Vrc6_Apu::save_state( vrc6_apu_state_t* out ) const
 	}
 }
 
+void Nes_Vrc6_Apu::copy_state( Emu_State& s )
+{
+	for ( int i = 0; i < osc_count; i++ )
+	{
+		Vrc6_Osc& osc = oscs [i];
+		s( osc.regs );
+		s( osc.delay );
+		s( osc.last_amp );
+		s( osc.phase );
+		s( osc.amp );
+	}
+	s( last_time );
+}
+
 void Nes_Vrc6_Apu::load_state( vrc6_apu_state_t const& in )
 {
 	reset();
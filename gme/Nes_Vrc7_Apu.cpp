@@ -1,15 +1,21 @@
 #include "Nes_Vrc7_Apu.h"
 
+#include "Emu_State.h"
+
 extern "C" {
 #include "ext/emu2413.h"
 }
 
 #include <string.h>
+#include <mutex>
 
 #include "blargg_source.h"
 
 static int const period = 36; // NES CPU clocks per FM clock
 
+// OPLL_new() fills emu2413's shared tables the first time it's called
+static std::mutex opll_new_mutex;
+
 Nes_Vrc7_Apu::Nes_Vrc7_Apu()
 {
 	opll = 0;
@@ -17,7 +23,11 @@ Nes_Vrc7_Apu::Nes_Vrc7_Apu()
 
 blargg_err_t Nes_Vrc7_Apu::init()
 {
-	CHECK_ALLOC( opll = OPLL_new( 3579545, 3579545 / 72 ) );
+	{
+		std::lock_guard<std::mutex> lock( opll_new_mutex );
+		opll = OPLL_new( 3579545, 3579545 / 72 );
+	}
+	CHECK_ALLOC( opll );
 	OPLL_setChipType((OPLL *) opll, 1);
 	OPLL_resetPatch((OPLL *) opll, 1);
 
@@ -118,6 +128,23 @@ void Nes_Vrc7_Apu::end_frame( blip_time_t time )
 	}
 }
 
+void Nes_Vrc7_Apu::copy_state( Emu_State& s )
+{
+	for ( int i = 0; i < osc_count; i++ )
+	{
+		s( oscs [i].regs );
+		s( oscs [i].last_amp );
+	}
+	s( kon );
+	s( inst );
+	s( addr );
+	s( next_time );
+	s( mono.last_amp );
+
+	// same OPLL object, so its internal pointers remain valid
+	s( *(OPLL*) opll );
+}
+
 void Nes_Vrc7_Apu::save_snapshot( vrc7_snapshot_t* out ) const
 {
 	out->latch = addr;
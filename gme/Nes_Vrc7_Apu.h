@@ -25,6 +25,9 @@ public:
 	void save_snapshot( vrc7_snapshot_t* ) const;
 	void load_snapshot( vrc7_snapshot_t const& );
 
+	// Save/load emulation state in native format, without affecting settings
+	void copy_state( Emu_State& );
+
 	void write_reg( int reg );
 	void write_data( blip_time_t, int data );
 
@@ -333,7 +333,17 @@ blargg_err_t Nsf_Emu::load_( Data_Reader& in )
 {
 	blaarg_static_assert( offsetof (header_t,unused [4]) == header_size, "NSF Header layout incorrect!" );
 	RETURN_ERR( rom.load( in, header_size, &header_, 0 ) );
+	return finish_load();
+}
+
+blargg_err_t Nsf_Emu::load_mem_( byte const* in, long size )
+{
+	RETURN_ERR( rom.load( in, size, header_size, &header_, 0 ) );
+	return finish_load();
+}
 
+blargg_err_t Nsf_Emu::finish_load()
+{
 	set_track_count( header_.track_count );
 	RETURN_ERR( check_nsf_header( &header_ ) );
 
@@ -360,7 +370,7 @@ blargg_err_t Nsf_Emu::load_( Data_Reader& in )
 		return w;
 	}
 
-	rom.set_addr( load_addr % bank_size );
+	RETURN_ERR( rom.set_addr( load_addr % bank_size ) );
 	int total_banks = rom.size() / bank_size;
 
 	// bank switching
@@ -465,6 +475,7 @@ void Nsf_Emu::cpu_write_misc( nes_addr_t addr, int data )
 		{
 			if ( (unsigned) (addr - fds->io_addr) < fds->io_size )
 			{
+				GME_STAT( stats.apu_writes++ );
 				fds->write( time(), addr, data);
 				return;
 			}
@@ -475,10 +486,12 @@ void Nsf_Emu::cpu_write_misc( nes_addr_t addr, int data )
 			switch ( addr )
 			{
 			case Nes_Namco_Apu::data_reg_addr:
+				GME_STAT( stats.apu_writes++ );
 				namco->write_data( time(), data );
 				return;
 
 			case Nes_Namco_Apu::addr_reg_addr:
+				GME_STAT( stats.apu_writes++ );
 				namco->write_addr( data );
 				return;
 			}
@@ -489,10 +502,12 @@ void Nsf_Emu::cpu_write_misc( nes_addr_t addr, int data )
 			switch ( addr & Nes_Fme7_Apu::addr_mask )
 			{
 			case Nes_Fme7_Apu::latch_addr:
+				GME_STAT( stats.apu_writes++ );
 				fme7->write_latch( data );
 				return;
 
 			case Nes_Fme7_Apu::data_addr:
+				GME_STAT( stats.apu_writes++ );
 				fme7->write_data( time(), data );
 				return;
 			}
@@ -504,6 +519,7 @@ void Nsf_Emu::cpu_write_misc( nes_addr_t addr, int data )
 			unsigned osc = unsigned (addr - Nes_Vrc6_Apu::base_addr) / Nes_Vrc6_Apu::addr_step;
 			if ( osc < Nes_Vrc6_Apu::osc_count && reg < Nes_Vrc6_Apu::reg_count )
 			{
+				GME_STAT( stats.apu_writes++ );
 				vrc6->write_osc( time(), osc, reg, data );
 				return;
 			}
@@ -513,6 +529,7 @@ void Nsf_Emu::cpu_write_misc( nes_addr_t addr, int data )
 		{
 			if ( (unsigned) (addr - mmc5->regs_addr) < mmc5->regs_size)
 			{
+				GME_STAT( stats.apu_writes++ );
 				mmc5->write_register( time(), addr, data );
 				return;
 			}
@@ -536,12 +553,14 @@ void Nsf_Emu::cpu_write_misc( nes_addr_t addr, int data )
 		{
 			if ( addr == 0x9010 )
 			{
+				GME_STAT( stats.apu_writes++ );
 				vrc7->write_reg( data );
 				return;
 			}
 
 			if ( (unsigned) (addr - 0x9028) <= 0x08 )
 			{
+				GME_STAT( stats.apu_writes++ );
 				vrc7->write_data( time(), data );
 				return;
 			}
@@ -615,6 +634,36 @@ blargg_err_t Nsf_Emu::start_track_( int track )
 	return 0;
 }
 
+void Nsf_Emu::copy_state_( Emu_State& s )
+{
+	Classic_Emu::copy_state_( s );
+	cpu::copy_state( s );
+	s( sram );
+	s( saved_state );
+	s( next_play );
+	s( play_extra );
+	s( play_ready );
+	apu.copy_state( s );
+
+	#if !NSF_EMU_APU_ONLY
+	{
+		s( mmc5_mul );
+		if ( namco ) namco->copy_state( s );
+		if ( vrc6  ) vrc6 ->copy_state( s );
+		if ( fme7  ) fme7 ->copy_state( s );
+		if ( fds   ) fds  ->copy_state( s );
+		if ( mmc5  ) mmc5 ->copy_state( s );
+		if ( vrc7  ) vrc7 ->copy_state( s );
+	}
+	#endif
+}
+
+void Nsf_Emu::get_stats_( stats_t* out ) const
+{
+	Classic_Emu::get_stats_( out );
+	out->cpu_instructions += cpu::instr_count();
+}
+
 blargg_err_t Nsf_Emu::run_clocks( blip_time_t& duration, int )
 {
 	set_time( 0 );
@@ -55,12 +55,15 @@ public:
 protected:
 	blargg_err_t track_info_( track_info_t*, int track ) const;
 	blargg_err_t load_( Data_Reader& );
+	blargg_err_t load_mem_( byte const*, long );
 	blargg_err_t start_track_( int );
 	blargg_err_t run_clocks( blip_time_t&, int );
 	void set_tempo_( double );
 	void set_voice( int, Blip_Buffer*, Blip_Buffer*, Blip_Buffer* );
 	void update_eq( blip_eq_t const& );
 	void unload();
+	void copy_state_( Emu_State& );
+	void get_stats_( stats_t* ) const;
 protected:
 	enum { bank_count = 8 };
 	byte initial_banks [bank_count];
@@ -90,6 +93,7 @@ public: private: friend class Nes_Cpu;
 
 private:
 	byte mmc5_mul [2];
+	blargg_err_t finish_load();
 
 	class Nes_Namco_Apu* namco;
 	class Nes_Vrc6_Apu*  vrc6;
@@ -304,7 +304,7 @@ struct Nsfe_File : Gme_Info_
 static Music_Emu* new_nsfe_emu () { return BLARGG_NEW Nsfe_Emu ; }
 static Music_Emu* new_nsfe_file() { return BLARGG_NEW Nsfe_File; }
 
-static gme_type_t_ const gme_nsfe_type_ = { "Nintendo NES", 0, &new_nsfe_emu, &new_nsfe_file, "NSFE", 1 };
+static gme_type_t_ const gme_nsfe_type_ = { "Nintendo NES", 0, &new_nsfe_emu, &new_nsfe_file, "NSFE", 0x05 };
 extern gme_type_t const gme_nsfe_type = &gme_nsfe_type_;
 
 
@@ -321,6 +321,12 @@ blargg_err_t Nsfe_Emu::load_( Data_Reader& in )
 	return err;
 }
 
+blargg_err_t Nsfe_Emu::load_mem_( byte const* data, long size )
+{
+	// NSF data is extracted from chunks, so use default, which reads it with load_()
+	return Gme_File::load_mem_( data, size );
+}
+
 void Nsfe_Emu::disable_playlist( bool b )
 {
 	info.disable_playlist( b );
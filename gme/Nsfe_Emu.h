@@ -56,6 +56,7 @@ public:
 	~Nsfe_Emu();
 protected:
 	blargg_err_t load_( Data_Reader& );
+	blargg_err_t load_mem_( byte const*, long );
 	blargg_err_t track_info_( track_info_t*, int track ) const;
 	blargg_err_t start_track_( int );
 	void unload();
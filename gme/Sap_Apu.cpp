@@ -2,6 +2,7 @@
 
 #include "Sap_Apu.h"
 
+#include "Emu_State.h"
 #include <string.h>
 
 /* Copyright (C) 2006 Shay Green. This module is free software; you
@@ -77,6 +78,25 @@ Sap_Apu::Sap_Apu()
 		osc_output( i, 0 );
 }
 
+void Sap_Apu::copy_state( Emu_State& s )
+{
+	for ( int i = 0; i < osc_count; i++ )
+	{
+		osc_t& osc = oscs [i];
+		s( osc.regs );
+		s( osc.phase );
+		s( osc.invert );
+		s( osc.last_amp );
+		s( osc.delay );
+		s( osc.period );
+	}
+	s( last_time );
+	s( poly5_pos );
+	s( poly4_pos );
+	s( polym_pos );
+	s( control );
+}
+
 void Sap_Apu::reset( Sap_Apu_Impl* new_impl )
 {
 	impl      = new_impl;
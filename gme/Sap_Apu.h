@@ -22,6 +22,9 @@ public:
 
 	void end_frame( blip_time_t );
 
+	// Save/load emulation state in native format, without affecting settings
+	void copy_state( Emu_State& );
+
 public:
 	Sap_Apu();
 private:
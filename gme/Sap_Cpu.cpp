@@ -2,6 +2,7 @@
 
 #include "Sap_Cpu.h"
 
+#include "Emu_State.h"
 #include <limits.h>
 #include "blargg_endian.h"
 
@@ -40,6 +41,15 @@ enum {
     st_c = 0x01
 };
 
+void Sap_Cpu::copy_state( Emu_State& s )
+{
+	assert( state == &state_ );
+	s( r );
+	s( state_ );
+	s( irq_time_ );
+	s( end_time_ );
+}
+
 void Sap_Cpu::reset( void* new_mem )
 {
 	check( state == &state_ );
@@ -116,6 +126,7 @@ bool Sap_Cpu::run( sap_time_t end_time )
 dec_clock_loop:
 	s_time--;
 loop:
+	GME_STAT( instr_count_++ );
 
 	#ifndef NDEBUG
 	{
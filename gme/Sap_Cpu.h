@@ -6,6 +6,8 @@
 
 #include "blargg_common.h"
 
+class Emu_State;
+
 typedef int32_t sap_time_t; // clock cycle count
 typedef unsigned sap_addr_t; // 16-bit address
 enum { future_sap_time = INT_MAX / 2 + 1 };
@@ -43,8 +45,14 @@ public:
 	sap_time_t end_time() const         { return end_time_; }
 	void set_end_time( sap_time_t );
 
+	// Number of instructions executed. Only counted if GME_STATS is defined.
+	uint64_t instr_count() const        { return instr_count_; }
+
+	// Save/load registers and timing. Memory isn't included. Can't be called during run().
+	void copy_state( Emu_State& );
+
 public:
-	Sap_Cpu() { state = &state_; }
+	Sap_Cpu() { state = &state_; instr_count_ = 0; }
 	enum { irq_inhibit = 0x04 };
 private:
 	struct state_t {
@@ -53,6 +61,7 @@ private:
 	};
 	state_t* state; // points to state_ or a local copy within run()
 	state_t state_;
+	uint64_t instr_count_;
 	sap_time_t irq_time_;
 	sap_time_t end_time_;
 	uint8_t* mem;
@@ -379,6 +379,7 @@ void Sap_Emu::cpu_write_( sap_addr_t addr, int data )
 {
 	if ( (addr ^ Sap_Apu::start_addr) <= (Sap_Apu::end_addr - Sap_Apu::start_addr) )
 	{
+		GME_STAT( stats.apu_writes++ );
 		GME_APU_HOOK( this, addr - Sap_Apu::start_addr, data );
 		apu.write_data( time() & time_mask, addr, data );
 		return;
@@ -387,6 +388,7 @@ void Sap_Emu::cpu_write_( sap_addr_t addr, int data )
 	if ( (addr ^ (Sap_Apu::start_addr + 0x10)) <= (Sap_Apu::end_addr - Sap_Apu::start_addr) &&
 			info.stereo )
 	{
+		GME_STAT( stats.apu_writes++ );
 		GME_APU_HOOK( this, addr - 0x10 - Sap_Apu::start_addr + 10, data );
 		apu2.write_data( time() & time_mask, addr ^ 0x10, data );
 		return;
@@ -410,6 +412,22 @@ inline void Sap_Emu::call_play()
 	}
 }
 
+void Sap_Emu::copy_state_( Emu_State& s )
+{
+	Classic_Emu::copy_state_( s );
+	cpu::copy_state( s );
+	s( mem.ram );
+	s( next_play );
+	apu.copy_state( s );
+	apu2.copy_state( s );
+}
+
+void Sap_Emu::get_stats_( stats_t* out ) const
+{
+	Classic_Emu::get_stats_( out );
+	out->cpu_instructions += cpu::instr_count();
+}
+
 blargg_err_t Sap_Emu::run_clocks( blip_time_t& duration, int )
 {
 	set_time( 0 );
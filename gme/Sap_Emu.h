@@ -37,6 +37,8 @@ protected:
 	void set_tempo_( double );
 	void set_voice( int, Blip_Buffer*, Blip_Buffer*, Blip_Buffer* );
 	void update_eq( blip_eq_t const& );
+	void copy_state_( Emu_State& );
+	void get_stats_( stats_t* ) const;
 public: private: friend class Sap_Cpu;
 	int cpu_read( sap_addr_t );
 	void cpu_write( sap_addr_t, int );
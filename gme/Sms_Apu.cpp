@@ -2,6 +2,8 @@
 
 #include "Sms_Apu.h"
 
+#include "Emu_State.h"
+
 /* Copyright (C) 2003-2006 Shay Green. This module is free software; you
 can redistribute it and/or modify it under the terms of the GNU Lesser
 General Public License as published by the Free Software Foundation; either
@@ -206,6 +208,36 @@ void Sms_Apu::output( Blip_Buffer* center, Blip_Buffer* left, Blip_Buffer* right
 		osc_output( i, center, left, right );
 }
 
+void Sms_Apu::copy_state( Emu_State& s )
+{
+	for ( int i = 0; i < osc_count; i++ )
+	{
+		Sms_Osc& osc = *oscs [i];
+		s( osc.output_select );
+		if ( (unsigned) osc.output_select > 3 )
+		{
+			s.set_corrupt();
+			osc.output_select = 3;
+		}
+		osc.output = osc.outputs [osc.output_select];
+		s( osc.delay );
+		s( osc.last_amp );
+		s( osc.volume );
+	}
+
+	for ( int i = 0; i < 3; i++ )
+	{
+		s( squares [i].period );
+		s( squares [i].phase );
+	}
+
+	s( noise.period ); // points to table or squares [2].period
+	s( noise.shifter );
+	s( noise.feedback );
+	s( last_time );
+	s( latch );
+}
+
 void Sms_Apu::reset( unsigned feedback, int noise_width )
 {
 	last_time = 0;
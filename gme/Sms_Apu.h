@@ -42,9 +42,13 @@ public:
 	// start a new frame at time 0.
 	void end_frame( blip_time_t );
 
+	// Save/load emulation state in native format, without affecting settings
+	void copy_state( Emu_State& );
+
 public:
 	Sms_Apu();
 	~Sms_Apu();
+	BLARGG_DISABLE_NOTHROW
 private:
 	// noncopyable
 	Sms_Apu( const Sms_Apu& );
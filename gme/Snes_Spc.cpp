@@ -4,6 +4,7 @@
 
 #include "Snes_Spc.h"
 
+#include "Emu_State.h"
 #include <string.h>
 
 /* Copyright (C) 2004-2007 Shay Green. This module is free software; you
@@ -33,6 +34,8 @@ blargg_err_t Snes_Spc::init()
 {
 	memset( &m, 0, sizeof m );
 	dsp.init( RAM );
+	instr_count_     = 0;
+	dsp_write_count_ = 0;
 
 	m.tempo = tempo_unit;
 
@@ -381,3 +384,12 @@ blargg_err_t Snes_Spc::skip( int count )
 
 	return play( count, 0 );
 }
+
+void Snes_Spc::copy_state( Emu_State& s )
+{
+	int const tempo = m.tempo;
+	s( m );
+	if ( s.loading() )
+		set_tempo( tempo ); // also restores timer prescalers
+	dsp.copy_state( s );
+}
@@ -65,6 +65,9 @@ public:
 
 	void disable_echo( bool disable = true );
 
+	// Enables/disables cache of decoded BRR samples. Only affects speed.
+	void enable_brr_cache( bool enable = true );
+
 	// Sets tempo, where tempo_unit = normal, tempo_unit / 2 = half speed, etc.
 	static const unsigned int tempo_unit = 0x100;
 	void set_tempo( int );
@@ -86,6 +89,15 @@ public:
 	// Skips count samples. Several times faster than play() when using fast DSP.
 	blargg_err_t skip( int count );
 
+	// Saves/loads emulation state in native format, without affecting tempo or
+	// sound settings. Must be called between calls to play().
+	void copy_state( Emu_State& );
+
+	// Number of SPC-700 instructions executed and DSP register writes. Only counted
+	// if GME_STATS is defined.
+	uint64_t instr_count() const        { return instr_count_; }
+	uint64_t dsp_write_count() const    { return dsp_write_count_; }
+
 // State save/load (only available with accurate DSP)
 
 #if !SPC_NO_COPY_STATE_FUNCS
@@ -192,6 +204,8 @@ private:
 		} ram;
 	};
 	state_t m;
+	uint64_t instr_count_;
+	uint64_t dsp_write_count_;
 
 	enum { rom_addr = 0xFFC0 };
 
@@ -280,6 +294,8 @@ inline void Snes_Spc::disable_surround( bool disable ) { dsp.disable_surround( d
 
 inline void Snes_Spc::disable_echo( bool disable ) { dsp.disable_echo( disable ); }
 
+inline void Snes_Spc::enable_brr_cache( bool enable ) { dsp.enable_brr_cache( enable ); }
+
 #if !SPC_NO_COPY_STATE_FUNCS
 inline bool Snes_Spc::check_kon() { return dsp.check_kon(); }
 #endif
@@ -32,6 +32,16 @@ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA */
 	#define SPC_MORE_ACCURACY 0
 #endif
 
+// SPC_CPU_COMPUTED_GOTO: dispatch instructions through a table of labels (a GCC
+// extension also supported by Clang) rather than a switch
+#ifndef SPC_CPU_COMPUTED_GOTO
+	#ifdef __GNUC__
+		#define SPC_CPU_COMPUTED_GOTO 1
+	#else
+		#define SPC_CPU_COMPUTED_GOTO 0
+	#endif
+#endif
+
 #ifdef BLARGG_ENABLE_OPTIMIZER
 	#include BLARGG_ENABLE_OPTIMIZER
 #endif
@@ -153,6 +163,7 @@ int Snes_Spc::dsp_read( rel_time_t time )
 
 inline void Snes_Spc::dsp_write( int data, rel_time_t time )
 {
+	GME_STAT( dsp_write_count_++ );
 	RUN_DSP( time, reg_times [REGS [r_dspaddr]] )
 	#if SPC_LESS_ACCURATE
 		else if ( m.dsp_time == skipping_time )
@@ -135,6 +135,43 @@ int const nz_neg_mask = 0x880; // either bit set indicates N flag set
 	nz  = (in << 4 & 0x800) | (~in & z02);\
 }
 
+#ifndef SPC_CPU_OPCODE_HOOK
+	#define SPC_CPU_OPCODE_HOOK( pc, opcode ) ((void) 0)
+#endif
+
+// Reads opcode and first operand of next instruction, unless out of time
+#define FETCH_INSTR()\
+{\
+	check( (unsigned) a < 0x100 );\
+	check( (unsigned) x < 0x100 );\
+	check( (unsigned) y < 0x100 );\
+\
+	opcode = ram [pc];\
+	if ( (rel_time += m.cycle_table [opcode]) > 0 )\
+		goto out_of_time;\
+	GME_STAT( instr_count_++ );\
+	SPC_CPU_OPCODE_HOOK( GET_PC(), opcode );\
+\
+	/* TODO: if PC is at end of memory, this will get wrong operand (very obscure) */\
+	pc++;\
+	data = ram [pc];\
+}
+
+#if SPC_CPU_COMPUTED_GOTO
+	// Each instruction jumps straight to the next one's label, so the host CPU
+	// predicts each of these indirect jumps separately
+	#define CASE_( n )      /*FALLTHRU*/case 0x##n: op_##n:
+	#define NEXT_INSTR()    { FETCH_INSTR(); goto *op_table [opcode]; }
+#else
+	#define CASE_( n )      /*FALLTHRU*/case 0x##n:
+	#define NEXT_INSTR()    goto loop
+#endif
+
+#define INC_PC_NEXT_INSTR() { pc++; NEXT_INSTR(); }
+
+// Case for opcode n, written as two hex digits
+#define CASE( n )       CASE_( n )
+
 SPC_CPU_RUN_FUNC
 {
 	uint8_t* const ram = RAM;
@@ -159,24 +196,13 @@ SPC_CPU_RUN_FUNC
 
 cbranch_taken_loop:
 	pc += (int8_t) ram [pc];
-inc_pc_loop:
 	pc++;
 loop:
 {
 	unsigned opcode;
 	unsigned data;
 
-	check( (unsigned) a < 0x100 );
-	check( (unsigned) x < 0x100 );
-	check( (unsigned) y < 0x100 );
-
-	opcode = ram [pc];
-	if ( (rel_time += m.cycle_table [opcode]) > 0 )
-		goto out_of_time;
-
-	#ifdef SPC_CPU_OPCODE_HOOK
-		SPC_CPU_OPCODE_HOOK( GET_PC(), opcode );
-	#endif
+	FETCH_INSTR();
 	/*
 	//SUB_CASE_COUNTER( 1 );
 	#define PROFILE_TIMER_LOOP( op, addr, len )\
@@ -192,9 +218,21 @@ loop:
 	PROFILE_TIMER_LOOP( 0xE4, pc [1], 2 );
 	*/
 
-	// TODO: if PC is at end of memory, this will get wrong operand (very obscure)
-	pc++;
-	data = ram [pc];
+	#if SPC_CPU_COMPUTED_GOTO
+		#define OP_ROW( hi ) \
+			&&op_##hi##0, &&op_##hi##1, &&op_##hi##2, &&op_##hi##3,\
+			&&op_##hi##4, &&op_##hi##5, &&op_##hi##6, &&op_##hi##7,\
+			&&op_##hi##8, &&op_##hi##9, &&op_##hi##A, &&op_##hi##B,\
+			&&op_##hi##C, &&op_##hi##D, &&op_##hi##E, &&op_##hi##F
+
+		static void* const op_table [256] = {
+			OP_ROW( 0 ), OP_ROW( 1 ), OP_ROW( 2 ), OP_ROW( 3 ),
+			OP_ROW( 4 ), OP_ROW( 5 ), OP_ROW( 6 ), OP_ROW( 7 ),
+			OP_ROW( 8 ), OP_ROW( 9 ), OP_ROW( A ), OP_ROW( B ),
+			OP_ROW( C ), OP_ROW( D ), OP_ROW( E ), OP_ROW( F )
+		};
+		goto *op_table [opcode];
+	#endif
 	switch ( opcode )
 	{
 
@@ -205,47 +243,47 @@ loop:
 	pc++;\
 	pc += (int8_t) data;\
 	if ( cond )\
-		goto loop;\
+		NEXT_INSTR();\
 	pc -= (int8_t) data;\
 	rel_time -= 2;\
-	goto loop;\
+	NEXT_INSTR();\
 }
 
-	case 0xF0: // BEQ
+	CASE( F0 ) // BEQ
 		BRANCH( !(uint8_t) nz ) // 89% taken
 
-	case 0xD0: // BNE
+	CASE( D0 ) // BNE
 		BRANCH( (uint8_t) nz )
 
-	case 0x3F:{// CALL
+	CASE( 3F ){// CALL
 		int old_addr = GET_PC() + 2;
 		SET_PC( READ_PC16( pc ) );
 		PUSH16( old_addr );
-		goto loop;
+		NEXT_INSTR();
 	}
 
-	case 0x6F:// RET
+	CASE( 6F )// RET
 		{
 			uint8_t l, h;
 			POP( l );
 			POP( h );
 			SET_PC( l | (h << 8) );
 		}
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xE4: // MOV a,dp
+	CASE( E4 ) // MOV a,dp
 		++pc;
 		// 80% from timer
 		READ_DP_TIMER( 0, data, a = nz );
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xFA:{// MOV dp,dp
+	CASE( FA ){// MOV dp,dp
 		int temp;
 		READ_DP_TIMER( -2, data, temp );
 		data = temp + no_read_before_write ;
 	}
 	// fall through
-	case 0x8F:{// MOV dp,#imm
+	CASE( 8F ){// MOV dp,#imm
 		int temp = READ_PC( pc + 1 );
 		pc += 2;
 
@@ -266,10 +304,10 @@ loop:
 		#else
 			WRITE_DP( 0, temp, data );
 		#endif
-		goto loop;
+		NEXT_INSTR();
 	}
 
-	case 0xC4: // MOV dp,a
+	CASE( C4 ) // MOV dp,a
 		++pc;
 		#if !SPC_MORE_ACCURACY
 		{
@@ -290,278 +328,281 @@ loop:
 		#else
 			WRITE_DP( 0, data, a );
 		#endif
-		goto loop;
+		NEXT_INSTR();
 
-#define CASE( n )   /*FALLTHRU*/case n:
+#define ADDR_CASE( hi, lo ) CASE( hi##lo )
 
-// Define common address modes based on opcode for immediate mode. Execution
-// ends with data set to the address of the operand.
-#define ADDR_MODES_( op )\
-	CASE( op - 0x02 ) /* (X) */\
+// Define common address modes based on opcode for immediate mode, hi##8, where
+// hi1 is the next higher digit. Execution ends with data set to the address of
+// the operand.
+#define ADDR_MODES_( hi, hi1 )\
+	ADDR_CASE( hi, 6 ) /* (X) */\
 		data = x + dp;\
 		pc--;\
-		goto end_##op;\
-	CASE( op + 0x0F ) /* (dp)+Y */\
+		goto end_##hi##8;\
+	ADDR_CASE( hi1, 7 ) /* (dp)+Y */\
 		data = READ_PROG16( data + dp ) + y;\
-		goto end_##op;\
-	CASE( op - 0x01 ) /* (dp+X) */\
+		goto end_##hi##8;\
+	ADDR_CASE( hi, 7 ) /* (dp+X) */\
 		data = READ_PROG16( ((uint8_t) (data + x)) + dp );\
-		goto end_##op;\
-	CASE( op + 0x0E ) /* abs+Y */\
+		goto end_##hi##8;\
+	ADDR_CASE( hi1, 6 ) /* abs+Y */\
 		data += y;\
-		goto abs_##op;\
-	CASE( op + 0x0D ) /* abs+X */\
+		goto abs_##hi##8;\
+	ADDR_CASE( hi1, 5 ) /* abs+X */\
 		data += x;/*FALLTHRU*/\
-	CASE( op - 0x03 ) /* abs */\
-	abs_##op:\
+	ADDR_CASE( hi, 5 ) /* abs */\
+	abs_##hi##8:\
 		data += 0x100 * READ_PC( ++pc );\
-		goto end_##op;\
-	CASE( op + 0x0C ) /* dp+X */\
+		goto end_##hi##8;\
+	ADDR_CASE( hi1, 4 ) /* dp+X */\
 		data = (uint8_t) (data + x);/*FALLTHRU*/
 
-#define ADDR_MODES_NO_DP( op )\
-	ADDR_MODES_( op )\
+#define ADDR_MODES_NO_DP( hi, hi1 )\
+	ADDR_MODES_( hi, hi1 )\
 		data += dp;\
-	end_##op:
+	end_##hi##8:
 
-#define ADDR_MODES( op )\
-	ADDR_MODES_( op )\
-	CASE( op - 0x04 ) /* dp */\
+#define ADDR_MODES( hi, hi1 )\
+	ADDR_MODES_( hi, hi1 )\
+	ADDR_CASE( hi, 4 ) /* dp */\
 		data += dp;\
-	end_##op:
+	end_##hi##8:
 
 // 1. 8-bit Data Transmission Commands. Group I
 
-	ADDR_MODES_NO_DP( 0xE8 ) // MOV A,addr
+	ADDR_MODES_NO_DP( E, F ) // MOV A,addr
 		a = nz = READ( 0, data );
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
-	case 0xBF:{// MOV A,(X)+
+	CASE( BF ){// MOV A,(X)+
 		int temp = x + dp;
 		x = (uint8_t) (x + 1);
 		a = nz = READ( -1, temp );
-		goto loop;
+		NEXT_INSTR();
 	}
 
-	case 0xE8: // MOV A,imm
+	CASE( E8 ) // MOV A,imm
 		a  = data;
 		nz = data;
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
-	case 0xF9: // MOV X,dp+Y
+	CASE( F9 ) // MOV X,dp+Y
 		data = (uint8_t) (data + y);/*FALLTHRU*/
-	case 0xF8: // MOV X,dp
+	CASE( F8 ) // MOV X,dp
 		READ_DP_TIMER( 0, data, x = nz );
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
-	case 0xE9: // MOV X,abs
+	CASE( E9 ) // MOV X,abs
 		data = READ_PC16( pc );
 		++pc;
 		data = READ( 0, data );/*FALLTHRU*/
-	case 0xCD: // MOV X,imm
+	CASE( CD ) // MOV X,imm
 		x  = data;
 		nz = data;
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
-	case 0xFB: // MOV Y,dp+X
+	CASE( FB ) // MOV Y,dp+X
 		data = (uint8_t) (data + x);/*FALLTHRU*/
-	case 0xEB: // MOV Y,dp
+	CASE( EB ) // MOV Y,dp
 		// 70% from timer
 		pc++;
 		READ_DP_TIMER( 0, data, y = nz );
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xEC:{// MOV Y,abs
+	CASE( EC ){// MOV Y,abs
 		int temp = READ_PC16( pc );
 		pc += 2;
 		READ_TIMER( 0, temp, y = nz );
 		//y = nz = READ( 0, temp );
-		goto loop;
+		NEXT_INSTR();
 	}
 
-	case 0x8D: // MOV Y,imm
+	CASE( 8D ) // MOV Y,imm
 		y  = data;
 		nz = data;
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
 // 2. 8-BIT DATA TRANSMISSION COMMANDS, GROUP 2
 
-	ADDR_MODES_NO_DP( 0xC8 ) // MOV addr,A
+	ADDR_MODES_NO_DP( C, D ) // MOV addr,A
 		WRITE( 0, data, a );
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
 	{
 		int temp;
-	case 0xCC: // MOV abs,Y
+	CASE( CC ) // MOV abs,Y
 		temp = y;
 		goto mov_abs_temp;
-	case 0xC9: // MOV abs,X
+	CASE( C9 ) // MOV abs,X
 		temp = x;
 	mov_abs_temp:
 		WRITE( 0, READ_PC16( pc ), temp );
 		pc += 2;
-		goto loop;
+		NEXT_INSTR();
 	}
 
-	case 0xD9: // MOV dp+Y,X
+	CASE( D9 ) // MOV dp+Y,X
 		data = (uint8_t) (data + y);/*FALLTHRU*/
-	case 0xD8: // MOV dp,X
+	CASE( D8 ) // MOV dp,X
 		WRITE( 0, data + dp, x );
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
-	case 0xDB: // MOV dp+X,Y
+	CASE( DB ) // MOV dp+X,Y
 		data = (uint8_t) (data + x);/*FALLTHRU*/
-	case 0xCB: // MOV dp,Y
+	CASE( CB ) // MOV dp,Y
 		WRITE( 0, data + dp, y );
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
 // 3. 8-BIT DATA TRANSMISSIN COMMANDS, GROUP 3.
 
-	case 0x7D: // MOV A,X
+	CASE( 7D ) // MOV A,X
 		a  = x;
 		nz = x;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xDD: // MOV A,Y
+	CASE( DD ) // MOV A,Y
 		a  = y;
 		nz = y;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0x5D: // MOV X,A
+	CASE( 5D ) // MOV X,A
 		x  = a;
 		nz = a;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xFD: // MOV Y,A
+	CASE( FD ) // MOV Y,A
 		y  = a;
 		nz = a;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0x9D: // MOV X,SP
+	CASE( 9D ) // MOV X,SP
 		x = nz = GET_SP();
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xBD: // MOV SP,X
+	CASE( BD ) // MOV SP,X
 		SET_SP( x );
-		goto loop;
+		NEXT_INSTR();
 
-	//case 0xC6: // MOV (X),A (handled by MOV addr,A in group 2)
+	//CASE( C6 ) // MOV (X),A (handled by MOV addr,A in group 2)
 
-	case 0xAF: // MOV (X)+,A
+	CASE( AF ) // MOV (X)+,A
 		WRITE_DP( 0, x, a + no_read_before_write  );
 		x = (uint8_t) (x + 1);
-		goto loop;
+		NEXT_INSTR();
 
 // 5. 8-BIT LOGIC OPERATION COMMANDS
 
-#define LOGICAL_OP( op, func )\
-	ADDR_MODES( op ) /* addr */\
+#define LOGICAL_OP( hi, hi1, func )\
+	ADDR_MODES( hi, hi1 ) /* addr */\
 		data = READ( 0, data );/*FALLTHRU*/\
-	case op: /* imm */\
+	CASE( hi##8 ) /* imm */\
 		nz = a func##= data;\
-		goto inc_pc_loop;\
+		INC_PC_NEXT_INSTR();\
 	{   unsigned addr;\
-	case op + 0x11: /* X,Y */\
+	CASE( hi1##9 ) /* X,Y */\
 		data = READ_DP( -2, y );\
 		addr = x + dp;\
-		goto addr_##op;\
-	case op + 0x01: /* dp,dp */\
+		goto addr_##hi##8;\
+	CASE( hi##9 ) /* dp,dp */\
 		data = READ_DP( -3, data );\
-	case op + 0x10:{/*dp,imm*/\
+	CASE( hi1##8 ){/*dp,imm*/\
 		uint16_t addr2 = pc + 1;\
 		pc += 2;\
 		addr = READ_PC( addr2 ) + dp;\
 	}\
-	addr_##op:\
+	addr_##hi##8:\
 		nz = data func READ( -1, addr );\
 		WRITE( 0, addr, nz );\
-		goto loop;\
+		NEXT_INSTR();\
 	}
 
-	LOGICAL_OP( 0x28, & ); // AND
+	LOGICAL_OP( 2, 3, & ); // AND
 
-	LOGICAL_OP( 0x08, | ); // OR
+	LOGICAL_OP( 0, 1, | ); // OR
 
-	LOGICAL_OP( 0x48, ^ ); // EOR
+	LOGICAL_OP( 4, 5, ^ ); // EOR
 
 // 4. 8-BIT ARITHMETIC OPERATION COMMANDS
 
-	ADDR_MODES( 0x68 ) // CMP addr
+	ADDR_MODES( 6, 7 ) // CMP addr
 		data = READ( 0, data );/*FALLTHRU*/
-	case 0x68: // CMP imm
+	CASE( 68 ) // CMP imm
 		nz = a - data;
 		c = ~nz;
 		nz &= 0xFF;
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
-	case 0x79: // CMP (X),(Y)
+	CASE( 79 ) // CMP (X),(Y)
 		data = READ_DP( -2, y );
 		nz = READ_DP( -1, x ) - data;
 		c = ~nz;
 		nz &= 0xFF;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0x69: // CMP dp,dp
+	CASE( 69 ) // CMP dp,dp
 		data = READ_DP( -3, data );/*FALLTHRU*/
-	case 0x78: // CMP dp,imm
+	CASE( 78 ) // CMP dp,imm
 		nz = READ_DP( -1, READ_PC( ++pc ) ) - data;
 		c = ~nz;
 		nz &= 0xFF;
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
-	case 0x3E: // CMP X,dp
+	CASE( 3E ) // CMP X,dp
 		data += dp;
 		goto cmp_x_addr;
-	case 0x1E: // CMP X,abs
+	CASE( 1E ) // CMP X,abs
 		data = READ_PC16( pc );
 		pc++;
 	cmp_x_addr:
 		data = READ( 0, data );/*FALLTHRU*/
-	case 0xC8: // CMP X,imm
+	CASE( C8 ) // CMP X,imm
 		nz = x - data;
 		c = ~nz;
 		nz &= 0xFF;
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
-	case 0x7E: // CMP Y,dp
+	CASE( 7E ) // CMP Y,dp
 		data += dp;
 		goto cmp_y_addr;
-	case 0x5E: // CMP Y,abs
+	CASE( 5E ) // CMP Y,abs
 		data = READ_PC16( pc );
 		pc++;
 	cmp_y_addr:
 		data = READ( 0, data );/*FALLTHRU*/
-	case 0xAD: // CMP Y,imm
+	CASE( AD ) // CMP Y,imm
 		nz = y - data;
 		c = ~nz;
 		nz &= 0xFF;
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
 	{
 		int addr;
-	case 0xB9: // SBC (x),(y)
-	case 0x99: // ADC (x),(y)
+	CASE( B9 ) // SBC (x),(y)
+	CASE( 99 ) // ADC (x),(y)
 		pc--; // compensate for inc later
 		data = READ_DP( -2, y );
 		addr = x + dp;
 		goto adc_addr;
-	case 0xA9: // SBC dp,dp
-	case 0x89: // ADC dp,dp
+	CASE( A9 ) // SBC dp,dp
+	CASE( 89 ) // ADC dp,dp
 		data = READ_DP( -3, data );
-	case 0xB8: // SBC dp,imm
-	case 0x98: // ADC dp,imm
+	CASE( B8 ) // SBC dp,imm
+	CASE( 98 ) // ADC dp,imm
 		addr = READ_PC( ++pc ) + dp;
 	adc_addr:
 		nz = READ( -1, addr );
 		goto adc_data;
 
 // catch ADC and SBC together, then decode later based on operand
-#undef CASE
-#define CASE( n ) case n: case (n) + 0x20:
-	ADDR_MODES( 0x88 ) // ADC/SBC addr
+#undef ADDR_CASE
+#define ADDR_CASE( hi, lo ) CASE( hi##lo ) CASE( SBC_##hi( lo ) )
+#define SBC_8( lo ) A##lo
+#define SBC_9( lo ) B##lo
+	ADDR_MODES( 8, 9 ) // ADC/SBC addr
 		data = READ( 0, data );
-	case 0xA8: // SBC imm
-	case 0x88: // ADC imm
+	CASE( A8 ) // SBC imm
+	CASE( 88 ) // ADC imm
 		addr = -1; // A
 		nz = a;
 	adc_data: {
@@ -580,10 +621,10 @@ loop:
 		if ( addr < 0 )
 		{
 			a = (uint8_t) nz;
-			goto inc_pc_loop;
+			INC_PC_NEXT_INSTR();
 		}
 		WRITE( 0, addr, /*(uint8_t)*/ nz );
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 	}
 
 	}
@@ -593,90 +634,90 @@ loop:
 #define INC_DEC_REG( reg, op )\
 		nz  = reg op;\
 		reg = (uint8_t) nz;\
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xBC: INC_DEC_REG( a, + 1 ) // INC A
-	case 0x3D: INC_DEC_REG( x, + 1 ) // INC X
-	case 0xFC: INC_DEC_REG( y, + 1 ) // INC Y
+	CASE( BC ) INC_DEC_REG( a, + 1 ) // INC A
+	CASE( 3D ) INC_DEC_REG( x, + 1 ) // INC X
+	CASE( FC ) INC_DEC_REG( y, + 1 ) // INC Y
 
-	case 0x9C: INC_DEC_REG( a, - 1 ) // DEC A
-	case 0x1D: INC_DEC_REG( x, - 1 ) // DEC X
-	case 0xDC: INC_DEC_REG( y, - 1 ) // DEC Y
+	CASE( 9C ) INC_DEC_REG( a, - 1 ) // DEC A
+	CASE( 1D ) INC_DEC_REG( x, - 1 ) // DEC X
+	CASE( DC ) INC_DEC_REG( y, - 1 ) // DEC Y
 
-	case 0x9B: // DEC dp+X
-	case 0xBB: // INC dp+X
+	CASE( 9B ) // DEC dp+X
+	CASE( BB ) // INC dp+X
 		data = (uint8_t) (data + x); /* fallthrough */
-	case 0x8B: // DEC dp
-	case 0xAB: // INC dp
+	CASE( 8B ) // DEC dp
+	CASE( AB ) // INC dp
 		data += dp;
 		goto inc_abs;
-	case 0x8C: // DEC abs
-	case 0xAC: // INC abs
+	CASE( 8C ) // DEC abs
+	CASE( AC ) // INC abs
 		data = READ_PC16( pc );
 		pc++;
 	inc_abs:
 		nz = (opcode >> 4 & 2) - 1;
 		nz += READ( -1, data );
 		WRITE( 0, data, /*(uint8_t)*/ nz );
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
 // 7. SHIFT, ROTATION COMMANDS
 
-	case 0x5C: // LSR A
+	CASE( 5C ) // LSR A
 		c = 0; /*fallthrough*/
-	case 0x7C:{// ROR A
+	CASE( 7C ){// ROR A
 		nz = (c >> 1 & 0x80) | (a >> 1);
 		c = a << 8;
 		a = nz;
-		goto loop;
+		NEXT_INSTR();
 	}
 
-	case 0x1C: // ASL A
+	CASE( 1C ) // ASL A
 		c = 0; /*fallthrough*/
-	case 0x3C:{// ROL A
+	CASE( 3C ){// ROL A
 		int temp = c >> 8 & 1;
 		c = a << 1;
 		nz = c | temp;
 		a = (uint8_t) nz;
-		goto loop;
+		NEXT_INSTR();
 	}
 
-	case 0x0B: // ASL dp
+	CASE( 0B ) // ASL dp
 		c = 0;
 		data += dp;
 		goto rol_mem;
-	case 0x1B: // ASL dp+X
+	CASE( 1B ) // ASL dp+X
 		c = 0; /*fallthrough*/
-	case 0x3B: // ROL dp+X
+	CASE( 3B ) // ROL dp+X
 		data = (uint8_t) (data + x); /*fallthrough*/
-	case 0x2B: // ROL dp
+	CASE( 2B ) // ROL dp
 		data += dp;
 		goto rol_mem;
-	case 0x0C: // ASL abs
+	CASE( 0C ) // ASL abs
 		c = 0; /*fallthrough*/
-	case 0x2C: // ROL abs
+	CASE( 2C ) // ROL abs
 		data = READ_PC16( pc );
 		pc++;
 	rol_mem:
 		nz = c >> 8 & 1;
 		nz |= (c = READ( -1, data ) << 1);
 		WRITE( 0, data, /*(uint8_t)*/ nz );
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
-	case 0x4B: // LSR dp
+	CASE( 4B ) // LSR dp
 		c = 0;
 		data += dp;
 		goto ror_mem;
-	case 0x5B: // LSR dp+X
+	CASE( 5B ) // LSR dp+X
 		c = 0; /*fallthrough*/
-	case 0x7B: // ROR dp+X
+	CASE( 7B ) // ROR dp+X
 		data = (uint8_t) (data + x); /*fallthrough*/
-	case 0x6B: // ROR dp
+	CASE( 6B ) // ROR dp
 		data += dp;
 		goto ror_mem;
-	case 0x4C: // LSR abs
+	CASE( 4C ) // LSR abs
 		c = 0; /*fallthrough*/
-	case 0x6C: // ROR abs
+	CASE( 6C ) // ROR abs
 		data = READ_PC16( pc );
 		pc++;
 	ror_mem: {
@@ -684,31 +725,31 @@ loop:
 		nz = (c >> 1 & 0x80) | (temp >> 1);
 		c = temp << 8;
 		WRITE( 0, data, nz );
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 	}
 
-	case 0x9F: // XCN
+	CASE( 9F ) // XCN
 		nz = a = (a >> 4) | (uint8_t) (a << 4);
-		goto loop;
+		NEXT_INSTR();
 
 // 8. 16-BIT TRANSMISION COMMANDS
 
-	case 0xBA: // MOVW YA,dp
+	CASE( BA ) // MOVW YA,dp
 		a = READ_DP( -2, data );
 		nz = (a & 0x7F) | (a >> 1);
 		y = READ_DP( 0, (uint8_t) (data + 1) );
 		nz |= y;
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
-	case 0xDA: // MOVW dp,YA
+	CASE( DA ) // MOVW dp,YA
 		WRITE_DP( -1, data, a );
 		WRITE_DP( 0, (uint8_t) (data + 1), y + no_read_before_write  );
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
 // 9. 16-BIT OPERATION COMMANDS
 
-	case 0x3A: // INCW dp
-	case 0x1A:{// DECW dp
+	CASE( 3A ) // INCW dp
+	CASE( 1A ){// DECW dp
 		int temp;
 		// low byte
 		data += dp;
@@ -723,11 +764,11 @@ loop:
 		nz |= temp;
 		WRITE( 0, data, temp );
 
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 	}
 
-	case 0x7A: // ADDW YA,dp
-	case 0x9A:{// SUBW YA,dp
+	CASE( 7A ) // ADDW YA,dp
+	CASE( 9A ){// SUBW YA,dp
 		int lo = READ_DP( -2, data );
 		int hi = READ_DP( 0, (uint8_t) (data + 1) );
 		int result;
@@ -752,10 +793,10 @@ loop:
 		y = result;
 		nz = (((lo >> 1) | lo) & 0x7F) | result;
 
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 	}
 
-	case 0x5A: { // CMPW YA,dp
+	CASE( 5A ) { // CMPW YA,dp
 		int temp = a - READ_DP( -1, data );
 		nz = ((temp >> 1) | temp) & 0x7F;
 		temp = y + (temp >> 8);
@@ -763,21 +804,21 @@ loop:
 		nz |= temp;
 		c  = ~temp;
 		nz &= 0xFF;
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 	}
 
 // 10. MULTIPLICATION & DIVISON COMMANDS
 
-	case 0xCF: { // MUL YA
+	CASE( CF ) { // MUL YA
 		unsigned temp = y * a;
 		a = (uint8_t) temp;
 		nz = ((temp >> 1) | temp) & 0x7F;
 		y = (uint8_t) (temp >> 8);
 		nz |= y;
-		goto loop;
+		NEXT_INSTR();
 	}
 
-	case 0x9E: // DIV YA,X
+	CASE( 9E ) // DIV YA,X
 	{
 		unsigned ya = y * 0x100 + a;
 
@@ -804,12 +845,12 @@ loop:
 		a = (uint8_t) a;
 		y = (uint8_t) y;
 
-		goto loop;
+		NEXT_INSTR();
 	}
 
 // 11. DECIMAL COMPENSATION COMMANDS
 
-	case 0xDF: // DAA
+	CASE( DF ) // DAA
 		SUSPICIOUS_OPCODE( "DAA" );
 		if ( a > 0x99 || c & 0x100 )
 		{
@@ -822,9 +863,9 @@ loop:
 
 		nz = a;
 		a = (uint8_t) a;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xBE: // DAS
+	CASE( BE ) // DAS
 		SUSPICIOUS_OPCODE( "DAS" );
 		if ( a > 0x99 || !(c & 0x100) )
 		{
@@ -837,30 +878,30 @@ loop:
 
 		nz = a;
 		a = (uint8_t) a;
-		goto loop;
+		NEXT_INSTR();
 
 // 12. BRANCHING COMMANDS
 
-	case 0x2F: // BRA rel
+	CASE( 2F ) // BRA rel
 		pc += (int8_t) data;
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 
-	case 0x30: // BMI
+	CASE( 30 ) // BMI
 		BRANCH( (nz & nz_neg_mask) )
 
-	case 0x10: // BPL
+	CASE( 10 ) // BPL
 		BRANCH( !(nz & nz_neg_mask) )
 
-	case 0xB0: // BCS
+	CASE( B0 ) // BCS
 		BRANCH( c & 0x100 )
 
-	case 0x90: // BCC
+	CASE( 90 ) // BCC
 		BRANCH( !(c & 0x100) )
 
-	case 0x70: // BVS
+	CASE( 70 ) // BVS
 		BRANCH( psw & v40 )
 
-	case 0x50: // BVC
+	CASE( 50 ) // BVC
 		BRANCH( !(psw & v40) )
 
 	#define CBRANCH( cond )\
@@ -869,59 +910,59 @@ loop:
 		if ( cond )\
 			goto cbranch_taken_loop;\
 		rel_time -= 2;\
-		goto inc_pc_loop;\
+		INC_PC_NEXT_INSTR();\
 	}
 
-	case 0x03: // BBS dp.bit,rel
-	case 0x23:
-	case 0x43:
-	case 0x63:
-	case 0x83:
-	case 0xA3:
-	case 0xC3:
-	case 0xE3:
+	CASE( 03 ) // BBS dp.bit,rel
+	CASE( 23 )
+	CASE( 43 )
+	CASE( 63 )
+	CASE( 83 )
+	CASE( A3 )
+	CASE( C3 )
+	CASE( E3 )
 		CBRANCH( READ_DP( -4, data ) >> (opcode >> 5) & 1 )
 
-	case 0x13: // BBC dp.bit,rel
-	case 0x33:
-	case 0x53:
-	case 0x73:
-	case 0x93:
-	case 0xB3:
-	case 0xD3:
-	case 0xF3:
+	CASE( 13 ) // BBC dp.bit,rel
+	CASE( 33 )
+	CASE( 53 )
+	CASE( 73 )
+	CASE( 93 )
+	CASE( B3 )
+	CASE( D3 )
+	CASE( F3 )
 		CBRANCH( !(READ_DP( -4, data ) >> (opcode >> 5) & 1) )
 
-	case 0xDE: // CBNE dp+X,rel
+	CASE( DE ) // CBNE dp+X,rel
 		data = (uint8_t) (data + x);
 		// fall through
-	case 0x2E:{// CBNE dp,rel
+	CASE( 2E ){// CBNE dp,rel
 		int temp;
 		// 61% from timer
 		READ_DP_TIMER( -4, data, temp );
 		CBRANCH( temp != a )
 	}
 
-	case 0x6E: { // DBNZ dp,rel
+	CASE( 6E ) { // DBNZ dp,rel
 		unsigned temp = READ_DP( -4, data ) - 1;
 		WRITE_DP( -3, (uint8_t) data, /*(uint8_t)*/ temp + no_read_before_write  );
 		CBRANCH( temp )
 	}
 
-	case 0xFE: // DBNZ Y,rel
+	CASE( FE ) // DBNZ Y,rel
 		y = (uint8_t) (y - 1);
 		BRANCH( y )
 
-	case 0x1F: // JMP [abs+X]
+	CASE( 1F ) // JMP [abs+X]
 		SET_PC( READ_PC16( pc ) + x );
 		// fall through
-	case 0x5F: // JMP abs
+	CASE( 5F ) // JMP abs
 		SET_PC( READ_PC16( pc ) );
-		goto loop;
+		NEXT_INSTR();
 
 // 13. SUB-ROUTINE CALL RETURN COMMANDS
 
-	case 0x0F:{// BRK
+	CASE( 0F ){// BRK
 		int temp;
 		int ret_addr = GET_PC();
 		SUSPICIOUS_OPCODE( "BRK" );
@@ -930,36 +971,36 @@ loop:
 		GET_PSW( temp );
 		psw = (psw | b10) & ~i04;
 		PUSH( temp );
-		goto loop;
+		NEXT_INSTR();
 	}
 
-	case 0x4F:{// PCALL offset
+	CASE( 4F ){// PCALL offset
 		int ret_addr = GET_PC() + 1;
 		SET_PC( 0xFF00 | data );
 		PUSH16( ret_addr );
-		goto loop;
+		NEXT_INSTR();
 	}
 
-	case 0x01: // TCALL n
-	case 0x11:
-	case 0x21:
-	case 0x31:
-	case 0x41:
-	case 0x51:
-	case 0x61:
-	case 0x71:
-	case 0x81:
-	case 0x91:
-	case 0xA1:
-	case 0xB1:
-	case 0xC1:
-	case 0xD1:
-	case 0xE1:
-	case 0xF1: {
+	CASE( 01 ) // TCALL n
+	CASE( 11 )
+	CASE( 21 )
+	CASE( 31 )
+	CASE( 41 )
+	CASE( 51 )
+	CASE( 61 )
+	CASE( 71 )
+	CASE( 81 )
+	CASE( 91 )
+	CASE( A1 )
+	CASE( B1 )
+	CASE( C1 )
+	CASE( D1 )
+	CASE( E1 )
+	CASE( F1 ) {
 		int ret_addr = GET_PC();
 		SET_PC( READ_PROG16( 0xFFDE - (opcode >> 3) ) );
 		PUSH16( ret_addr );
-		goto loop;
+		NEXT_INSTR();
 	}
 
 // 14. STACK OPERATION COMMANDS
@@ -967,79 +1008,79 @@ loop:
 	{
 		int temp;
 		uint8_t l, h;
-	case 0x7F: // RET1
+	CASE( 7F ) // RET1
 		POP (temp);
 		POP (l);
 		POP (h);
 		SET_PC( l | (h << 8) );
 		goto set_psw;
-	case 0x8E: // POP PSW
+	CASE( 8E ) // POP PSW
 		POP( temp );
 	set_psw:
 		SET_PSW( temp );
-		goto loop;
+		NEXT_INSTR();
 	}
 
-	case 0x0D: { // PUSH PSW
+	CASE( 0D ) { // PUSH PSW
 		int temp;
 		GET_PSW( temp );
 		PUSH( temp );
-		goto loop;
+		NEXT_INSTR();
 	}
 
-	case 0x2D: // PUSH A
+	CASE( 2D ) // PUSH A
 		PUSH( a );
-		goto loop;
+		NEXT_INSTR();
 
-	case 0x4D: // PUSH X
+	CASE( 4D ) // PUSH X
 		PUSH( x );
-		goto loop;
+		NEXT_INSTR();
 
-	case 0x6D: // PUSH Y
+	CASE( 6D ) // PUSH Y
 		PUSH( y );
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xAE: // POP A
+	CASE( AE ) // POP A
 		POP( a );
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xCE: // POP X
+	CASE( CE ) // POP X
 		POP( x );
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xEE: // POP Y
+	CASE( EE ) // POP Y
 		POP( y );
-		goto loop;
+		NEXT_INSTR();
 
 // 15. BIT OPERATION COMMANDS
 
-	case 0x02: // SET1
-	case 0x22:
-	case 0x42:
-	case 0x62:
-	case 0x82:
-	case 0xA2:
-	case 0xC2:
-	case 0xE2:
-	case 0x12: // CLR1
-	case 0x32:
-	case 0x52:
-	case 0x72:
-	case 0x92:
-	case 0xB2:
-	case 0xD2:
-	case 0xF2: {
+	CASE( 02 ) // SET1
+	CASE( 22 )
+	CASE( 42 )
+	CASE( 62 )
+	CASE( 82 )
+	CASE( A2 )
+	CASE( C2 )
+	CASE( E2 )
+	CASE( 12 ) // CLR1
+	CASE( 32 )
+	CASE( 52 )
+	CASE( 72 )
+	CASE( 92 )
+	CASE( B2 )
+	CASE( D2 )
+	CASE( F2 ) {
 		int bit = 1 << (opcode >> 5);
 		int mask = ~bit;
 		if ( opcode & 0x10 )
 			bit = 0;
 		data += dp;
 		WRITE( 0, data, (READ( -1, data ) & mask) | bit );
-		goto inc_pc_loop;
+		INC_PC_NEXT_INSTR();
 	}
 
-	case 0x0E: // TSET1 abs
-	case 0x4E: // TCLR1 abs
+	CASE( 0E ) // TSET1 abs
+	CASE( 4E ) // TCLR1 abs
 		data = READ_PC16( pc );
 		pc += 2;
 		{
@@ -1050,34 +1091,34 @@ loop:
 				temp |= a;
 			WRITE( 0, data, temp );
 		}
-		goto loop;
+		NEXT_INSTR();
 
-	case 0x4A: // AND1 C,mem.bit
+	CASE( 4A ) // AND1 C,mem.bit
 		c &= MEM_BIT( 0 );
 		pc += 2;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0x6A: // AND1 C,/mem.bit
+	CASE( 6A ) // AND1 C,/mem.bit
 		c &= ~MEM_BIT( 0 );
 		pc += 2;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0x0A: // OR1 C,mem.bit
+	CASE( 0A ) // OR1 C,mem.bit
 		c |= MEM_BIT( -1 );
 		pc += 2;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0x2A: // OR1 C,/mem.bit
+	CASE( 2A ) // OR1 C,/mem.bit
 		c |= ~MEM_BIT( -1 );
 		pc += 2;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0x8A: // EOR1 C,mem.bit
+	CASE( 8A ) // EOR1 C,mem.bit
 		c ^= MEM_BIT( -1 );
 		pc += 2;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xEA: // NOT1 mem.bit
+	CASE( EA ) // NOT1 mem.bit
 		data = READ_PC16( pc );
 		pc += 2;
 		{
@@ -1085,9 +1126,9 @@ loop:
 			temp ^= 1 << (data >> 13);
 			WRITE( 0, data & 0x1FFF, temp );
 		}
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xCA: // MOV1 mem.bit,C
+	CASE( CA ) // MOV1 mem.bit,C
 		data = READ_PC16( pc );
 		pc += 2;
 		{
@@ -1096,64 +1137,64 @@ loop:
 			temp = (temp & ~(1 << bit)) | ((c >> 8 & 1) << bit);
 			WRITE( 0, data & 0x1FFF, temp + no_read_before_write  );
 		}
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xAA: // MOV1 C,mem.bit
+	CASE( AA ) // MOV1 C,mem.bit
 		c = MEM_BIT( 0 );
 		pc += 2;
-		goto loop;
+		NEXT_INSTR();
 
 // 16. PROGRAM PSW FLAG OPERATION COMMANDS
 
-	case 0x60: // CLRC
+	CASE( 60 ) // CLRC
 		c = 0;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0x80: // SETC
+	CASE( 80 ) // SETC
 		c = ~0;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xED: // NOTC
+	CASE( ED ) // NOTC
 		c ^= 0x100;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xE0: // CLRV
+	CASE( E0 ) // CLRV
 		psw &= ~(v40 | h08);
-		goto loop;
+		NEXT_INSTR();
 
-	case 0x20: // CLRP
+	CASE( 20 ) // CLRP
 		dp = 0;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0x40: // SETP
+	CASE( 40 ) // SETP
 		dp = 0x100;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xA0: // EI
+	CASE( A0 ) // EI
 		SUSPICIOUS_OPCODE( "EI" );
 		psw |= i04;
-		goto loop;
+		NEXT_INSTR();
 
-	case 0xC0: // DI
+	CASE( C0 ) // DI
 		SUSPICIOUS_OPCODE( "DI" );
 		psw &= ~i04;
-		goto loop;
+		NEXT_INSTR();
 
 // 17. OTHER COMMANDS
 
-	case 0x00: // NOP
-		goto loop;
+	CASE( 00 ) // NOP
+		NEXT_INSTR();
 
-	case 0xFF:{// STOP
+	CASE( FF ){// STOP
 		// handle PC wrap-around
 		if ( pc == 0x0000 )
 		{
 			debug_printf( "SPC: PC wrapped around\n" );
-			goto loop;
+			NEXT_INSTR();
 		}
 	}
 	// fall through
-	case 0xEF: // SLEEP
+	CASE( EF ) // SLEEP
 		SUSPICIOUS_OPCODE( "STOP/SLEEP" );
 		--pc;
 		rel_time = 0;
@@ -2,6 +2,7 @@
 
 #include "Spc_Dsp.h"
 
+#include "Emu_State.h"
 #include "blargg_endian.h"
 #include <string.h>
 
@@ -89,6 +90,11 @@ void Spc_Dsp::set_output( sample_t* out, int size )
 // Volume registers and efb are signed! Easy to forget int8_t cast.
 // Prefixes are to avoid accidental use of locals with same names.
 
+// Interpolation and the echo FIR stay scalar. Bit-exact SSE2 versions of both
+// made no measurable difference, since together they take under 3% of run()'s
+// time. Most of it goes to envelopes, BRR decoding and KON handling, and voices
+// can't be run side by side since pitch modulation uses the previous voice's output.
+
 // Interleved gauss table (to improve cache coherency)
 // interleved_gauss [i] = gauss [(i & 1) * 256 + 255 - (i >> 1 & 0xFF)]
 static short const interleved_gauss [512] =
@@ -472,8 +478,9 @@ void Spc_Dsp::run( int clock_count )
 				if ( old_pos >= 0x4000 )
 				{
 					// Arrange the four input nybbles in 0xABCD order for easy decoding
-					int nybbles = ram [(v->brr_addr + v->brr_offset) & 0xFFFF] * 0x100 +
-							ram [(v->brr_addr + v->brr_offset + 1) & 0xFFFF];
+					int const nybbles_addr = (v->brr_addr + v->brr_offset) & 0xFFFF;
+					int nybbles = ram [nybbles_addr] * 0x100 +
+							ram [(nybbles_addr + 1) & 0xFFFF];
 
 					// Advance read position
 					int const brr_block_size = 9;
@@ -509,6 +516,28 @@ void Spc_Dsp::run( int clock_count )
 					int* pos = v->buf_pos;
 					int* end;
 
+					// Use cached samples if decoded from same data and history
+					brr_cache_t* cache = 0;
+					if ( brr_cache_enabled )
+					{
+						int const key = nybbles_addr | brr_header << 16;
+						int const p1 = (brr_header & 0x0C ? pos [brr_buf_size - 1] : 0);
+						int const p2 = (brr_header & 0x0C ? pos [brr_buf_size - 2] : 0);
+						cache = &brr_cache [nybbles_addr & (brr_cache_size - 1)];
+						if ( cache->key == key && cache->nybbles == nybbles &&
+								cache->p1 == p1 && cache->p2 == p2 )
+						{
+							for ( int i = 0; i < 4; i++ )
+								pos [brr_buf_size + i] = pos [i] = cache->out [i];
+							pos += 4;
+							goto brr_decoded;
+						}
+						cache->key     = key;
+						cache->nybbles = nybbles;
+						cache->p1      = p1;
+						cache->p2      = p2;
+					}
+
 					// Decode four samples
 					for ( end = pos + 4; pos < end; pos++, nybbles <<= 4 )
 					{
@@ -547,6 +576,13 @@ void Spc_Dsp::run( int clock_count )
 						pos [brr_buf_size] = pos [0] = s; // second copy simplifies wrap-around
 					}
 
+					if ( cache )
+					{
+						for ( int i = 0; i < 4; i++ )
+							cache->out [i] = (int16_t) pos [i - 4];
+					}
+
+				brr_decoded:
 					if ( pos >= &v->buf [brr_buf_size] )
 						pos = v->buf;
 					v->buf_pos = pos;
@@ -661,6 +697,14 @@ void Spc_Dsp::mute_voices( int mask )
 Spc_Dsp::Spc_Dsp()
 {
 	memset(&m, 0, sizeof(state_t));
+	enable_brr_cache( true );
+}
+
+void Spc_Dsp::enable_brr_cache( bool enable )
+{
+	brr_cache_enabled = enable;
+	for ( int i = 0; i < brr_cache_size; i++ )
+		brr_cache [i].key = -1;
 }
 
 void Spc_Dsp::init( void* ram_64k )
@@ -727,3 +771,19 @@ void Spc_Dsp::load( uint8_t const regs [register_count] )
 }
 
 void Spc_Dsp::reset() { load( initial_regs ); }
+
+void Spc_Dsp::copy_state( Emu_State& s )
+{
+	// Sound settings and RAM pointer aren't part of state
+	uint8_t* const ram           = m.ram;
+	int const mute_mask          = m.mute_mask;
+	int const surround_threshold = m.surround_threshold;
+	int const echo_enable        = m.echo_enable;
+
+	s( m );
+
+	m.ram                = ram;
+	m.surround_threshold = surround_threshold;
+	m.echo_enable        = echo_enable;
+	mute_voices( mute_mask );
+}
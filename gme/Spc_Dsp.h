@@ -5,6 +5,7 @@
 #define SPC_DSP_H
 
 #include "blargg_common.h"
+class Emu_State;
 
 struct Spc_Dsp {
 public:
@@ -38,7 +39,8 @@ public:
 	void write( int addr, int data );
 
 	// Runs DSP for specified number of clocks (~1024000 per second). Every 32 clocks
-	// a pair of samples is be generated.
+	// a pair of samples is be generated. Works a whole sample at a time, running
+	// all voices for each; clocks left over are kept for the next call.
 	void run( int clock_count );
 
 // Sound control
@@ -53,12 +55,19 @@ public:
 
 	void disable_echo( bool disable = true );
 
+	// Enables/disables cache of decoded BRR samples, which avoids decoding looped
+	// samples again. Output is the same either way. Enabled by default.
+	void enable_brr_cache( bool enable = true );
+
 // State
 
 	// Resets DSP and uses supplied values to initialize registers
 	enum { register_count = 128 };
 	void load( uint8_t const regs [register_count] );
 
+	// Saves/loads emulation state in native format, without affecting settings
+	void copy_state( Emu_State& );
+
 // DSP register addresses
 
 	// Global registers
@@ -149,6 +158,20 @@ private:
 	};
 	state_t m;
 
+	// Decoded BRR samples, indexed by address of their encoded data. Entries are
+	// checked against the data and filter history they were decoded from, so
+	// writes to RAM never leave them stale.
+	enum { brr_cache_size = 0x800 };
+	struct brr_cache_t
+	{
+		int key;        // address | header << 16, or -1 if unused
+		int nybbles;
+		int p1, p2;     // previous two samples, if filter uses them
+		int16_t out [4];
+	};
+	bool brr_cache_enabled;
+	brr_cache_t brr_cache [brr_cache_size];
+
 	void init_counter();
 	void run_counter( int );
 	void soft_reset_common();
@@ -25,7 +25,7 @@ using std::max;
 
 // TODO: support Spc_Filter's bass
 
-Spc_Emu::Spc_Emu()
+Spc_Emu::Spc_Emu() : resampler( 24 )
 {
 	set_type( gme_spc_type );
 
@@ -35,6 +35,7 @@ Spc_Emu::Spc_Emu()
 	set_voice_names( names );
 
 	set_gain( 1.4 );
+	unity_input = false;
 }
 
 Spc_Emu::~Spc_Emu() { }
@@ -279,6 +280,13 @@ void Spc_Emu::enable_accuracy_( bool b )
 	filter.enable( b );
 }
 
+void Spc_Emu::set_quality_( int q )
+{
+	Music_Emu::set_quality_( q );
+	static int const widths [3] = { 12, 24, 32 }; // fast, normal, high
+	resampler.set_width( widths [q] );
+}
+
 void Spc_Emu::mute_voices_( int m )
 {
 	Music_Emu::mute_voices_( m );
@@ -314,7 +322,7 @@ blargg_err_t Spc_Emu::start_track_( int track )
 	resampler.clear();
 	filter.clear();
 	RETURN_ERR( apu.load_spc( file_data, file_size ) );
-	filter.set_gain( (int) (gain() * SPC_Filter::gain_unit) );
+	filter.set_gain( filter_gain() );
 	apu.clear_echo();
 	track_info_t spc_info;
 	RETURN_ERR( track_info_( &spc_info, track ) );
@@ -328,10 +336,55 @@ blargg_err_t Spc_Emu::start_track_( int track )
 blargg_err_t Spc_Emu::play_and_filter( long count, sample_t out [] )
 {
 	RETURN_ERR( apu.play( count, out ) );
-	filter.run( out, count );
+	if ( unity_input )
+		filter.run_unity_gain( out, count );
+	else
+		filter.run( out, count );
 	return 0;
 }
 
+// Rescales unread resampler input when switching between play_() and play_float()
+void Spc_Emu::set_unity_input( bool b )
+{
+	if ( unity_input == b )
+		return;
+	unity_input = b;
+
+	int const gain = filter_gain();
+	if ( !gain )
+		return;
+	int const mul = b ? (int) SPC_Filter::gain_unit : gain;
+	int const div = b ? gain : (int) SPC_Filter::gain_unit;
+	for ( sample_t* p = resampler.input_begin(); p < resampler.buffer(); p++ )
+	{
+		int s = *p * mul / div;
+		if ( (short) s != s )
+			s = (s >> 31) ^ 0x7FFF;
+		*p = (sample_t) s;
+	}
+}
+
+void Spc_Emu::copy_state_( Emu_State& s )
+{
+	Music_Emu::copy_state_( s );
+	s( unity_input );
+	apu.copy_state( s );
+	filter.copy_state( s );
+	if ( sample_rate() != native_sample_rate )
+		resampler.copy_state( s );
+}
+
+void Spc_Emu::get_stats_( stats_t* out ) const
+{
+	out->cpu_instructions += apu.instr_count();
+	out->apu_writes       += apu.dsp_write_count();
+	if ( sample_rate() != native_sample_rate )
+	{
+		out->resampler_in  += resampler.input_count();
+		out->resampler_out += resampler.output_count();
+	}
+}
+
 blargg_err_t Spc_Emu::skip_( long count )
 {
 	if ( sample_rate() != native_sample_rate )
@@ -354,18 +407,78 @@ blargg_err_t Spc_Emu::skip_( long count )
 	return play_( resampler_latency, buf );
 }
 
+// Number of samples to generate for resampler when 'remain' more are needed
+long Spc_Emu::input_count( long remain ) const
+{
+	long n = resampler.max_write();
+	if ( low_latency() )
+	{
+		// a few extra, rather than running again for the last one or two
+		long needed = ((long) (remain * resampler.ratio()) + 8) & ~1;
+		if ( n > needed )
+			n = needed;
+	}
+	return n;
+}
+
 blargg_err_t Spc_Emu::play_( long count, sample_t* out )
 {
 	if ( sample_rate() == native_sample_rate )
+	{
+		unity_input = false;
 		return play_and_filter( count, out );
+	}
 
+	set_unity_input( false );
 	long remain = count;
 	while ( remain > 0 )
 	{
 		remain -= resampler.read( &out [count - remain], remain );
 		if ( remain > 0 )
 		{
-			long n = resampler.max_write();
+			long n = input_count( remain );
+			RETURN_ERR( play_and_filter( n, resampler.buffer() ) );
+			resampler.write( n );
+		}
+	}
+	check( remain == 0 );
+	return 0;
+}
+
+blargg_err_t Spc_Emu::play_float_( long count, float* out )
+{
+	// DSP output is 16-bit, so gain is applied here rather than by the filter,
+	// allowing output to exceed full scale rather than being clamped
+	float const gain = filter_gain() * (1.0f / SPC_Filter::gain_unit);
+
+	if ( sample_rate() == native_sample_rate )
+	{
+		unity_input = true;
+		sample_t buf [1024];
+		while ( count > 0 )
+		{
+			long n = min( count, (long) (sizeof buf / sizeof *buf) );
+			RETURN_ERR( play_and_filter( n, buf ) );
+			for ( long i = 0; i < n; i++ )
+				out [i] = buf [i] * (gain / 0x8000);
+			out   += n;
+			count -= n;
+		}
+		return 0;
+	}
+
+	set_unity_input( true );
+	long remain = count;
+	while ( remain > 0 )
+	{
+		float* io = &out [count - remain];
+		long read = resampler.read( io, remain );
+		for ( long i = 0; i < read; i++ )
+			io [i] *= gain;
+		remain -= read;
+		if ( remain > 0 )
+		{
+			long n = input_count( remain );
 			RETURN_ERR( play_and_filter( n, resampler.buffer() ) );
 			resampler.write( n );
 		}
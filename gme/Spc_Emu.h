@@ -63,19 +63,27 @@ protected:
 	blargg_err_t set_sample_rate_( long );
 	blargg_err_t start_track_( int );
 	blargg_err_t play_( long, sample_t* );
+	blargg_err_t play_float_( long, float* );
 	blargg_err_t skip_( long );
 	void mute_voices_( int );
 	void disable_echo_( bool disable );
 	void set_tempo_( double );
 	void enable_accuracy_( bool );
+	void set_quality_( int );
+	void copy_state_( Emu_State& );
+	void get_stats_( stats_t* ) const;
 private:
 	byte const* file_data;
 	long        file_size;
-	Fir_Resampler<24> resampler;
+	Fir_Resampler<32> resampler;
 	SPC_Filter filter;
 	Snes_Spc apu;
+	bool unity_input; // resampler input was filtered without gain, for play_float()
 
 	blargg_err_t play_and_filter( long count, sample_t out [] );
+	long input_count( long remain ) const;
+	int filter_gain() const { return (int) (gain() * SPC_Filter::gain_unit); }
+	void set_unity_input( bool );
 };
 
 inline void Spc_Emu::disable_surround( bool b ) { apu.disable_surround( b ); }
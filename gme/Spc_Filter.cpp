@@ -2,6 +2,7 @@
 
 #include "Spc_Filter.h"
 
+#include "Emu_State.h"
 #include <string.h>
 
 /* Copyright (C) 2007 Shay Green. This module is free software; you
@@ -19,6 +20,8 @@ Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA */
 
 void SPC_Filter::clear() { memset( ch, 0, sizeof ch ); }
 
+void SPC_Filter::copy_state( Emu_State& s ) { s( ch ); }
+
 SPC_Filter::SPC_Filter()
 {
 	enabled = true;
@@ -27,11 +30,10 @@ SPC_Filter::SPC_Filter()
 	clear();
 }
 
-void SPC_Filter::run( short* io, int count )
+void SPC_Filter::run_( short* io, int count, int gain )
 {
 	require( (count & 1) == 0 ); // must be even
 
-	int const gain = this->gain;
 	if ( enabled )
 	{
 		int const bass = this->bass;
@@ -5,6 +5,7 @@
 #define SPC_FILTER_H
 
 #include "blargg_common.h"
+class Emu_State;
 
 struct SPC_Filter {
 public:
@@ -13,6 +14,9 @@ public:
 	typedef short sample_t;
 	void run( sample_t* io, int count );
 
+	// Same as run(), but doesn't apply gain. Used when output is scaled later.
+	void run_unity_gain( sample_t* io, int count );
+
 // Optional features
 
 	// Clears filter to silence
@@ -32,6 +36,9 @@ public:
 	static const unsigned int bass_max  = 31;
 	void set_bass( int bass );
 
+	// Saves/loads filter history in native format, without affecting settings
+	void copy_state( Emu_State& );
+
 public:
 	SPC_Filter();
 	BLARGG_DISABLE_NOTHROW
@@ -42,6 +49,7 @@ private:
 	bool enabled;
 	struct chan_t { int p1, pp1, sum; };
 	chan_t ch [2];
+	void run_( sample_t* io, int count, int gain );
 };
 
 inline void SPC_Filter::enable( bool b )  { enabled = b; }
@@ -50,4 +58,8 @@ inline void SPC_Filter::set_gain( int g ) { gain = g; }
 
 inline void SPC_Filter::set_bass( int b ) { bass = b; }
 
+inline void SPC_Filter::run( sample_t* io, int count ) { run_( io, count, gain ); }
+
+inline void SPC_Filter::run_unity_gain( sample_t* io, int count ) { run_( io, count, gain_unit ); }
+
 #endif
@@ -30,6 +30,7 @@ using std::max;
 Vgm_Emu::Vgm_Emu()
 {
 	disable_oversampling_ = false;
+	uses_fm  = false;
 	psg_dual = false;
 	psg_t6w28 = false;
 	psg_rate   = 0;
@@ -294,6 +295,28 @@ void Vgm_Emu::set_voice( int i, Blip_Buffer* c, Blip_Buffer* l, Blip_Buffer* r )
 
 }
 
+void Vgm_Emu::set_quality_( int q )
+{
+	Classic_Emu::set_quality_( q );
+	blip_buf.set_synth_quality( q );
+	Dual_Resampler::set_resampler_quality( q );
+}
+
+void Vgm_Emu::set_low_latency_( bool b )
+{
+	Classic_Emu::set_low_latency_( b );
+	if ( uses_fm )
+		Dual_Resampler::resize( fm_frame_pairs() );
+}
+
+// FM sound is generated a frame at a time, shortened in low-latency mode
+int Vgm_Emu::fm_frame_pairs() const
+{
+	if ( low_latency() )
+		return (int) max( 1L, blip_buf.sample_rate() / 1000 );
+	return blip_buf.length() * blip_buf.sample_rate() / 1000;
+}
+
 void Vgm_Emu::mute_voices_( int mask )
 {
 	Classic_Emu::mute_voices_( mask );
@@ -426,6 +449,7 @@ blargg_err_t Vgm_Emu::setup_fm()
 	if ( uses_fm )
 	{
 		RETURN_ERR( Dual_Resampler::reset( blip_buf.length() * blip_buf.sample_rate() / 1000 ) );
+		Dual_Resampler::resize( fm_frame_pairs() );
 		psg[0].volume( 0.135 * fm_gain * gain() );
 		if ( psg_dual )
 			psg[1].volume( 0.135 * fm_gain * gain() );
@@ -487,6 +511,55 @@ blargg_err_t Vgm_Emu::start_track_( int track )
 	return 0;
 }
 
+void Vgm_Emu::copy_state_( Emu_State& s )
+{
+	Classic_Emu::copy_state_( s );
+
+	long offset = pos - data;
+	s( offset );
+	long pcm_offset = pcm_data - data;
+	s( pcm_offset );
+	long pcm_pos_offset = pcm_pos - data;
+	s( pcm_pos_offset );
+	if ( (unsigned long) offset > (unsigned long) (data_end - data) ||
+			(unsigned long) pcm_offset > (unsigned long) (data_end - data) ||
+			(unsigned long) pcm_pos_offset > (unsigned long) (data_end - data) )
+	{
+		s.set_corrupt();
+		offset = pcm_offset = pcm_pos_offset = data_end - data;
+	}
+	pos      = data + offset;
+	pcm_data = data + pcm_offset;
+	pcm_pos  = data + pcm_pos_offset;
+
+	s( vgm_time );
+	s( dac_amp );
+	s( dac_disabled );
+	psg[0].copy_state( s );
+	if ( psg_dual )
+		psg[1].copy_state( s );
+
+	if ( uses_fm )
+	{
+		for ( int i = 0; i < 2; i++ )
+		{
+			if ( ym2612[i].enabled() )
+				ym2612[i].copy_state( s );
+			if ( ym2413[i].enabled() )
+				ym2413[i].copy_state( s );
+		}
+		s( fm_time_offset );
+		blip_buf.copy_state( s );
+		Dual_Resampler::copy_state( s );
+	}
+}
+
+void Vgm_Emu::get_stats_( stats_t* out ) const
+{
+	Classic_Emu::get_stats_( out );
+	Dual_Resampler::get_stats( out, blip_buf );
+}
+
 blargg_err_t Vgm_Emu::run_clocks( blip_time_t& time_io, int msec )
 {
 	time_io = run_commands( msec * vgm_rate / 1000 );
@@ -504,3 +577,28 @@ blargg_err_t Vgm_Emu::play_( long count, sample_t* out )
 	Dual_Resampler::dual_play( count, out, blip_buf );
 	return 0;
 }
+
+blargg_err_t Vgm_Emu::skip_( long count )
+{
+	if ( !uses_fm )
+		return Classic_Emu::skip_( count );
+
+	// for long skip, run FM chips muted without resampling or mixing
+	if ( count > skip_threshold )
+	{
+		mute_voices_( ~0 );
+		while ( count > skip_threshold / 2 && !emu_track_ended() )
+			count -= skip_frame( blip_buf );
+		remute_voices();
+	}
+	return Music_Emu::skip_( count );
+}
+
+blargg_err_t Vgm_Emu::play_float_( long count, float* out )
+{
+	if ( !uses_fm )
+		return Classic_Emu::play_float_( count, out );
+
+	Dual_Resampler::dual_play( count, out, blip_buf );
+	return 0;
+}
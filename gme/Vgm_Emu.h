@@ -67,11 +67,17 @@ protected:
 	blargg_err_t set_sample_rate_( long sample_rate ) override;
 	blargg_err_t start_track_( int ) override;
 	blargg_err_t play_( long count, sample_t* ) override;
+	blargg_err_t play_float_( long count, float* ) override;
+	blargg_err_t skip_( long count ) override;
 	blargg_err_t run_clocks( blip_time_t&, int ) override;
 	void set_tempo_( double ) override;
+	void set_quality_( int ) override;
+	void set_low_latency_( bool ) override;
 	void mute_voices_( int mask ) override;
 	void set_voice( int, Blip_Buffer*, Blip_Buffer*, Blip_Buffer* ) override;
 	void update_eq( blip_eq_t const& ) override;
+	void copy_state_( Emu_State& ) override;
+	void get_stats_( stats_t* ) const override;
 private:
 	// removed; use disable_oversampling() and set_tempo() instead
 	Vgm_Emu( bool oversample, double tempo = 1.0 );
@@ -81,6 +87,7 @@ private:
 	bool disable_oversampling_;
 	bool uses_fm;
 	blargg_err_t setup_fm();
+	int fm_frame_pairs() const;
 };
 
 #endif
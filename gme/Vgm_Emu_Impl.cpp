@@ -148,18 +148,22 @@ blip_time_t Vgm_Emu_Impl::run_commands( vgm_time_t end_time )
 			break;
 
 		case cmd_gg_stereo:
+			GME_STAT( stats.apu_writes++ );
 			psg[0].write_ggstereo( to_blip_time( vgm_time ), *pos++ );
 			break;
 
 		case cmd_psg:
+			GME_STAT( stats.apu_writes++ );
 			psg[0].write_data( to_blip_time( vgm_time ), *pos++ );
 			break;
 
 		case cmd_gg_stereo_2:
+			GME_STAT( stats.apu_writes++ );
 			psg[1].write_ggstereo( to_blip_time( vgm_time ), *pos++ );
 			break;
 
 		case cmd_psg_2:
+			GME_STAT( stats.apu_writes++ );
 			psg[1].write_data( to_blip_time( vgm_time ), *pos++ );
 			break;
 
@@ -173,18 +177,21 @@ blip_time_t Vgm_Emu_Impl::run_commands( vgm_time_t end_time )
 			break;
 
 		case cmd_ym2413:
+			GME_STAT( stats.apu_writes++ );
 			if ( ym2413[0].run_until( to_fm_time( vgm_time ) ) )
 				ym2413[0].write( pos [0], pos [1] );
 			pos += 2;
 			break;
 
 		case cmd_ym2413_2:
+			GME_STAT( stats.apu_writes++ );
 			if ( ym2413[1].run_until( to_fm_time( vgm_time ) ) )
 				ym2413[1].write( pos [0], pos [1] );
 			pos += 2;
 			break;
 
 		case cmd_ym2612_port0:
+			GME_STAT( stats.apu_writes++ );
 			if ( pos [0] == ym2612_dac_port )
 			{
 				write_pcm( vgm_time, pos [1] );
@@ -202,12 +209,14 @@ blip_time_t Vgm_Emu_Impl::run_commands( vgm_time_t end_time )
 			break;
 
 		case cmd_ym2612_port1:
+			GME_STAT( stats.apu_writes++ );
 			if ( ym2612[0].run_until( to_fm_time( vgm_time ) ) )
 				ym2612[0].write1( pos [0], pos [1] );
 			pos += 2;
 			break;
 
 		case cmd_ym2612_2_port0:
+			GME_STAT( stats.apu_writes++ );
 			if ( pos [0] == ym2612_dac_port )
 			{
 				write_pcm( vgm_time, pos [1] );
@@ -225,6 +234,7 @@ blip_time_t Vgm_Emu_Impl::run_commands( vgm_time_t end_time )
 			break;
 
 		case cmd_ym2612_2_port1:
+			GME_STAT( stats.apu_writes++ );
 			if ( ym2612[1].run_until( to_fm_time( vgm_time ) ) )
 				ym2612[1].write1( pos [0], pos [1] );
 			pos += 2;
@@ -252,6 +262,7 @@ blip_time_t Vgm_Emu_Impl::run_commands( vgm_time_t end_time )
 			switch ( cmd & 0xF0 )
 			{
 				case cmd_pcm_delay:
+					GME_STAT( stats.apu_writes++ );
 					write_pcm( vgm_time, *pcm_pos++ );
 					vgm_time += cmd & 0x0F;
 					break;
@@ -19,3 +19,5 @@ void Ym2413_Emu::mute_voices( int ) { }
 
 void Ym2413_Emu::run( int, sample_t* ) { }
 
+void Ym2413_Emu::copy_state( Emu_State& ) { }
+
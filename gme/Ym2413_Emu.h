@@ -4,6 +4,8 @@
 #ifndef YM2413_EMU_H
 #define YM2413_EMU_H
 
+class Emu_State;
+
 class Ym2413_Emu  {
 	struct OPLL* opll;
 public:
@@ -28,6 +30,9 @@ public:
 	typedef short sample_t;
 	enum { out_chan_count = 2 }; // stereo
 	void run( int pair_count, sample_t* out );
+
+	// Save/load emulation state in native format. Muting isn't affected.
+	void copy_state( Emu_State& );
 };
 
 #endif
@@ -6,6 +6,7 @@
 
 #include "Ym2612_GENS.h"
 
+#include "Emu_State.h"
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
@@ -830,7 +831,7 @@ const char* Ym2612_GENS_Emu::set_rate( double sample_rate, double clock_rate )
 {
 	if ( !impl )
 	{
-		impl = (Ym2612_GENS_Impl*) malloc( sizeof *impl );
+		impl = (Ym2612_GENS_Impl*) blargg_realloc( 0, sizeof *impl );
 		if ( !impl )
 			return "Out of memory";
 		impl->mute_mask = 0;
@@ -844,7 +845,7 @@ const char* Ym2612_GENS_Emu::set_rate( double sample_rate, double clock_rate )
 
 Ym2612_GENS_Emu::~Ym2612_GENS_Emu()
 {
-	free( impl );
+	blargg_free( impl );
 }
 
 inline void Ym2612_GENS_Impl::write0( int opn_addr, int data )
@@ -1320,4 +1321,7 @@ void Ym2612_GENS_Impl::run( int pair_count, Ym2612_GENS_Emu::sample_t* out )
 
 void Ym2612_GENS_Emu::run( int pair_count, sample_t* out ) { impl->run( pair_count, out ); }
 
+// state refers to tables in same impl, so it can only be loaded into same object
+void Ym2612_GENS_Emu::copy_state( Emu_State& s ) { s( impl->YM2612 ); }
+
 #endif /* VGM_YM2612_GENS */
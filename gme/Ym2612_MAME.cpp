@@ -6,6 +6,8 @@
 
 #include "Ym2612_MAME.h"
 
+#include "Emu_State.h"
+
 /*
 **
 ** File: fm2612.c -- software implementation of Yamaha YM2612 FM sound generator
@@ -143,6 +145,7 @@
 #include <stddef.h>	/* for NULL */
 #include <math.h>
 #include <stdint.h>
+#include <mutex>
 
 namespace Ym2612_MameImpl
 {
@@ -2379,7 +2382,7 @@ static void reset_channels( FM_ST *ST , FM_CH *CH , int num )
 }
 
 /* initialize generic tables */
-static void init_tables(void)
+static void build_tables(void)
 {
 	signed int i,x;
 	signed int n;
@@ -2482,6 +2485,14 @@ static void init_tables(void)
 #endif
 }
 
+/* tables are shared by all chips and never change, so only build them once,
+   even when chips are created on several threads at the same time */
+static void init_tables(void)
+{
+	static std::once_flag tables_built;
+	std::call_once(tables_built, build_tables);
+}
+
 #endif /* BUILD_OPN */
 
 
@@ -2807,7 +2818,7 @@ static void * ym2612_init(void *param, int clock, int rate,
 
 	/* allocate extend state space */
 	/* F2612 = auto_alloc_clear(device->machine, YM2612); */
-	F2612 = (YM2612 *)malloc(sizeof(YM2612));
+	F2612 = (YM2612 *)blargg_realloc(NULL, sizeof(YM2612));
 	if (F2612 == NULL)
 		return NULL;
 	memset(F2612, 0x00, sizeof(YM2612));
@@ -2857,7 +2868,7 @@ static void ym2612_shutdown(void *chip)
 
 	FMCloseTable();
 	/* auto_free(F2612->OPN.ST.device->machine, F2612); */
-	free(F2612);
+	blargg_free(F2612);
 }
 
 /* reset one of chip */
@@ -3110,4 +3121,15 @@ void Ym2612_MAME_Emu::run(int pair_count, Ym2612_MAME_Emu::sample_t *out)
 	if ( impl ) Ym2612_MameImpl::ym2612_generate( impl, out, pair_count, 1);
 }
 
+void Ym2612_MAME_Emu::copy_state( Emu_State& s )
+{
+	if ( !impl ) return;
+	Ym2612_MameImpl::YM2612 *chip = static_cast<Ym2612_MameImpl::YM2612 *>(impl);
+	int mask = chip->MuteDAC << 6;
+	for ( int i = 0; i < 6; i++ )
+		mask |= chip->CH[i].Muted << i;
+	s( *chip ); // same chip, so pointers within it remain valid
+	Ym2612_MameImpl::ym2612_set_mutemask( impl, mask );
+}
+
 #endif /* VGM_YM2612_MAME */
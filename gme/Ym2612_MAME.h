@@ -5,6 +5,7 @@
 #define YM2612_EMU_H
 
 typedef void Ym2612_MAME_Impl;
+class Emu_State;
 
 class Ym2612_MAME_Emu  {
 	Ym2612_MAME_Impl* impl;
@@ -33,6 +34,9 @@ public:
 	typedef short sample_t;
 	enum { out_chan_count = 2 }; // stereo
 	void run( int pair_count, sample_t* out );
+
+	// Save/load emulation state in native format. Muting isn't affected.
+	void copy_state( Emu_State& );
 };
 
 #endif
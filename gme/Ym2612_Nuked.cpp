@@ -6,6 +6,8 @@
 
 #include "Ym2612_Nuked.h"
 
+#include "Emu_State.h"
+
 /*
  * Copyright (C) 2017 Alexey Khokholov (Nuke.YKT)
  *
@@ -436,7 +438,9 @@ static const Bit32u fm_algorithm[4][6][8] = {
     }
 };
 
-static Bit32u chip_type = ym3438_type_discrete;
+/* shared by all chips; starts as the type Ym2612_Nuked_Emu uses, so that it
+   never has to be written while other chips are running on other threads */
+static Bit32u chip_type = ym3438_type_asic;
 
 void OPN2_DoIO(ym3438_t *chip)
 {
@@ -1817,14 +1821,14 @@ void OPN2_SetMute(ym3438_t *chip, Bit32u mute)
 
 Ym2612_Nuked_Emu::Ym2612_Nuked_Emu()
 {
-	Ym2612_NukedImpl::OPN2_SetChipType( Ym2612_NukedImpl::ym3438_type_asic );
-	impl = new Ym2612_NukedImpl::ym3438_t;
+	// chip type is shared by all instances, and already ym3438_type_asic
+	impl = blargg_realloc( 0, sizeof (Ym2612_NukedImpl::ym3438_t) );
 }
 
 Ym2612_Nuked_Emu::~Ym2612_Nuked_Emu()
 {
 	Ym2612_NukedImpl::ym3438_t *chip_r = reinterpret_cast<Ym2612_NukedImpl::ym3438_t*>(impl);
-	if ( chip_r ) delete chip_r;
+	blargg_free( chip_r );
 }
 
 const char *Ym2612_Nuked_Emu::set_rate(double sample_rate, double clock_rate)
@@ -1873,4 +1877,14 @@ void Ym2612_Nuked_Emu::run(int pair_count, Ym2612_Nuked_Emu::sample_t *out)
 	Ym2612_NukedImpl::OPN2_GenerateStreamMix(chip_r, out, pair_count);
 }
 
+void Ym2612_Nuked_Emu::copy_state( Emu_State& s )
+{
+	Ym2612_NukedImpl::ym3438_t *chip_r = reinterpret_cast<Ym2612_NukedImpl::ym3438_t*>(impl);
+	if ( !chip_r ) return;
+	Bit32u mute [7];
+	memcpy( mute, chip_r->mute, sizeof mute );
+	s( *chip_r );
+	memcpy( chip_r->mute, mute, sizeof mute );
+}
+
 #endif /* VGM_YM2612_NUKED */
@@ -0,0 +1,198 @@
+// Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
+
+#include "blargg_common.h"
+
+#include <string.h>
+
+/* This module is free software; you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 2.1 of the License, or (at your
+option) any later version. This module is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General
+Public License for more details. You should have received a copy of the GNU
+Lesser General Public License along with this module; if not, write to the Free
+Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+02110-1301 USA */
+
+#include "blargg_source.h"
+
+// Every block starts with a header recording where it came from and its size,
+// so that blocks from the allocator and from arenas can be freed the same way.
+struct block_t
+{
+	blargg_arena_t* arena; // NULL if from allocator
+	size_t size;
+};
+
+struct blargg_arena_t
+{
+	size_t size;  // bytes available for blocks
+	size_t used;
+	size_t last;  // offset of most recent block, which can be resized in place
+	long live;    // blocks not yet freed, plus one until arena is released
+};
+
+static size_t const align_mask = alignof (max_align_t) - 1;
+
+static size_t align( size_t n ) { return (n + align_mask) & ~align_mask; }
+
+static size_t const header_size = (sizeof (block_t) + align_mask) & ~align_mask;
+static size_t const arena_header_size = (sizeof (blargg_arena_t) + align_mask) & ~align_mask;
+
+static void* default_alloc( void*, void* p, size_t size )
+{
+	if ( !size )
+	{
+		free( p );
+		return 0;
+	}
+	return realloc( p, size );
+}
+
+static blargg_alloc_func_t alloc_func = default_alloc;
+static void* alloc_data;
+
+static thread_local blargg_arena_t* current_arena;
+
+void blargg_set_allocator( blargg_alloc_func_t func, void* user_data )
+{
+	alloc_func = (func ? func : default_alloc);
+	alloc_data = (func ? user_data : 0);
+}
+
+// Arenas
+
+static char* arena_begin( blargg_arena_t* a ) { return (char*) a + arena_header_size; }
+
+blargg_arena_t* blargg_new_arena( size_t size )
+{
+	size &= ~align_mask;
+	blargg_arena_t* a = (blargg_arena_t*) alloc_func( alloc_data, 0, arena_header_size + size );
+	if ( a )
+	{
+		a->size = size;
+		a->used = 0;
+		a->last = 0;
+		a->live = 1;
+	}
+	return a;
+}
+
+static void unref_arena( blargg_arena_t* a )
+{
+	if ( --a->live <= 0 )
+		alloc_func( alloc_data, a, 0 );
+}
+
+void blargg_release_arena( blargg_arena_t* a )
+{
+	if ( a )
+		unref_arena( a );
+}
+
+static block_t* arena_alloc( blargg_arena_t* a, size_t size )
+{
+	size_t avail = a->size - a->used;
+	if ( avail < header_size || size > avail - header_size )
+		return 0; // doesn't fit; caller uses allocator instead
+
+	block_t* b = (block_t*) (arena_begin( a ) + a->used);
+	b->arena = a;
+	b->size  = size;
+	a->last  = a->used;
+	a->used += header_size + align( size );
+	a->live++;
+	return b;
+}
+
+static void arena_free( block_t* b )
+{
+	blargg_arena_t* a = b->arena;
+	if ( (char*) b == arena_begin( a ) + a->last && a->last < a->used )
+		a->used = a->last; // reuse space of most recent block
+	a->last = a->used;
+	unref_arena( a );
+}
+
+blargg_arena_scope::blargg_arena_scope( blargg_arena_t* a )
+{
+	prev = current_arena;
+	current_arena = a;
+}
+
+blargg_arena_scope::~blargg_arena_scope()
+{
+	current_arena = prev;
+}
+
+// Allocation
+
+static void* block_data( block_t* b ) { return (char*) b + header_size; }
+
+void* blargg_realloc( void* p, size_t size )
+{
+	if ( !size )
+	{
+		blargg_free( p );
+		return 0;
+	}
+
+	if ( size > ((size_t) -1 >> 1) )
+		return 0;
+
+	block_t* old = (p ? (block_t*) ((char*) p - header_size) : 0);
+	blargg_arena_t* a = current_arena;
+	if ( old && old->arena )
+	{
+		a = old->arena;
+
+		// most recent block can grow or shrink in place
+		if ( (char*) old == arena_begin( a ) + a->last &&
+				size <= a->size - a->last - header_size )
+		{
+			old->size = size;
+			a->used = a->last + header_size + align( size );
+			return p;
+		}
+	}
+	else if ( !a )
+	{
+		block_t* b = (block_t*) alloc_func( alloc_data, old, header_size + size );
+		if ( !b )
+			return 0;
+		b->arena = 0;
+		b->size  = size;
+		return block_data( b );
+	}
+
+	// arena involved; allocate new block and move data to it
+	block_t* b = arena_alloc( a, size );
+	if ( !b )
+	{
+		b = (block_t*) alloc_func( alloc_data, 0, header_size + size );
+		if ( !b )
+			return 0;
+		b->arena = 0;
+		b->size  = size;
+	}
+
+	if ( old )
+	{
+		memcpy( block_data( b ), p, (old->size < size ? old->size : size) );
+		blargg_free( p );
+	}
+	return block_data( b );
+}
+
+void blargg_free( void* p )
+{
+	if ( p )
+	{
+		block_t* b = (block_t*) ((char*) p - header_size);
+		if ( b->arena )
+			arena_free( b );
+		else
+			alloc_func( alloc_data, b, 0 );
+	}
+}
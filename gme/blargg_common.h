@@ -37,11 +37,44 @@
 	#define blaarg_static_assert(cond, msg) assert(cond)
 #endif
 
+// GME_STAT(expr): Evaluates expr only if statistics are enabled with GME_STATS
+#if GME_STATS
+	#define GME_STAT( expr ) ((void) (expr))
+#else
+	#define GME_STAT( expr ) ((void) 0)
+#endif
+
 // blargg_err_t (0 on success, otherwise error string)
 #ifndef blargg_err_t
 	typedef const char* blargg_err_t;
 #endif
 
+// Allocates, resizes, or frees (if size is 0) memory like realloc(). Memory comes
+// from the allocator set with blargg_set_allocator(), or from the current arena.
+void* blargg_realloc( void* p, size_t size );
+void blargg_free( void* p );
+
+// Sets function used for memory, which behaves like blargg_realloc(). NULL restores
+// default of malloc/realloc/free. Must not be changed while memory is allocated.
+typedef void* (*blargg_alloc_func_t)( void* user_data, void* p, size_t size );
+void blargg_set_allocator( blargg_alloc_func_t, void* user_data );
+
+// Block that blargg_realloc() takes memory from in order while the arena is current,
+// falling back to the allocator once it's full. Freed memory is only reused if it was
+// the most recent allocation. The block itself is freed once the arena has been
+// released and everything allocated from it has been freed.
+struct blargg_arena_t;
+blargg_arena_t* blargg_new_arena( size_t size ); // NULL if out of memory
+void blargg_release_arena( blargg_arena_t* );
+
+// Makes arena current on this thread for lifetime of scope. NULL uses allocator.
+class blargg_arena_scope {
+	blargg_arena_t* prev;
+public:
+	blargg_arena_scope( blargg_arena_t* );
+	~blargg_arena_scope();
+};
+
 // Apply minus sign to unsigned type and prevent the warning being shown
 template<typename T>
 inline T uMinus(T in)
@@ -56,20 +89,20 @@ class blargg_vector {
 	size_t size_;
 public:
 	blargg_vector() : begin_( 0 ), size_( 0 ) { }
-	~blargg_vector() { free( begin_ ); }
+	~blargg_vector() { blargg_free( begin_ ); }
 	size_t size() const { return size_; }
 	T* begin() const { return begin_; }
 	T* end() const { return begin_ + size_; }
 	blargg_err_t resize( size_t n )
 	{
-		void* p = realloc( begin_, n * sizeof (T) );
+		void* p = blargg_realloc( begin_, n * sizeof (T) );
 		if ( !p && n )
 			return "Out of memory";
 		begin_ = (T*) p;
 		size_ = n;
 		return 0;
 	}
-	void clear() { free( begin_ ); begin_ = nullptr; size_ = 0; }
+	void clear() { blargg_free( begin_ ); begin_ = nullptr; size_ = 0; }
 	T& operator [] ( size_t n ) const
 	{
 		assert( n <= size_ ); // <= to allow past-the-end value
@@ -81,10 +114,10 @@ public:
 #include <new>
 #ifndef BLARGG_DISABLE_NOTHROW
 	#define BLARGG_DISABLE_NOTHROW \
-		void* operator new ( size_t s ) noexcept { return malloc( s ); }\
-		void* operator new ( size_t s, const std::nothrow_t& ) noexcept { return malloc( s ); }\
-		void operator delete ( void* p ) noexcept { free( p ); }\
-		void operator delete ( void* p, const std::nothrow_t&) noexcept { free( p ); }
+		void* operator new ( size_t s ) noexcept { return blargg_realloc( 0, s ); }\
+		void* operator new ( size_t s, const std::nothrow_t& ) noexcept { return blargg_realloc( 0, s ); }\
+		void operator delete ( void* p ) noexcept { blargg_free( p ); }\
+		void operator delete ( void* p, const std::nothrow_t&) noexcept { blargg_free( p ); }
 #endif
 
 // Use to force disable exceptions for a specific allocation no matter what class
@@ -26,9 +26,15 @@
 // Uncomment to enable platform-specific optimizations
 //#define BLARGG_NONPORTABLE 1
 
+// Uncomment to use only portable code rather than SSE2, AVX2 or NEON
+//#define BLARGG_NO_SIMD 1
+
 // Uncomment to use faster, lower quality sound synthesis
 //#define BLIP_BUFFER_FAST 1
 
+// Uncomment to count work done by emulators, as reported by gme_get_stats()
+//#define GME_STATS 1
+
 // Uncomment one of the following two if automatic byte-order determination doesn't work
 //#define BLARGG_BIG_ENDIAN 1
 //#define BLARGG_LITTLE_ENDIAN 1
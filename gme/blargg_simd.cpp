@@ -0,0 +1,71 @@
+// Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
+
+#include "blargg_simd.h"
+
+#if BLARGG_SIMD_AVX2 && defined (_MSC_VER) && !defined (__clang__)
+	#include <intrin.h>
+#endif
+
+/* This module is free software; you can redistribute it and/or modify it
+under the terms of the GNU Lesser General Public License as published by the
+Free Software Foundation; either version 2.1 of the License, or (at your
+option) any later version. This module is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General
+Public License for more details. You should have received a copy of the GNU
+Lesser General Public License along with this module; if not, write to the Free
+Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+02110-1301 USA */
+
+#include "blargg_source.h"
+
+static int detect_features()
+{
+	int features = 0;
+
+	#if BLARGG_SIMD_SSE2
+		features |= blargg_cpu_sse2;
+	#endif
+
+	#if BLARGG_SIMD_AVX2
+		#if defined (_MSC_VER) && !defined (__clang__)
+			// AVX2 also needs the OS to save YMM registers, indicated by OSXSAVE and XCR0
+			int regs [4];
+			__cpuid( regs, 0 );
+			if ( regs [0] >= 7 )
+			{
+				__cpuid( regs, 1 );
+				int const osxsave_avx = 0x18000000;
+				if ( (regs [2] & osxsave_avx) == osxsave_avx && (_xgetbv( 0 ) & 6) == 6 )
+				{
+					__cpuidex( regs, 7, 0 );
+					if ( regs [1] & 0x20 )
+						features |= blargg_cpu_avx2;
+				}
+			}
+		#else
+			__builtin_cpu_init();
+			if ( __builtin_cpu_supports( "avx2" ) )
+				features |= blargg_cpu_avx2;
+		#endif
+	#endif
+
+	#if BLARGG_SIMD_NEON
+		features |= blargg_cpu_neon;
+	#endif
+
+	return features;
+}
+
+static int features_mask = ~0;
+
+int blargg_cpu_features()
+{
+	static int const features = detect_features();
+	return features & features_mask;
+}
+
+void blargg_set_cpu_features( int mask )
+{
+	features_mask = mask;
+}
@@ -0,0 +1,55 @@
+// Optional SIMD code paths and run-time CPU feature detection
+
+#ifndef BLARGG_SIMD_H
+#define BLARGG_SIMD_H
+
+#include "blargg_common.h"
+
+// BLARGG_SIMD_SSE2/BLARGG_SIMD_NEON: defined to 1 where the compiler can always
+// use that instruction set (x86-64, ARM64 and others configured for it)
+#if !BLARGG_NO_SIMD
+	#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define BLARGG_SIMD_SSE2 1
+	#elif defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+		#define BLARGG_SIMD_NEON 1
+	#endif
+#endif
+
+// BLARGG_SIMD_AVX2: defined to 1 if functions marked BLARGG_TARGET_AVX2 can use AVX2.
+// They must only be called when blargg_cpu_features() includes blargg_cpu_avx2.
+#if BLARGG_SIMD_SSE2 && (defined (__GNUC__) || defined (_MSC_VER))
+	#define BLARGG_SIMD_AVX2 1
+	#if defined (__GNUC__)
+		#define BLARGG_TARGET_AVX2 __attribute__((target("avx2")))
+	#else
+		#define BLARGG_TARGET_AVX2
+	#endif
+#endif
+
+#if BLARGG_SIMD_SSE2
+	#include <emmintrin.h>
+#endif
+
+#if BLARGG_SIMD_AVX2
+	#include <immintrin.h>
+#endif
+
+#if BLARGG_SIMD_NEON
+	#include <arm_neon.h>
+#endif
+
+enum {
+	blargg_cpu_sse2 = 0x01,
+	blargg_cpu_avx2 = 0x02,
+	blargg_cpu_neon = 0x04
+};
+
+// Instruction sets that SIMD code paths can use, as blargg_cpu_* flags
+int blargg_cpu_features();
+
+// Limits instruction sets used to those in mask, so that portable code can be
+// tested and compared against. Must not be changed while other threads are
+// generating sound.
+void blargg_set_cpu_features( int mask );
+
+#endif
@@ -27,6 +27,7 @@ void Gbs_Emu::cpu_write( gb_addr_t addr, int data )
 		{
 			if ( unsigned (addr - Gb_Apu::start_addr) < Gb_Apu::register_count )
 			{
+				GME_STAT( stats.apu_writes++ );
 				GME_APU_HOOK( this, addr - Gb_Apu::start_addr, data );
 				apu.write_register( clock(), addr, data );
 			}
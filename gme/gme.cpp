@@ -1,6 +1,7 @@
 // Game_Music_Emu https://bitbucket.org/mpyne/game-music-emu/
 
 #include "Music_Emu.h"
+#include "Batch_Renderer.h"
 
 #ifdef GEN_TYPES_H
 #include "gen_types.h" /* same as gme_types.h but generated by build system */
@@ -140,7 +141,8 @@ gme_err_t gme_identify_file( const char* path, gme_type_t* type_out )
 	return 0;
 }
 
-gme_err_t gme_open_data( void const* data, long size, Music_Emu** out, int sample_rate )
+static gme_err_t open_data( void const* data, long size, Music_Emu** out,
+		int sample_rate, bool borrow )
 {
 	require( (data || !size) && out );
 	*out = 0;
@@ -154,7 +156,7 @@ gme_err_t gme_open_data( void const* data, long size, Music_Emu** out, int sampl
 	Music_Emu* emu = gme_new_emu( file_type, sample_rate );
 	CHECK_ALLOC( emu );
 
-	gme_err_t err = gme_load_data( emu, data, size );
+	gme_err_t err = (borrow ? gme_load_data_borrowed : gme_load_data)( emu, data, size );
 
 	if ( err )
 		delete emu;
@@ -164,6 +166,16 @@ gme_err_t gme_open_data( void const* data, long size, Music_Emu** out, int sampl
 	return err;
 }
 
+gme_err_t gme_open_data( void const* data, long size, Music_Emu** out, int sample_rate )
+{
+	return open_data( data, size, out, sample_rate, false );
+}
+
+gme_err_t gme_open_data_borrowed( void const* data, long size, Music_Emu** out, int sample_rate )
+{
+	return open_data( data, size, out, sample_rate, true );
+}
+
 gme_err_t gme_open_file( const char* path, Music_Emu** out, int sample_rate )
 {
 	require( path && out );
@@ -201,6 +213,29 @@ gme_err_t gme_open_file( const char* path, Music_Emu** out, int sample_rate )
 	return err;
 }
 
+gme_err_t gme_open_file_mapped( const char* path, Music_Emu** out, int sample_rate )
+{
+	require( path && out );
+	*out = 0;
+
+	gme_type_t file_type;
+	RETURN_ERR( gme_identify_file( path, &file_type ) );
+	if ( !file_type )
+		return gme_wrong_file_type;
+
+	Music_Emu* emu = gme_new_emu( file_type, sample_rate );
+	CHECK_ALLOC( emu );
+
+	gme_err_t err = emu->load_file_mapped( path );
+
+	if ( err )
+		delete emu;
+	else
+		*out = emu;
+
+	return err;
+}
+
 void gme_set_autoload_playback_limit( Music_Emu *emu, int do_autoload_limit )
 {
 	emu->set_autoload_playback_limit( do_autoload_limit != 0 );
@@ -265,14 +300,47 @@ Music_Emu* gme_new_emu_multi_channel( gme_type_t type, int rate )
     return gme_internal_new_emu_( type, rate, true /* multichannel */);
 }
 
+Music_Emu* gme_new_emu_arena( gme_type_t type, int rate, long arena_size )
+{
+	require( arena_size >= 0 );
+	blargg_arena_t* arena = blargg_new_arena( arena_size );
+	if ( !arena )
+		return 0;
+
+	Music_Emu* me;
+	{
+		blargg_arena_scope scope( arena );
+		me = gme_internal_new_emu_( type, rate, false );
+	}
+
+	// arena is freed along with last thing allocated from it
+	blargg_release_arena( arena );
+	return me;
+}
+
+void gme_set_allocator( gme_alloc_func_t func, void* user_data )
+{
+	blargg_set_allocator( func, user_data );
+}
+
 gme_err_t gme_load_file( Music_Emu* me, const char* path ) { return me->load_file( path ); }
 
+gme_err_t gme_load_file_mapped( Music_Emu* me, const char* path ) { return me->load_file_mapped( path ); }
+
 gme_err_t gme_load_data( Music_Emu* me, void const* data, long size )
 {
 	Mem_File_Reader in( data, size );
 	return me->load( in );
 }
 
+gme_err_t gme_load_data_borrowed( Music_Emu* me, void const* data, long size )
+{
+	// compressed data has to be decompressed into a copy anyway
+	if ( size >= 2 && !memcmp( data, "\x1F\x8B", 2 ) )
+		return gme_load_data( me, data, size );
+	return me->load_mem( data, size );
+}
+
 gme_err_t gme_load_tracks( Music_Emu* me, void const* data, long* sizes, int count )
 {
 	return me->load_tracks( data, sizes, count );
@@ -390,6 +458,7 @@ void      gme_set_user_cleanup(Music_Emu* me, gme_user_cleanup_t func ) { me->se
 
 gme_err_t gme_start_track    ( Music_Emu* me, int index )           { return me->start_track( index ); }
 gme_err_t gme_play           ( Music_Emu* me, int n, short* p )     { return me->play( n, p ); }
+gme_err_t gme_play_float     ( Music_Emu* me, int n, float* p )     { return me->play_float( n, p ); }
 void      gme_set_fade       ( Music_Emu* me, int start_msec )      { me->set_fade( start_msec ); }
 void      gme_set_fade_msecs ( Music_Emu* me, int start_msec, int fade_msec ) { me->set_fade( start_msec, fade_msec ); }
 int       gme_track_ended    ( Music_Emu const* me )                { return me->track_ended(); }
@@ -399,13 +468,21 @@ int       gme_tell_scaled    ( Music_Emu const* me )                { return me-
 gme_err_t gme_seek           ( Music_Emu* me, int msec )            { return me->seek( msec ); }
 gme_err_t gme_seek_samples   ( Music_Emu* me, int n )               { return me->seek_samples( n ); }
 gme_err_t gme_seek_scaled    ( Music_Emu* me, int msec )            { return me->seek_scaled( msec ); }
+int       gme_state_size     ( Music_Emu* me )                      { return me->state_size(); }
+gme_err_t gme_save_state     ( Music_Emu* me, void* p, int size )   { return me->save_state( p, size ); }
+gme_err_t gme_load_state     ( Music_Emu* me, void const* p, int size ) { return me->load_state( p, size ); }
+gme_err_t gme_set_seek_checkpoints( Music_Emu* me, int msec, int count ) { return me->set_seek_checkpoints( msec, count ); }
+void      gme_set_seek_checkpoint_memory( Music_Emu* me, long max_bytes ) { me->set_seek_checkpoint_memory( max_bytes ); }
 int       gme_voice_count    ( Music_Emu const* me )                { return me->voice_count(); }
+void      gme_get_stats      ( Music_Emu const* me, gme_stats_t* out ) { me->get_stats( out ); }
 void      gme_ignore_silence ( Music_Emu* me, int disable )         { me->ignore_silence( disable != 0 ); }
 void      gme_set_tempo      ( Music_Emu* me, double t )            { me->set_tempo( t ); }
 void      gme_mute_voice     ( Music_Emu* me, int index, int mute ) { me->mute_voice( index, mute != 0 ); }
 void      gme_mute_voices    ( Music_Emu* me, int mask )            { me->mute_voices( mask ); }
 void      gme_disable_echo   ( Music_Emu* me, int disable )         { me->disable_echo( disable ); }
 void      gme_enable_accuracy( Music_Emu* me, int enabled )         { me->enable_accuracy( enabled ); }
+void      gme_set_quality    ( Music_Emu* me, int quality )         { me->set_quality( quality ); }
+void      gme_set_low_latency( Music_Emu* me, int enabled )         { me->set_low_latency( enabled != 0 ); }
 void      gme_clear_playlist ( Music_Emu* me )                      { me->clear_playlist(); }
 int       gme_type_multitrack( gme_type_t t )                       { return t->track_count != 1; }
 int       gme_multi_channel  ( Music_Emu const* me )                { return me->multi_channel(); }
@@ -437,3 +514,12 @@ const char* gme_type_system( gme_type_t type )
 	assert( type );
 	return type->system;
 }
+
+gme_err_t gme_render_batch( gme_batch_job_t jobs [], int count, int sample_rate, int thread_count )
+{
+	require( jobs || !count );
+	Batch_Renderer batch;
+	batch.set_sample_rate( sample_rate );
+	batch.set_thread_count( thread_count );
+	return batch.render( jobs, count );
+}
@@ -10,6 +10,8 @@
 
 #define GME_VERSION 0x000606 /* 1 byte major, 1 byte minor, 1 byte patch-level */
 
+#include <stddef.h>
+
 /* Error string returned by library functions, or NULL if no error (success) */
 typedef const char* gme_err_t;
 
@@ -47,6 +49,12 @@ BLARGG_EXPORT gme_err_t gme_start_track( Music_Emu*, int index );
 /* Generate 'count' 16-bit signed samples info 'out'. Output is in stereo. */
 BLARGG_EXPORT gme_err_t gme_play( Music_Emu*, int count, short out [] );
 
+/** Same as gme_play(), but generates 32-bit floating-point samples, where 1.0 is
+ * full scale for a 16-bit sample. Output isn't clamped, so it can exceed 1.0.
+ * @since 0.6.6
+ */
+BLARGG_EXPORT gme_err_t gme_play_float( Music_Emu*, int count, float out [] );
+
 /* Finish using emulator and free memory */
 BLARGG_EXPORT void gme_delete( Music_Emu* );
 
@@ -105,6 +113,48 @@ BLARGG_EXPORT gme_err_t gme_seek_samples( Music_Emu*, int n );
  * @since 0.6.5 */
 BLARGG_EXPORT gme_err_t gme_seek_scaled( Music_Emu*, int msec );
 
+/**
+ * Number of bytes needed to save state of current track with gme_save_state().
+ * @since 0.6.6
+ */
+BLARGG_EXPORT int gme_state_size( Music_Emu* );
+
+/**
+ * Save complete state of current track into out, which can hold size bytes.
+ * State can only be loaded back into the same emulator while the same file is
+ * loaded, and doesn't include settings like tempo, muting, fade or equalizer.
+ * State holds pointers into the emulator, so it can't be kept across processes
+ * (written to disk and loaded by a later run, for example); such state is rejected.
+ * @since 0.6.6
+ */
+BLARGG_EXPORT gme_err_t gme_save_state( Music_Emu*, void* out, int size );
+
+/**
+ * Restore state saved by gme_save_state(), so that playback continues exactly
+ * where it was saved. Starts the saved track if a different one is playing.
+ * If the state is rejected as corrupt, the current track is ended.
+ * @since 0.6.6
+ */
+BLARGG_EXPORT gme_err_t gme_load_state( Music_Emu*, void const* in, int size );
+
+/**
+ * Save a checkpoint every interval_msec while playing or skipping, so that seeking
+ * resumes from the nearest earlier checkpoint rather than restarting the track.
+ * At most max_count checkpoints are kept, with the interval doubling whenever they
+ * fill up. Checkpoints are discarded when another track is started or the tempo
+ * is changed. Pass 0 for interval_msec to disable (the default).
+ * @since 0.6.6
+ */
+BLARGG_EXPORT gme_err_t gme_set_seek_checkpoints( Music_Emu*, int interval_msec, int max_count );
+
+/**
+ * Limit memory used by seek checkpoints to max_bytes. Fewer checkpoints are kept
+ * for emulators with large state, such as SPC with its 64 KB of RAM. Pass 0 to
+ * remove the limit (the default).
+ * @since 0.6.6
+ */
+BLARGG_EXPORT void gme_set_seek_checkpoint_memory( Music_Emu*, long max_bytes );
+
 
 /******** Informational ********/
 
@@ -159,6 +209,30 @@ struct gme_info_t
 	const char *s7,*s8,*s9,*s10,*s11,*s12,*s13,*s14,*s15; /* reserved */
 };
 
+/**
+ * Gets counters of work done by emulator since it was created, for finding out
+ * why some files take longer to play than others. Counters are only updated if
+ * library was built with GME_STATS defined; otherwise they are all zero.
+ * @since 0.6.6
+ */
+typedef struct gme_stats_t gme_stats_t;
+BLARGG_EXPORT void gme_get_stats( Music_Emu const*, gme_stats_t* out );
+
+struct gme_stats_t
+{
+	long long cpu_instructions;	/* instructions executed by emulated CPU */
+	long long apu_writes;		/* writes to sound chip registers */
+	long long synth_offsets;	/* amplitude changes added to Blip_Buffers */
+	long long blip_samples;		/* samples read out of Blip_Buffers */
+	long long resampler_in;		/* samples written to resampler */
+	long long resampler_out;	/* samples read from resampler */
+	long long emu_samples;		/* samples generated or skipped by emulator */
+	long long silence_samples;	/* silence skipped at start of track, or played while emulator runs ahead */
+	long long out_samples;		/* samples played */
+
+	long long r9,r10,r11,r12,r13,r14,r15; /* reserved */
+};
+
 
 /******** Advanced playback ********/
 
@@ -170,6 +244,16 @@ BLARGG_EXPORT void gme_set_stereo_depth( Music_Emu*, double depth );
 if ignore is true */
 BLARGG_EXPORT void gme_ignore_silence( Music_Emu*, int ignore );
 
+/**
+ * Keep the work done by each gme_play() proportional to the number of samples
+ * requested, for small output buffers where latency matters. Emulators run in
+ * steps of about a millisecond rather than filling their whole buffer, and
+ * silence detection no longer runs the emulator ahead of playback. Best set
+ * before starting a track. Off by default.
+ * @since 0.6.6
+ */
+BLARGG_EXPORT void gme_set_low_latency( Music_Emu*, int enabled );
+
 /* Adjust song tempo, where 1.0 = normal, 0.5 = half speed, 2.0 = double speed.
 Track length as returned by track_info() assumes a tempo of 1.0. */
 BLARGG_EXPORT void gme_set_tempo( Music_Emu*, double tempo );
@@ -210,6 +294,21 @@ BLARGG_EXPORT void gme_set_equalizer( Music_Emu*, gme_equalizer_t const* eq );
 /* Enables/disables most accurate sound emulation options */
 BLARGG_EXPORT void gme_enable_accuracy( Music_Emu*, int enabled );
 
+/* Synthesis quality levels for gme_set_quality() */
+enum { gme_quality_fast = 0, gme_quality_normal = 1, gme_quality_high = 2 };
+
+/**
+ * Set quality of band-limited synthesis, trading accuracy for speed. Fast uses
+ * a cheap step with some aliasing, normal is the default, and high uses a wider
+ * filter with less aliasing. For SPC files and FM sound chips, which are
+ * resampled separately, it selects a narrower or wider resampling filter.
+ * Resampling is skipped for SPC files played at their native 32000 Hz rate.
+ * Can be changed while playing, though this causes a short gap in resampled
+ * sound.
+ * @since 0.6.6
+ */
+BLARGG_EXPORT void gme_set_quality( Music_Emu*, int quality );
+
 
 /******** Game music types ********/
 
@@ -257,6 +356,20 @@ extern BLARGG_EXPORT const char* const gme_wrong_file_type;
  * The resulting Music_Emu object will be set to single channel mode. */
 BLARGG_EXPORT gme_err_t gme_open_data( void const* data, long size, Music_Emu** out, int sample_rate );
 
+/** Same as gme_open_data(), but uses data in place rather than copying it. See
+ * gme_load_data_borrowed().
+ * @since 0.6.6
+ */
+BLARGG_EXPORT gme_err_t gme_open_data_borrowed( void const* data, long size, Music_Emu** out,
+                                                int sample_rate );
+
+/** Same as gme_open_file(), but memory-maps the file and uses it in place. See
+ * gme_load_file_mapped().
+ * @since 0.6.6
+ */
+BLARGG_EXPORT gme_err_t gme_open_file_mapped( const char path [], Music_Emu** out,
+                                              int sample_rate );
+
 /* Determine likely game music type based on first four bytes of file. Returns
 string containing proper file suffix (i.e. "NSF", "SPC", etc.) or "" if
 file header is not recognized. */
@@ -288,12 +401,37 @@ BLARGG_EXPORT Music_Emu* gme_new_emu( gme_type_t, int sample_rate );
  */
 BLARGG_EXPORT Music_Emu* gme_new_emu_multi_channel( gme_type_t, int sample_rate );
 
+/** Same as gme_new_emu(), but takes the emulator and the buffers allocated when setting
+ * its sample rate from a single block of arena_size bytes, allocated at once. Anything
+ * that doesn't fit, and memory allocated later, such as when loading a file, comes from
+ * the allocator. The block is freed by gme_delete().
+ * @since 0.6.6
+ */
+BLARGG_EXPORT Music_Emu* gme_new_emu_arena( gme_type_t, int sample_rate, long arena_size );
+
 /* Load music file into emulator */
 BLARGG_EXPORT gme_err_t gme_load_file( Music_Emu*, const char path [] );
 
+/** Same as gme_load_file(), but memory-maps uncompressed files where supported and
+ * uses them in place, so only the parts played are read from disk. The file must not
+ * be truncated or modified until the emulator is deleted or loads another file, or
+ * playback changes or the process crashes (SIGBUS). Files that can't be mapped, and
+ * file types such as NSFE whose data must be converted, are read as usual.
+ * @since 0.6.6
+ */
+BLARGG_EXPORT gme_err_t gme_load_file_mapped( Music_Emu*, const char path [] );
+
 /* Load music file from memory into emulator. Makes a copy of data passed. */
 BLARGG_EXPORT gme_err_t gme_load_data( Music_Emu*, void const* data, long size );
 
+/** Same as gme_load_data(), but keeps a pointer to data rather than copying it, so
+ * it must remain valid and unmodified until the emulator is deleted or loads
+ * another file. Compressed files, and file types such as NSFE whose data must be
+ * converted, are still copied.
+ * @since 0.6.6
+ */
+BLARGG_EXPORT gme_err_t gme_load_data_borrowed( Music_Emu*, void const* data, long size );
+
 /* Load multiple single-track music files from memory into emulator.
  * @since 0.6.4
  */
@@ -314,6 +452,46 @@ BLARGG_EXPORT gme_err_t gme_load_custom( Music_Emu*, gme_reader_t, long file_siz
 BLARGG_EXPORT gme_err_t gme_load_m3u_data( Music_Emu*, void const* data, long size );
 
 
+/******** Batch rendering ********/
+
+/* Receives samples of a batch job as they are rendered. Called from a worker thread.
+ * @since 0.6.6 */
+typedef void (*gme_batch_callback_t)( void* user_data, short const samples [], int count );
+
+/**
+ * Track to render with gme_render_batch().
+ * @since 0.6.6
+ */
+typedef struct gme_batch_job_t
+{
+	/* set by caller */
+	void const* data;       /* music file data, which must remain valid during rendering */
+	long size;
+	int track;
+	int length_msec;        /* time fade begins at, or 0 to use track's play_length */
+	int fade_msec;          /* length of fade */
+	short* out;             /* buffer for out_size samples, or NULL to use callback */
+	long out_size;
+	gme_batch_callback_t callback;
+	void* user_data;        /* passed to callback */
+
+	/* set by gme_render_batch() */
+	long out_count;         /* number of samples rendered */
+	gme_err_t err;          /* error rendering this job, or NULL if none */
+} gme_batch_job_t;
+
+/**
+ * Render each of count jobs in stereo at sample_rate, using thread_count threads
+ * (0 for one per CPU). Rendering of a job stops when its fade ends, its track
+ * ends, or its out buffer fills. Emulators are reused between jobs of the same
+ * file type. Errors for individual jobs are returned in their err field. Returns
+ * an error without rendering anything if a thread couldn't be created.
+ * @since 0.6.6
+ */
+BLARGG_EXPORT gme_err_t gme_render_batch( gme_batch_job_t jobs [], int count,
+                                          int sample_rate, int thread_count );
+
+
 /******** User data ********/
 
 /* Set/get pointer to data you want to associate with this emulator.
@@ -327,6 +505,22 @@ typedef void (*gme_user_cleanup_t)( void* user_data );
 BLARGG_EXPORT void gme_set_user_cleanup( Music_Emu*, gme_user_cleanup_t func );
 
 
+/******** Memory ********/
+
+/** Function that allocates, resizes, or frees memory. Behaves like realloc( p, size ),
+ * except that it frees p and returns NULL if size is 0.
+ * @since 0.6.6
+ */
+typedef void* (*gme_alloc_func_t)( void* user_data, void* p, size_t size );
+
+/** Set function used for all memory the library allocates, or NULL to use malloc()
+ * and free(). Must be called before creating any emulators, or after all have
+ * been deleted. Passes user_data to func.
+ * @since 0.6.6
+ */
+BLARGG_EXPORT void gme_set_allocator( gme_alloc_func_t func, void* user_data );
+
+
 #ifdef __cplusplus
 	}
 #endif